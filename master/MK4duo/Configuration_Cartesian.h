@@ -41,6 +41,7 @@
  * - Axis relative mode
  * - Bed Leveling
  * - Leveling Fade Height
+ * - Mesh Bicubic Interpolation
  * - Safe Z homing
  * - Manual home positions
  * - Axis steps per unit
@@ -498,6 +499,22 @@
 /*****************************************************************************************/
 
 
+/*****************************************************************************************
+ ****************************** Mesh Bicubic Interpolation *******************************
+ *****************************************************************************************
+ *                                                                                       *
+ * Interpolate the mesh of MBL, ABL Bilinear or UBL with Catmull-Rom bicubic             *
+ * patches instead of bilinear, so the correction has no slope steps at the              *
+ * cell edges and a coarse mesh can replace a dense one.                                 *
+ * The patches are computed when leveling is enabled and by M421,                        *
+ * 16 floats per cell of RAM.                                                            *
+ * Not compatible with ABL_BILINEAR_SUBDIVISION.                                         *
+ *                                                                                       *
+ *****************************************************************************************/
+//#define MESH_BICUBIC_INTERPOLATION
+/*****************************************************************************************/
+
+
 /*****************************************************************************************
  ******************************** Manual home positions **********************************
  *****************************************************************************************/
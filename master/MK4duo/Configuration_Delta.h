@@ -40,6 +40,7 @@
  * - Disables axis
  * - Axis relative mode
  * - Auto Bed Leveling (ABL)
+ * - Mesh Bicubic Interpolation
  * - Auto Calibration
  * - Delta Home Safe Zone
  * - Axis steps per unit
@@ -82,6 +83,13 @@
 // Subsegment per line 10 - xxx
 #define DELTA_SEGMENTS_PER_LINE 20
 
+// Maximum tower position error (mm) of the straight lines a move is split into.
+// The line length follows the curvature of the tower path, so long moves near the
+// center use few lines and moves near the edge of the build radius use more.
+// 0 split the moves by DELTA_SEGMENTS_PER_SECOND_* and DELTA_SEGMENTS_PER_LINE as before,
+// try 0.01 to enable it. Can be changed with M666 T.
+#define DELTA_SEGMENT_TOLERANCE 0
+
 // NOTE: All following values for DELTA_* MUST be floating point,
 // so always have a decimal point in them.
 //
@@ -162,6 +170,27 @@
 /*****************************************************************************************/
 
 
+/*****************************************************************************************
+ ************************** Delta Incremental Transform **********************************
+ *****************************************************************************************
+ *                                                                                       *
+ * Transform the lines of a segmented move one after the other instead of from scratch.  *
+ * The value under the square root of each tower is updated by forward differencing      *
+ * and the square root is refined from the one of the previous line with one or two      *
+ * Newton steps on the reciprocal square root. Lines where the error could exceed a      *
+ * quarter of a step fall back to the full square root.                                  *
+ * It saves the square roots at the cost of multiplies, a gain only on boards without    *
+ * FPU (AVR, Due). See tools/bench_delta_transform.cpp.                                  *
+ *                                                                                       *
+ * DELTA_INCREMENTAL_RESYNC is the number of lines after which the forward differences   *
+ * are computed again from the position, to stop rounding errors from piling up.         *
+ *                                                                                       *
+ *****************************************************************************************/
+//#define DELTA_INCREMENTAL_TRANSFORM
+#define DELTA_INCREMENTAL_RESYNC 16
+/*****************************************************************************************/
+
+
 /*****************************************************************************************
  ************************* Endstop pullup resistors **************************************
  *****************************************************************************************
@@ -471,6 +500,22 @@
 /*****************************************************************************************/
 
 
+/*****************************************************************************************
+ ****************************** Mesh Bicubic Interpolation *******************************
+ *****************************************************************************************
+ *                                                                                       *
+ * Interpolate the mesh of MBL, ABL Bilinear or UBL with Catmull-Rom bicubic             *
+ * patches instead of bilinear, so the correction has no slope steps at the              *
+ * cell edges and a coarse mesh can replace a dense one.                                 *
+ * The patches are computed when leveling is enabled and by M421,                        *
+ * 16 floats per cell of RAM.                                                            *
+ * Not compatible with ABL_BILINEAR_SUBDIVISION.                                         *
+ *                                                                                       *
+ *****************************************************************************************/
+//#define MESH_BICUBIC_INTERPOLATION
+/*****************************************************************************************/
+
+
 /*****************************************************************************************
  ********************************* Auto Calibration **************************************
  *****************************************************************************************
@@ -199,6 +199,23 @@
 /***********************************************************************/
 
 
+/***********************************************************************
+ *************************** SOFT PWM Timer ****************************
+ ***********************************************************************
+ *                                                                     *
+ * Drive all software PWM heaters and fans from a dedicated timer      *
+ * with a first-order sigma-delta modulator instead of the 1ms tick.   *
+ * Full 8 bit resolution, SOFT_PWM_SPEED is ignored.                   *
+ *                                                                     *
+ * Only for Arduino DUE, it use timer TC8 so pins 11 and 12 can not    *
+ * be used as hardware PWM.                                            *
+ *                                                                     *
+ ***********************************************************************/
+//#define SOFT_PWM_TIMER
+#define SOFT_PWM_TIMER_FREQUENCY 2000
+/***********************************************************************/
+
+
 //===========================================================================
 //=============================== FAN FEATURES ==============================
 //===========================================================================
@@ -1390,6 +1407,78 @@
 // Use CRC checks and retries on the SD communication.
 //#define SD_CHECK_AND_RETRY
 
+//
+// SD CARD: READ BUFFER
+//
+// Read the print file a block at a time into two alternating buffers.
+// The next block is read ahead while the printer is idle, so the G-code
+// parser takes its bytes from RAM instead of asking the card for each one.
+// Costs 2 x SD_READ_BUFFER_SIZE bytes of SRAM.
+//#define SD_DOUBLE_BUFFER
+#define SD_READ_BUFFER_SIZE 512   // Multiple of the 512 bytes card block
+
+//
+// SD CARD: PREFETCH QUEUE
+//
+// Read and tokenize lines of the print file ahead of the BUFSIZE command
+// buffer into a queue of SD_PREFETCH_SIZE bytes. The queue is topped up
+// while the printer is idle and feeds the command buffer as soon as a slot
+// frees up, so card latency (FAT chain walks, busy card) does not starve
+// the planner. M27 Q reports the queue fill and how often the queue or the
+// planner ran dry. A few KB are good on 32 bit boards.
+//#define SD_PREFETCH_QUEUE
+#define SD_PREFETCH_SIZE 4096
+
+//
+// SD CARD: BINARY UPLOAD
+//
+// M28 B<size> <file> receives the file as binary frames instead of G-code
+// lines. Each frame is 512 bytes of data (the last one may be shorter)
+// followed by its CRC-16/XMODEM, high byte first. A good frame is written
+// straight to the card and answered with "ok", a bad or partial one with
+// "Resend:<frame>". The data goes to a temporary file, preallocated in
+// contiguous clusters when the card has room. After <size> bytes the port
+// is back to G-code and M29 puts the file in place of <file>. A line quiet
+// for 10 seconds drops the upload.
+//#define SD_BINARY_UPLOAD
+
+//
+// SD CARD: PREALLOCATED WRITES
+//
+// A new file written with M28 reserves SD_WRITE_PREALLOCATE bytes in one
+// run of contiguous clusters, so the upload never waits on cluster
+// allocation and FAT updates. M29 trims the file to the size written.
+// The restart journal, EEPROM on SD and M28 B uploads are always
+// preallocated and written straight to the card blocks.
+//#define SD_WRITE_PREALLOCATE 8388608
+
+//
+// SD CARD: COMPRESSED G-CODE
+//
+// Print G-code files compressed with tools/gcz.py. They are recognized by
+// their "GCZ" header and decompressed while they are read, so the card
+// reads several times fewer bytes. Upload them with M28 B to cut the
+// serial transfer time as well. The window takes 2^GCZ_WINDOW_BITS bytes
+// of SRAM, files compressed with a bigger window are refused. Default is
+// 8 on AVR and 11 on 32 bit boards. M26 S, M32 S and the restart position
+// of a compressed file count decompressed bytes.
+//#define GCZ_SUPPORT
+//#define GCZ_WINDOW_BITS 11
+
+//
+// SD CARD: LAYER INDEX
+//
+// The first print of a file from its start writes a seek table beside it,
+// the hidden file ".<name>.lyr", with the file position and the parser
+// state (absolute or relative modes, feedrate, E position, tool,
+// temperatures and fan speeds) of each layer. M24 L<layer> or Z<height>
+// then starts the selected file from that layer at once, e.g. to finish a
+// print after a power-loss at a known height. The axes must be homed and
+// no print running: Z is raised 2 mm over the layer, the tool selected and
+// the heaters brought to temperature before the file goes on.
+// Compressed files are not indexed.
+//#define SD_LAYER_INDEX
+
 //
 // Show extended directory including file length.
 // Don't use this with Pronterface
@@ -1416,7 +1505,8 @@
  * Sort SD file listings in alphabetical order.
  *
  * With this option enabled, items on SD cards will be sorted
- * by name for easier navigation.
+ * by name for easier navigation. The sort runs in the background
+ * and the listing shows unsorted until it is done.
  *
  * By default...
  *
@@ -1431,7 +1521,7 @@
  * limit is exceeded.
  *
  *  - SDSORT_USES_RAM provides faster sorting via a static directory buffer.
- *  - SDSORT_USES_STACK does the same, but uses a local stack-based buffer.
+ *  - SDSORT_USES_STACK drops the directory buffer, names are re-read from SD.
  *  - SDSORT_CACHE_NAMES will retain the sorted file listing in RAM. (Expensive!)
  *  - SDSORT_DYNAMIC_RAM only uses RAM when the SD menu is visible. (Use with caution!)
  */
@@ -1442,7 +1532,7 @@
 #define FOLDER_SORTING     -1     // -1=above  0=none  1=below
 #define SDSORT_GCODE       false  // Allow turning sorting on/off with LCD and M36 g-code.
 #define SDSORT_USES_RAM    false  // Pre-allocate a static array for faster pre-sorting.
-#define SDSORT_USES_STACK  false  // Prefer the stack for pre-sorting to give back some SRAM. (Negated by next 2 options.)
+#define SDSORT_USES_STACK  false  // Re-read names from SD while sorting to give back some SRAM. (Negated by next 2 options.)
 #define SDSORT_CACHE_NAMES false  // Keep sorted items in RAM longer for speedy performance. Most expensive option.
 #define SDSORT_DYNAMIC_RAM false  // Use dynamic allocation (within SD menus). Least expensive option. Set SDSORT_LIMIT before use!
 #define SDSORT_CACHE_VFATS 2      // Maximum number of 13-byte VFAT entries to use for sorting.
@@ -1453,6 +1543,12 @@
 #define SD_RESTART_FILE_SAVE_TIME    1  // Seconds between update
 #define SD_RESTART_FILE_PURGE_LEN   20  // Purge when restart
 #define SD_RESTART_FILE_RETRACT_LEN  1  // Retract when restart
+// The restart file is a journal preallocated on the card. Every save appends
+// a small record (sdpos, position, temperatures), with a full checkpoint of
+// the job every SD_RESTART_FILE_CHECKPOINT records. Restart uses the newest
+// valid record.
+#define SD_RESTART_FILE_SIZE     32768  // Bytes preallocated for the journal
+#define SD_RESTART_FILE_CHECKPOINT  32  // Records between full checkpoints
 /*****************************************************************************************/
 
 
@@ -1897,7 +1993,16 @@
 // Disable this feature to save ~3226 bytes
 //#define ARC_SUPPORT
 #define MM_PER_ARC_SEGMENT  1   // Length of each arc segment
+// Length of each arc segment from the radius and a max chord deviation (mm)
+// instead of MM_PER_ARC_SEGMENT. Segments are not shorter than the planner
+// moves in DEFAULT_MIN_SEGMENT_TIME at the arc feedrate.
+//#define ARC_SEGMENT_TOLERANCE   0.002
+#define MAX_MM_PER_ARC_SEGMENT 10   // Longest segment with ARC_SEGMENT_TOLERANCE
 #define MIN_ARC_SEGMENTS   24   // Minimum number of segments in a complete circle
+// Queue XY arcs as arc blocks stepped on the circle by the stepper ISR
+// instead of segments. Cartesian and CoreXY only, with equal X and Y
+// steps per unit. Arcs fall back to segments while leveling is active.
+//#define ARC_STEPPER_BLOCKS
 #define N_ARC_CORRECTION   25   // Number of intertpolated segments between corrections
 //#define ARC_P_CIRCLES         // Enable the 'P' parameter to specify complete circles
 //#define CNC_WORKSPACE_PLANES  // Allow G2/G3 to operate in XY, ZX, or YZ planes
@@ -1905,6 +2010,17 @@
 // Moves with fewer segments than this will be ignored and joined with the next movement
 #define MIN_STEPS_PER_SEGMENT 6
 
+//
+// Kinematic segment feeder (DELTA and SCARA)
+//
+// Segmented moves are queued whole and split in lines only when the planner
+// has free blocks, so the main loop keeps reading commands ahead and the
+// planner is kept full of lines.
+// The look-ahead does not change: every line is a planner block, so with short
+// lines the speed is still limited by BLOCK_BUFFER_SIZE lines of braking.
+//#define KINEMATIC_SEGMENT_FEEDER
+#define KINEMATIC_FEEDER_MOVES 8  // Moves waiting to be split in lines
+
 // Uncomment to add the M100 Free Memory Watcher for debug purpose
 //#define M100_FREE_MEMORY_WATCHER
 
@@ -2093,6 +2209,14 @@
  *                                                                                       *
  *****************************************************************************************/
 //#define JSON_OUTPUT
+
+// Keep the result of the G-code file analysis (generated by, layer heights,
+// object height and filament needed) in the index file .meta.idx on the SD.
+// A file is scanned once, and again only when its size or date changes.
+// The index holds up to SD_METADATA_RECORDS files, then new records
+// replace old ones. Like other dot files it is not listed by M20 or the LCD.
+//#define SD_METADATA_INDEX
+#define SD_METADATA_RECORDS 64
 /*****************************************************************************************/
 
 
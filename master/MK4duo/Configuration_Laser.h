@@ -74,5 +74,6 @@
 
 // Uncomment the following line to enable cubic bezier curve movement with the G5 code
 // #define G5_BEZIER
+#define BEZIER_TOLERANCE 0.05  // Max distance of the G5 lines from the curve (mm)
 
 #define LASER_FOCAL_HEIGHT 10.00  // z axis position at which the laser is focused
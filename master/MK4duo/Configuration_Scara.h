@@ -42,6 +42,7 @@
  * - Mesh Bed Leveling (MBL)
  * - Auto Bed Leveling (ABL)
  * - Leveling Fade Height (MBL or ABL)
+ * - Mesh Bicubic Interpolation
  * - Safe Z homing
  * - Manual home positions
  * - Axis steps per unit
@@ -108,6 +109,29 @@
 /*****************************************************************************************/
 
 
+/*****************************************************************************************
+ ************************************* Scara IK table ************************************
+ *****************************************************************************************
+ *                                                                                       *
+ * Both arm angles are the angle of the point around the tower plus angles that depend   *
+ * only on its distance from the tower. These are taken from a table built at startup    *
+ * and interpolated with cubic splines, so a segment costs one ATAN2 instead of three    *
+ * and a square root, and the segments can be shorter than the usual 0.5mm.              *
+ *                                                                                       *
+ * SCARA_IK_TABLE_SIZE  Number of points in the table (4 bytes each for 2 angles)        *
+ * SCARA_IK_TABLE_LIMIT Elbow cosine covered by the table, 0.9 is 26° to 154° of elbow.  *
+ *                      Outside of it, near the singular positions, the angles are       *
+ *                      computed exactly.                                                *
+ * SCARA_IK_SEGMENT_MM  Minimum segment length with the table                            *
+ *                                                                                       *
+ *****************************************************************************************/
+//#define SCARA_IK_TABLE
+#define SCARA_IK_TABLE_SIZE   128
+#define SCARA_IK_TABLE_LIMIT  0.9
+#define SCARA_IK_SEGMENT_MM   0.1
+/*****************************************************************************************/
+
+
 /*****************************************************************************************
  ************************* Endstop pullup resistors **************************************
  *****************************************************************************************
@@ -487,6 +511,22 @@
 /*****************************************************************************************/
 
 
+/*****************************************************************************************
+ ****************************** Mesh Bicubic Interpolation *******************************
+ *****************************************************************************************
+ *                                                                                       *
+ * Interpolate the mesh of MBL, ABL Bilinear or UBL with Catmull-Rom bicubic             *
+ * patches instead of bilinear, so the correction has no slope steps at the              *
+ * cell edges and a coarse mesh can replace a dense one.                                 *
+ * The patches are computed when leveling is enabled and by M421,                        *
+ * 16 floats per cell of RAM.                                                            *
+ * Not compatible with ABL_BILINEAR_SUBDIVISION.                                         *
+ *                                                                                       *
+ *****************************************************************************************/
+//#define MESH_BICUBIC_INTERPOLATION
+/*****************************************************************************************/
+
+
 /*****************************************************************************************
  ******************************** Manual home positions **********************************
  *****************************************************************************************/
@@ -384,6 +384,27 @@
 // If thermal protection hotends is true, this parameter adapt fan speed if temperature drops
 //#define ADAPTIVE_FAN_SPEED
 
+/**
+ * Thermal model protection
+ *
+ * For heaters with thermal protection and an identified thermal model, replace
+ * the hysteresis and watch checks with a first order model of the heater. The
+ * temperature predicted from the applied power is compared with the measured one,
+ * if the difference stays over THERMAL_MODEL_RESIDUAL for THERMAL_MODEL_PERIOD
+ * the machine is halted. Slow differences (enclosure, draft) are absorbed by an
+ * ambient correction with THERMAL_MODEL_ADAPT time constant.
+ *
+ * The model is identified by M303 or set with M306 D<gain> K<time constant> V<fan loss>.
+ * THERMAL MODEL FAN LOSS is the heat loss increase of hotends with fan 0 at full speed.
+ * Heaters without model (D0) use the classic thermal protection.
+ */
+//#define THERMAL_MODEL_PROTECTION
+#define THERMAL_MODEL_RESIDUAL  15    // Degrees Celsius
+#define THERMAL_MODEL_PERIOD    10    // Seconds
+#define THERMAL_MODEL_ADAPT     120   // Seconds
+#define THERMAL_MODEL_AMBIENT   25    // Degrees Celsius
+#define THERMAL_MODEL_FAN_LOSS  0.3
+
 /**
  * When ever increases the target temperature the firmware will wait for the
  * WATCH TEMP PERIOD to expire, and if the temperature hasn't increased by WATCH TEMP INCREASE
@@ -444,3 +465,50 @@
  ***********************************************************************/
 #define SAFETYTIMER_TIME_MINS 30
 /***********************************************************************/
+
+
+/***********************************************************************
+ ************************ Heater power budget **************************
+ ***********************************************************************
+ *                                                                     *
+ * Limit the total power of the heaters to HEATER POWER BUDGET WATTS,  *
+ * so bed, chamber and hotends can heat at once without overload the   *
+ * power supply. Every control period the power is assigned first to   *
+ * the heaters holding their target, then to the heaters farthest      *
+ * from their target.                                                  *
+ * Watts of every heater can be changed with M306 W<watts>,            *
+ * heaters with 0 watts are not limited.                               *
+ * While a heater is held back the heating watch and thermal runaway   *
+ * timers are paused for it.                                           *
+ *                                                                     *
+ ***********************************************************************/
+//#define HEATER_POWER_BUDGET
+#define HEATER_POWER_BUDGET_WATTS 300 // Watts available for heaters
+#define HOTEND_WATTS               40
+#define BED_WATTS                 200
+#define CHAMBER_WATTS             100
+#define COOLER_WATTS                0
+/***********************************************************************/
+
+
+/***********************************************************************
+ ************************ Temperature telemetry ************************
+ ***********************************************************************
+ *                                                                     *
+ * Sample temperature, target and PWM of every heater at 10Hz in a     *
+ * RAM ring buffer, for check thermal runaway or PID problems after    *
+ * the fact.                                                           *
+ * TEMP_TELEMETRY_SIZE is the buffer size in bytes for all heaters.    *
+ * Samples are stored as temperature deltas: a sample takes about 2.2  *
+ * bytes for each heater, so the buffer holds about                    *
+ * SIZE / (22 * heaters) seconds. With two heaters 8192 bytes last     *
+ * about 3 minutes, 2048 bytes (the AVR limit) about 45 seconds.       *
+ *                                                                     *
+ * M156       dump buffer as CSV                                       *
+ * M156 B     dump buffer as binary                                    *
+ * M156 R     reset buffer                                             *
+ *                                                                     *
+ ***********************************************************************/
+//#define TEMP_TELEMETRY
+#define TEMP_TELEMETRY_SIZE 8192
+/***********************************************************************/
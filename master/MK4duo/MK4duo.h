@@ -126,6 +126,7 @@
 #include "src/core/eeprom/eeprom.h"
 #include "src/core/printer/printer.h"
 #include "src/core/planner/planner.h"
+#include "src/core/feeder/feeder.h"
 #include "src/core/endstop/endstops.h"
 #include "src/core/stepper/stepper.h"
 #include "src/core/tempmanager/tempmanager.h"
@@ -179,3 +180,6 @@
 #include "src/feature/rgbled/led_events.h"
 #include "src/feature/caselight/caselight.h"
 #include "src/feature/restart/restart.h"
+#include "src/feature/telemetry/telemetry.h"
+#include "src/feature/gcz/gcz.h"
+#include "src/feature/layer_index/layer_index.h"
@@ -52,6 +52,15 @@ long Commands::gcode_N = 0;
 
 int Commands::serial_count[NUM_SERIAL] = { 0 };
 
+#if ENABLED(SD_PREFETCH_QUEUE)
+  sd_prefetch_stats_t Commands::sd_stats;
+  char      Commands::sd_queue[SD_PREFETCH_SIZE];
+  uint16_t  Commands::sd_queue_head = 0,
+            Commands::sd_queue_tail = 0,
+            Commands::sd_queue_used = 0;
+  bool      Commands::sd_queue_eof  = false;
+#endif
+
 /** Public Function */
 void Commands::flush_and_request_resend() {
   SERIAL_FLUSH();
@@ -99,6 +108,11 @@ void Commands::advance_queue() {
 
         ok_to_send();
       }
+      #if ENABLED(SD_BINARY_UPLOAD)
+        // A binary upload takes frames only, lines from the other ports run
+        else if (card.isBinaryWrite())
+          process_next();
+      #endif
       else {
         // Write the string from the read buffer to SD
         card.write_command(command.gcode);
@@ -292,6 +306,19 @@ Heater* Commands::get_target_heater() {
 
 }
 
+#if ENABLED(SD_PREFETCH_QUEUE)
+
+  void Commands::print_sd_prefetch_stats() {
+    SERIAL_SMV(ECHO, "SD queue: ", sd_queue_used);
+    SERIAL_MV("/", int(SD_PREFETCH_SIZE));
+    SERIAL_MV(" peak: ", sd_stats.peak);
+    SERIAL_MV(" lines: ", sd_stats.lines);
+    SERIAL_MV(" queue dry: ", sd_stats.queue_dry);
+    SERIAL_EMV(" planner dry: ", sd_stats.planner_dry);
+  }
+
+#endif
+
 /** Private Function */
 void Commands::ok_to_send() {
 
@@ -340,6 +367,10 @@ void Commands::get_serial() {
     }
   #endif
 
+  #if ENABLED(SD_BINARY_UPLOAD)
+    if (card.isUploading()) card.check_upload();
+  #endif
+
   /**
    * Loop while serial characters are incoming and the buffer_ring is not full
    */
@@ -352,6 +383,14 @@ void Commands::get_serial() {
       const int c = Com::serialRead(i);
       if (c < 0) continue;
 
+      #if ENABLED(SD_BINARY_UPLOAD)
+        // Binary frames of M28 B go straight to the file
+        if (card.isUploading(i)) {
+          card.upload_byte(c);
+          continue;
+        }
+      #endif
+
       const char serial_char = c;
 
       if (serial_char == '\n' || serial_char == '\r') {
@@ -398,7 +437,11 @@ void Commands::get_serial() {
         }
         #if HAS_SD_SUPPORT
           // Pronterface "M29" and "M29 " has no line number
-          else if (card.isSaving() && !is_M29(command)) {
+          else if (card.isSaving() && !is_M29(command)
+            #if ENABLED(SD_BINARY_UPLOAD)
+              && !card.isBinaryWrite()
+            #endif
+          ) {
             gcode_line_error(PSTR(STR_ERR_NO_CHECKSUM), i);
             return;
           }
@@ -455,6 +498,128 @@ void Commands::get_serial() {
 
 #if HAS_SD_SUPPORT
 
+  #if ENABLED(SD_PREFETCH_QUEUE)
+
+  /**
+   * Feed the command buffer from the SD prefetch queue, then top the
+   * queue up again. Called from Printer::idle through get_available,
+   * so the card is read while the planner works on what it already has.
+   */
+  void Commands::get_sdcard() {
+
+    static bool had_moves = false,
+                was_dry   = false;
+
+    if (!IS_SD_PRINTING()) return;
+
+    #if HAS_DOOR_OPEN
+      if (READ(DOOR_OPEN_PIN) != endstops.isLogic(DOOR_OPEN)) {
+        PRINTER_KEEPALIVE(DoorOpen);
+        return;  // do nothing while door is open
+      }
+    #endif
+
+    // The planner starved: it emptied with no command waiting, not because
+    // a command (M109, G4, ...) is holding the buffer
+    const bool moves = planner.has_blocks_queued();
+    if (had_moves && !moves && buffer_ring.isEmpty()) sd_stats.planner_dry++;
+    had_moves = moves;
+
+    sd_prefetch();
+
+    while (!buffer_ring.isFull() && sd_queue_used) {
+      char sd_line_buffer[MAX_CMD_SIZE];
+      uint32_t line_sdpos = 0;
+      LOOP_L_N(i, 4) line_sdpos |= uint32_t(uint8_t(sd_queue_get())) << (i * 8);
+      uint8_t ind = 0;
+      while ((sd_line_buffer[ind] = sd_queue_get())) ind++;
+
+      printer.max_inactivity_timer.start();
+      enqueue(sd_line_buffer, false, -2);   // Port -2 for SD non answer and no send ok.
+      #if HAS_SD_RESTART
+        restart.cmd_sdpos = line_sdpos;
+      #else
+        UNUSED(line_sdpos);
+      #endif
+    }
+
+    if (!sd_queue_used && sd_queue_eof)
+      card.fileHasFinished();
+
+    // Count each time the queue runs dry while the planner is moving
+    const bool dry = moves && !sd_queue_used && !sd_queue_eof && !buffer_ring.isFull();
+    if (dry && !was_dry) sd_stats.queue_dry++;
+    was_dry = dry;
+
+    printer.progress = card.percentDone();
+
+  }
+
+  /**
+   * Read and tokenize lines while a whole line fits in the queue.
+   * A partial line is kept across calls, a few lines per call keep
+   * idle() short.
+   */
+  void Commands::sd_prefetch() {
+
+    static char     sd_line_buffer[MAX_CMD_SIZE];
+    static uint8_t  sd_input_state = PS_NORMAL,
+                    sd_seek_count = 0;
+    static int      sd_count = 0;
+
+    // File changed or repositioned (M24 S, M26, M32 S, new file)
+    if (sd_seek_count != card.seek_count) {
+      sd_seek_count = card.seek_count;
+      sd_queue_flush();
+      sd_input_state = PS_NORMAL;
+      sd_count = 0;
+    }
+
+    for (uint8_t lines = 0; lines < 16 && !sd_queue_eof && SD_PREFETCH_SIZE - sd_queue_used >= MAX_CMD_SIZE + 4;) {
+
+      const int16_t n = card.get_gcode();
+      const bool card_eof = card.eof();
+
+      if (n < 0 && !card_eof) { SERIAL_LM(ER, STR_SD_ERR_READ); break; }
+
+      const char sd_char  = (char)n;
+      const bool is_eol   = sd_char == '\n' || sd_char == '\r';
+
+      if (is_eol || card_eof) {
+
+        // Reset stream state, terminate the buffer, and queue a non-empty command
+        if (!is_eol && sd_count) ++sd_count;    // End of file with no newline
+        if (!process_line_done(sd_input_state, sd_line_buffer, sd_count)) {
+          const uint32_t line_sdpos = card.getIndex();
+          #if ENABLED(SD_LAYER_INDEX)
+            layerindex.feed(sd_line_buffer, line_sdpos);
+          #endif
+          LOOP_L_N(i, 4) sd_queue_put(char(line_sdpos >> (i * 8)));
+          for (const char *c = sd_line_buffer; *c; c++) sd_queue_put(*c);
+          sd_queue_put('\0');
+          NOLESS(sd_stats.peak, sd_queue_used);
+          sd_stats.lines++;
+          lines++;
+        }
+
+        if (card_eof) sd_queue_eof = true;
+
+      }
+      else
+        process_stream_char(sd_char, sd_input_state, sd_line_buffer, sd_count);
+
+    }
+
+  }
+
+  void Commands::sd_queue_flush() {
+    sd_queue_head = sd_queue_tail = sd_queue_used = 0;
+    sd_queue_eof = false;
+    if (!card.getIndex()) memset(&sd_stats, 0, sizeof(sd_stats));  // New print, new statistics
+  }
+
+  #else
+
   /**
    * Get lines from the SD Card until the command buffer is full
    * or until the end of the file is reached. Because this method
@@ -480,7 +645,7 @@ void Commands::get_serial() {
 
     while (!buffer_ring.isFull() && !card_eof) {
 
-      const int16_t n = card.get();
+      const int16_t n = card.get_gcode();
       card_eof = card.eof();
 
       if (n < 0 && !card_eof) { SERIAL_LM(ER, STR_SD_ERR_READ); continue; }
@@ -495,6 +660,9 @@ void Commands::get_serial() {
         // Reset stream state, terminate the buffer, and commit a non-empty command
         if (!is_eol && sd_count) ++sd_count;    // End of file with no newline
         if (!process_line_done(sd_input_state, sd_line_buffer, sd_count)) {
+          #if ENABLED(SD_LAYER_INDEX)
+            layerindex.feed(sd_line_buffer, card.getIndex());
+          #endif
           enqueue(sd_line_buffer, false, -2);   // Port -2 for SD non answer and no send ok.
           #if HAS_SD_RESTART
             restart.cmd_sdpos = card.getIndex();
@@ -513,6 +681,8 @@ void Commands::get_serial() {
 
   }
 
+  #endif // SD_PREFETCH_QUEUE
+
 #endif // HAS_SD_SUPPORT
 
 void Commands::process_next() {
@@ -43,6 +43,15 @@ struct gcode_t {
                                 //    -2 for SD or null port
 };
 
+#if ENABLED(SD_PREFETCH_QUEUE)
+  struct sd_prefetch_stats_t {
+    uint32_t  lines,        // Lines read ahead from the card
+              queue_dry,    // Queue ran empty while moving, with command slots free
+              planner_dry;  // Planner ran out of moves with no command waiting
+    uint16_t  peak;         // Highest queue fill in bytes
+  };
+#endif
+
 class Commands {
 
   public: /** Constructor */
@@ -80,12 +89,30 @@ class Commands {
      */
     static long gcode_last_N;
 
+    #if ENABLED(SD_PREFETCH_QUEUE)
+      static sd_prefetch_stats_t sd_stats;
+    #endif
+
   private: /** Private Parameters */
 
     static long gcode_N;
 
     static int serial_count[NUM_SERIAL];
 
+    /**
+     * SD prefetch queue
+     * Lines read and tokenized ahead of buffer_ring, each stored
+     * as the card position of its end followed by the 0-terminated
+     * command. Drained into buffer_ring as slots free up.
+     */
+    #if ENABLED(SD_PREFETCH_QUEUE)
+      static char     sd_queue[SD_PREFETCH_SIZE];
+      static uint16_t sd_queue_head,
+                      sd_queue_tail,
+                      sd_queue_used;
+      static bool     sd_queue_eof;
+    #endif
+
   public: /** Public Function */
 
     /**
@@ -150,6 +177,14 @@ class Commands {
     static void process_now(char * gcode);
     static void process_now_P(PGM_P pgcode);
 
+    #if ENABLED(SD_PREFETCH_QUEUE)
+      /**
+       * Report the SD prefetch queue fill and how often
+       * the queue or the planner ran dry (M27 Q)
+       */
+      static void print_sd_prefetch_stats();
+    #endif
+
     /**
      * Set XYZE mechanics.destination and mechanics.feedrate_mm_s from the current GCode command
      *
@@ -209,6 +244,26 @@ class Commands {
       static void get_sdcard();
     #endif
 
+    /**
+     * Fill the SD prefetch queue with the next lines of the file,
+     * dropping what it holds if the card was moved meanwhile.
+     */
+    #if ENABLED(SD_PREFETCH_QUEUE)
+      static void sd_prefetch();
+      static void sd_queue_flush();
+      FORCE_INLINE static void sd_queue_put(const char c) {
+        sd_queue[sd_queue_tail] = c;
+        if (++sd_queue_tail >= SD_PREFETCH_SIZE) sd_queue_tail = 0;
+        sd_queue_used++;
+      }
+      FORCE_INLINE static char sd_queue_get() {
+        const char c = sd_queue[sd_queue_head];
+        if (++sd_queue_head >= SD_PREFETCH_SIZE) sd_queue_head = 0;
+        sd_queue_used--;
+        return c;
+      }
+    #endif
+
     /**
      * Process a single command and dispatch it to its handler
      * This is called from the main loop()
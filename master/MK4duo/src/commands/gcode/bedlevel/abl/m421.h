@@ -62,6 +62,7 @@ inline void gcode_M421() {
       #if ENABLED(ABL_BILINEAR_SUBDIVISION)
         abl.virt_interpolate();
       #endif
+      bedlevel.refresh_mesh();
     }
     else {
       SERIAL_LM(ER, STR_ERR_MESH_XY);
@@ -203,6 +203,8 @@
 
     } // switch (state)
 
+    bedlevel.refresh_mesh();
+
     if (state == MeshNext) {
       SERIAL_MV("MBL G29 point ", MIN(mbl_probe_index, GRID_MAX_POINTS));
       SERIAL_EMV(" of ", int(GRID_MAX_POINTS));
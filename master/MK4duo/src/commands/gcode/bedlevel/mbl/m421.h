@@ -52,8 +52,10 @@ inline void gcode_M421() {
   else if (ix < 0 || iy < 0) {
     SERIAL_LM(ER, STR_ERR_MESH_XY);
   }
-  else
+  else {
     mbl.set_z(ix, iy, parser.value_linear_units() + (hasQ ? mbl.data.z_values[ix][iy] : 0));
+    bedlevel.refresh_mesh();
+  }
 }
 
 #endif // ENABLED(MESH_BED_LEVELING)
@@ -30,6 +30,9 @@
 
 #define CODE_G29
 
-inline void gcode_G29() { ubl.G29(); }
+inline void gcode_G29() {
+  ubl.G29();
+  bedlevel.refresh_mesh();  // Most G29 options edit the mesh, also while leveling is active
+}
 
 #endif // AUTO_BED_LEVELING_UBL
@@ -55,8 +55,10 @@ inline void gcode_M421() {
     SERIAL_LM(ER, STR_ERR_M421_PARAMETERS);
   else if (!WITHIN(ij.x, 0, GRID_MAX_POINTS_X - 1) || !WITHIN(ij.y, 0, GRID_MAX_POINTS_Y - 1))
     SERIAL_LM(ER, STR_ERR_MESH_XY);
-  else
+  else {
     ubl.z_values[ij.x][ij.y] = hasN ? NAN : parser.value_linear_units() + (hasQ ? ubl.z_values[ij.x][ij.y] : 0);
+    bedlevel.refresh_mesh();
+  }
 }
 
 #endif // ENABLED(MESH_BED_LEVELING)
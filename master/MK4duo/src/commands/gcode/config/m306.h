@@ -51,6 +51,16 @@
  *    P[int]    Heater Pin
  *    Q[bool]   PWM Hardware
  *
+ *  With THERMAL_MODEL_PROTECTION:
+ *
+ *    D[float]  Model gain, temperature rise over ambient at full power
+ *    K[float]  Model time constant in seconds
+ *    V[float]  Model fan loss, heat loss increase with fan at full speed
+ *
+ *  With HEATER_POWER_BUDGET:
+ *
+ *    W[int]    Heater power in watts at full PWM, 0 not limited by the budget
+ *
  */
 inline void gcode_M306() {
 
@@ -60,7 +70,14 @@ inline void gcode_M306() {
 
   #if DISABLED(DISABLE_M503)
     // No arguments? Show M306 report.
-    if (!parser.seen("ABCFLO") && !parser.seen("UIRPQ")) {
+    if (!parser.seen("ABCFLO") && !parser.seen("UIRPQ")
+      #if ENABLED(THERMAL_MODEL_PROTECTION)
+        && !parser.seen("DKV")
+      #endif
+      #if ENABLED(HEATER_POWER_BUDGET)
+        && !parser.seen('W')
+      #endif
+    ) {
       act->print_M306();
       return;
     }
@@ -75,12 +92,22 @@ inline void gcode_M306() {
 
   NOMORE(act->data.pid.drive.max, act->data.pid.Max);
 
+  #if ENABLED(THERMAL_MODEL_PROTECTION)
+    act->data.model.gain      = parser.floatval('D', act->data.model.gain);
+    act->data.model.tau       = parser.floatval('K', act->data.model.tau);
+    act->data.model.fan_loss  = parser.floatval('V', act->data.model.fan_loss);
+    if (act->data.model.tau > 0) NOLESS(act->data.model.tau, 1.0f);
+    act->thermal_model_reset();
+  #endif
+
+  #if ENABLED(HEATER_POWER_BUDGET)
+    act->data.watts = parser.ushortval('W', act->data.watts);
+  #endif
+
   if (parser.seen('U'))
     act->setUsePid(parser.value_bool());
   if (parser.seen('I'))
     act->setHWinvert(parser.value_bool());
-  if (parser.seen('Q'))
-    act->setHWpwm(parser.value_bool());
   if (parser.seen('R'))
     act->setThermalProtection(parser.value_bool());
 
@@ -88,6 +115,13 @@ inline void gcode_M306() {
     // Put off the heaters
     act->set_target_temp(0);
     act->data.pin = HAL::digital_value_pin();
+    act->setHWpwm(act->isHWpwm());
+  }
+
+  if (parser.seen('Q')) {
+    act->setHWpwm(parser.value_bool());
+    if (parser.value_bool() && !act->isHWpwm())
+      SERIAL_EM("!No hardware PWM on this pin, use software PWM");
   }
 
 }
@@ -38,6 +38,7 @@
  *    S = Segments per Second Print
  *    F = Segments per Second Move
  *    L = Segments per Line
+ *    T = Segment tolerance (0 = use segments per second)
  *    A = Tower A: Diagonal Rod Adjust
  *    B = Tower B: Diagonal Rod Adjust
  *    C = Tower C: Diagonal Rod Adjust
@@ -70,6 +71,7 @@ inline void gcode_M666() {
   if (parser.seen('S')) mechanics.data.segments_per_second_print  = parser.value_ushort();
   if (parser.seen('F')) mechanics.data.segments_per_second_move   = parser.value_ushort();
   if (parser.seen('L')) mechanics.data.segments_per_line          = parser.value_byte();
+  if (parser.seen('T')) mechanics.data.segment_tolerance          = parser.value_linear_units();
   if (parser.seen('A')) mechanics.data.diagonal_rod_adj.a         = parser.value_linear_units();
   if (parser.seen('B')) mechanics.data.diagonal_rod_adj.b         = parser.value_linear_units();
   if (parser.seen('C')) mechanics.data.diagonal_rod_adj.c         = parser.value_linear_units();
@@ -84,6 +86,7 @@ inline void gcode_M666() {
 
   NOLESS(mechanics.data.segments_per_line, 10);
   NOMORE(mechanics.data.segments_per_line, 255);
+  NOLESS(mechanics.data.segment_tolerance, 0.0f);
 
   LOOP_XYZ(i) {
     if (parser.seen(axis_codes[i])) {
@@ -253,6 +253,7 @@
 #include "temperature/m141.h"
 #include "temperature/m142.h"
 #include "temperature/m155.h"
+#include "temperature/m156.h"             // Temperature telemetry
 #include "temperature/m190.h"
 #include "temperature/m191.h"
 #include "temperature/m192.h"
@@ -33,14 +33,99 @@
   #define N_ARC_CORRECTION 1
 #endif
 
+#if ENABLED(ARC_STEPPER_BLOCKS)
+
+  /**
+   * Queue an XY arc as arc blocks, split on every multiple of 45 degrees
+   * so each motor keeps one direction along a block.
+   * Return false if the arc must be segmented instead.
+   */
+  bool plan_arc_blocks(
+    const xyze_pos_t &cart,       // Destination position
+    const xy_pos_t &center,       // Center of rotation
+    const float radius,
+    const float start_angle,
+    const float angular_travel,
+    const float mm_of_travel,
+    const feedrate_t fr_mm_s
+  ) {
+    // The stepper traces a circle only with square steps and without leveling
+    if (mechanics.data.axis_steps_per_mm.x != mechanics.data.axis_steps_per_mm.y) return false;
+    #if HAS_LEVELING
+      if (bedlevel.flag.leveling_active) return false;
+    #endif
+
+    // Keep the radius within the integer range of the stepper
+    if (radius * mechanics.data.axis_steps_per_mm.x >= 131072) return false;
+
+    // The whole circle must be within the software endstops
+    LOOP_L_N(i, 4) {
+      xyz_pos_t corner = { center.x + (TEST(i, 0) ? radius : -radius), center.y + (TEST(i, 1) ? radius : -radius), mechanics.position.z };
+      const float ux = corner.x, uy = corner.y;
+      endstops.apply_motion_limits(corner);
+      if (corner.x != ux || corner.y != uy) return false;
+    }
+
+    constexpr float octant = RADIANS(45), min_angle = 0.0001f;
+    const float end_angle = start_angle + angular_travel,
+                z_per_rad = (cart.z - mechanics.position.z) / angular_travel,
+                e_per_rad = (cart.e - mechanics.position.e) / angular_travel,
+                mm_per_rad = mm_of_travel / ABS(angular_travel);
+
+    xyze_pos_t raw = mechanics.position;
+    float angle = start_angle;
+
+    short_timer_t next_idle_timer(millis());
+
+    while (angle != end_angle) {
+
+      if (next_idle_timer.expired(200)) printer.idle();
+
+      // Next multiple of 45 degrees along the arc, without pieces too small to plan
+      float next;
+      if (angular_travel > 0) {
+        next = (FLOOR(angle / octant) + 1) * octant;
+        if (next - angle < min_angle) next += octant;
+        if (next > end_angle - min_angle) next = end_angle;
+      }
+      else {
+        next = (CEIL(angle / octant) - 1) * octant;
+        if (angle - next < min_angle) next -= octant;
+        if (next < end_angle + min_angle) next = end_angle;
+      }
+
+      if (next == end_angle)
+        raw = cart;
+      else {
+        raw.x = center.x + radius * COS(next);
+        raw.y = center.y + radius * SIN(next);
+        raw.z += z_per_rad * (next - angle);
+        raw.e += e_per_rad * (next - angle);
+      }
+
+      if (!planner.buffer_arc(raw, center, fr_mm_s, toolManager.extruder.active, mm_per_rad * ABS(next - angle)))
+        break;
+
+      angle = next;
+    }
+
+    mechanics.position = cart;
+    return true;
+  }
+
+#endif // ARC_STEPPER_BLOCKS
+
 /**
  * Plan an arc in 2 dimensions
  *
  * The arc is approximated by generating many small linear segments.
  * The length of each segment is configured in MM_PER_ARC_SEGMENT (Default 1mm)
+ * or, with ARC_SEGMENT_TOLERANCE, is the longest chord within that deviation
+ * from the arc, so small arcs get more segments and large arcs fewer.
  * Arcs should only be made relatively large (over 5mm), as larger arcs with
  * larger segments will tend to be more efficient. Your slicer should have
  * options for G2/G3 arc generation. In future these options may be GCode tunable.
+ * With ARC_STEPPER_BLOCKS, XY arcs are queued as arc blocks instead.
  */
 void plan_arc(
   const xyze_pos_t &cart,   // Destination position
@@ -76,28 +161,47 @@ void plan_arc(
   // CCW angle of rotation between position and target from the circle center. Only one atan2() trig computation required.
   float angular_travel = ATAN2(rvec.a * rt_Y - rvec.b * rt_X, rvec.a * rt_X + rvec.b * rt_Y);
   if (angular_travel < 0) angular_travel += RADIANS(360);
+  if (clockwise) angular_travel -= RADIANS(360);
+
+  // Make a circle if the angular rotation is 0
+  if (angular_travel == 0 && mechanics.position[p_axis] == cart[p_axis] && mechanics.position[q_axis] == cart[q_axis])
+    angular_travel = RADIANS(360);
+
+  // Minimum segments of the arc in the direction it is traced
   #if ENABLED(MIN_ARC_SEGMENTS)
-    uint16_t min_segments = CEIL((MIN_ARC_SEGMENTS) * (angular_travel / RADIANS(360)));
+    uint16_t min_segments = CEIL((MIN_ARC_SEGMENTS) * (ABS(angular_travel) / RADIANS(360)));
     NOLESS(min_segments, 1u);
   #else
     constexpr uint16_t min_segments = 1;
   #endif
-  if (clockwise) angular_travel -= RADIANS(360);
-
-  // Make a circle if the angular rotation is 0
-  if (angular_travel == 0 && mechanics.position[p_axis] == cart[p_axis] && mechanics.position[q_axis] == cart[q_axis]) {
-    angular_travel = RADIANS(360);
-    #if ENABLED(MIN_ARC_SEGMENTS)
-      min_segments = MIN_ARC_SEGMENTS;
-    #endif
-  }
 
   const float flat_mm = radius * angular_travel,
               mm_of_travel = linear_travel ? HYPOT(flat_mm, linear_travel) : ABS(flat_mm);
   if (mm_of_travel < 0.001f) return;
 
-  uint16_t segments = FLOOR(mm_of_travel / (MM_PER_ARC_SEGMENT));
-  if (segments == 0) segments = 1;
+  const feedrate_t fr_mm_s = MMS_SCALED(mechanics.feedrate_mm_s);
+
+  #if ENABLED(ARC_STEPPER_BLOCKS)
+    // XY arcs go to the stepper as arcs when possible
+    if (p_axis == X_AXIS && plan_arc_blocks(cart, { center_P, center_Q }, radius, ATAN2(rvec.b, rvec.a), angular_travel, mm_of_travel, fr_mm_s))
+      return;
+  #endif
+
+  #if ENABLED(ARC_SEGMENT_TOLERANCE)
+    // Longest chord within the tolerance on this radius
+    const float tolerance = MIN(ARC_SEGMENT_TOLERANCE, radius);
+    float chord_mm = 2.0f * SQRT(tolerance * (2.0f * radius - tolerance));
+    // Not shorter than the planner moves in the min segment time
+    NOLESS(chord_mm, fr_mm_s * mechanics.data.min_segment_time_us * 0.000001f);
+    NOMORE(chord_mm, MAX_MM_PER_ARC_SEGMENT);
+    uint16_t segments = CEIL(mm_of_travel / chord_mm);
+  #else
+    uint16_t segments = FLOOR(mm_of_travel / (MM_PER_ARC_SEGMENT));
+  #endif
+  NOLESS(segments, min_segments);
+
+  // Length of each segment
+  const float segment_mm = mm_of_travel / segments;
 
   /**
    * Vector rotation by transformation matrix: r is the original vector, r_T is the rotated vector,
@@ -130,8 +234,14 @@ void plan_arc(
   const float theta_per_segment = angular_travel / segments,
               linear_per_segment = linear_travel / segments,
               extruder_per_segment = extruder_travel / segments,
-              sin_T = theta_per_segment,
-              cos_T = 1 - 0.5f * sq(theta_per_segment); // Small angle approximation
+              #if ENABLED(ARC_SEGMENT_TOLERANCE)
+                // Segments may be too long for the small angle approximation
+                sin_T = SIN(theta_per_segment),
+                cos_T = COS(theta_per_segment);
+              #else
+                sin_T = theta_per_segment,
+                cos_T = 1 - 0.5f * sq(theta_per_segment); // Small angle approximation
+              #endif
 
   // Initialize the linear axis
   raw[l_axis] = mechanics.position[l_axis];
@@ -139,10 +249,8 @@ void plan_arc(
   // Initialize the extruder axis
   raw[E_AXIS] = mechanics.position.e;
 
-  const feedrate_t fr_mm_s = MMS_SCALED(mechanics.feedrate_mm_s);
-
   #if ENABLED(SCARA_FEEDRATE_SCALING)
-    const float inv_duration = fr_mm_s / MM_PER_ARC_SEGMENT;
+    const float inv_duration = fr_mm_s / segment_mm;
   #endif
 
   short_timer_t next_idle_timer(millis());
@@ -196,7 +304,7 @@ void plan_arc(
       bedlevel.apply_leveling(raw);
     #endif
 
-    if (!planner.buffer_line(raw, fr_mm_s, toolManager.extruder.active, MM_PER_ARC_SEGMENT
+    if (!planner.buffer_line(raw, fr_mm_s, toolManager.extruder.active, segment_mm
       #if ENABLED(SCARA_FEEDRATE_SCALING)
         , inv_duration
       #endif
@@ -216,7 +324,7 @@ void plan_arc(
     bedlevel.apply_leveling(raw);
   #endif
 
-  planner.buffer_line(raw, fr_mm_s, toolManager.extruder.active, MM_PER_ARC_SEGMENT
+  planner.buffer_line(raw, fr_mm_s, toolManager.extruder.active, segment_mm
     #if ENABLED(SCARA_FEEDRATE_SCALING)
       , inv_duration
     #endif
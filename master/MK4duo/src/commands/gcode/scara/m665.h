@@ -64,5 +64,7 @@
         return;
       }
     #endif // WORKSPACE_OFFSETS
+
+    mechanics.recalc_scara_settings();
   }
 #endif // IS_SCARA
@@ -33,12 +33,94 @@
 
 /**
  * M24: Start or Resume SD Print
+ *
+ *  S<pos>    Resume from the file position
+ *  T<sec>    Elapsed time of the print
+ *  L<layer>  Start from the layer, 0 = first (SD_LAYER_INDEX)
+ *  Z<mm>     Start from the first layer at this height or above (SD_LAYER_INDEX)
+ *            L and Z need a selected file, homed axes and no print running.
+ *            The temperatures and fan speeds of the layer are set and
+ *            waited for.
  */
 inline void gcode_M24() {
 
   if (parser.seenval('S')) card.setIndex(parser.value_long());
   if (parser.seenval('T')) print_job_counter.resume(parser.value_long());
 
+  #if ENABLED(SD_LAYER_INDEX)
+    if (parser.seenval('L') || parser.seenval('Z')) {
+      if (!card.isFileOpen()) {
+        SERIAL_LM(ER, STR_SD_LAYER_NO_FILE);
+        return;
+      }
+      if (IS_SD_PRINTING()) {
+        SERIAL_LM(ER, STR_SD_LAYER_PRINTING);
+        return;
+      }
+      if (mechanics.axis_unhomed_error()) return;
+      layer_record_t rec;
+      if (!layerindex.find(rec, parser.intval('L', -1), parser.floatval('Z'))) {
+        SERIAL_LM(ER, STR_SD_LAYER_NOT_FOUND);
+        return;
+      }
+
+      // No temperature set by the file or before the print: the layer can't extrude
+      #if HAS_HOTENDS
+        const uint8_t hotend = rec.tool < tempManager.heater.hotends ? rec.tool : 0;
+        if (!rec.hotend_target[hotend]) {
+          SERIAL_LM(ER, STR_SD_LAYER_NO_TEMP);
+          return;
+        }
+      #endif
+
+      char cmd[20], str1[16];
+
+      // Raise Z over the layer so no move touches the part
+      mechanics.axis_relative_modes = 0;
+      if (mechanics.position.z < rec.z + LAYER_INDEX_ZRAISE) {
+        sprintf_P(cmd, PSTR("G1 Z%s"), dtostrf(rec.z + LAYER_INDEX_ZRAISE, 1, 3, str1));
+        commands.process_now(cmd);
+      }
+
+      // Select the tool of the layer (with no_move)
+      #if EXTRUDERS > 1
+        sprintf_P(cmd, PSTR("T%i S"), rec.tool);
+        commands.process_now(cmd);
+      #endif
+
+      // Temperatures and fan speeds at the layer, 0 leaves a heater as it is
+      #if HAS_BEDS
+        LOOP_BED() {
+          if (beds[h] && rec.bed_target[h]) {
+            beds[h]->set_target_temp(rec.bed_target[h]);
+            beds[h]->wait_for_target(true);
+          }
+        }
+      #endif
+      #if HAS_HOTENDS
+        LOOP_HOTEND() {
+          if (hotends[h] && rec.hotend_target[h]) {
+            hotends[h]->set_target_temp(rec.hotend_target[h]);
+            hotends[h]->wait_for_target(true);
+          }
+        }
+      #endif
+      #if HAS_FAN
+        LOOP_FAN() {
+          if (fans[f]) fans[f]->speed = rec.fan_speed[f];
+        }
+      #endif
+
+      // Parser state at the layer, the print goes on from the line moving to it
+      mechanics.axis_relative_modes = rec.relative;
+      if (rec.feedrate) mechanics.feedrate_mm_s = MMM_TO_MMS(rec.feedrate);
+      sprintf_P(cmd, PSTR("G92.9 E%s"), dtostrf(rec.e, 1, 3, str1));
+      commands.process_now(cmd);
+      card.setIndex(rec.sdpos);
+      SERIAL_LMV(ECHO, STR_SD_LAYER_START, rec.z, 2);
+    }
+  #endif
+
   #if ENABLED(PARK_HEAD_ON_PAUSE)
     if (advancedpause.did_pause_print) {
       advancedpause.resume_print();
@@ -34,12 +34,17 @@
  * M27: Get SD Card status
  *      OR, with 'S<bool>' set the SD status auto-report.
  *      OR, with 'C' get the current filename.
+ *      OR, with 'Q' get the SD prefetch queue statistics.
  */
 inline void gcode_M27() {
   if (parser.seen('C'))
     SERIAL_EMT("Current file: ", card.fileName);
   else if (parser.seenval('S'))
     card.setAutoreport(parser.value_bool());
+  #if ENABLED(SD_PREFETCH_QUEUE)
+    else if (parser.seen('Q'))
+      commands.print_sd_prefetch_stats();
+  #endif
   else
     card.print_status();
 }
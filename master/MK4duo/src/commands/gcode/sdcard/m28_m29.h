@@ -33,8 +33,23 @@
 
 /**
  * M28: Start SD Write
+ *
+ *  B<size> <file> - Receive the file as binary frames, M29 saves it (SD_BINARY_UPLOAD)
  */
-inline void gcode_M28() { card.startWrite(parser.string_arg, false); }
+inline void gcode_M28() {
+  #if ENABLED(SD_BINARY_UPLOAD)
+    char *p = parser.string_arg;
+    if (p && *p == 'B' && NUMERIC(p[1])) {
+      const uint32_t size = strtoul(p + 1, &p, 10);
+      if (*p == ' ') {
+        while (*p == ' ') p++;
+        card.startBinaryWrite(p, size, commands.buffer_ring.peek().s_port);
+        return;
+      }
+    }
+  #endif
+  card.startWrite(parser.string_arg, false);
+}
 
 /**
  * M29: Stop SD Write
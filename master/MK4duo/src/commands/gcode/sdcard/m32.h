@@ -43,7 +43,7 @@ inline void gcode_M32() {
 
     SERIAL_MV("Open file: ", namestartpos);
     SERIAL_EM(" and start print.");
-    card.selectFile(namestartpos);
+    if (!card.selectFile(namestartpos)) return;
     if (parser.seenval('S')) card.setIndex(parser.value_long());
 
     mechanics.feedrate_mm_s       = 20.0; // 20 units/sec
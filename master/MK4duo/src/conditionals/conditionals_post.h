@@ -81,6 +81,20 @@
   #define NUM_POSITON_SLOTS 1
 #endif
 
+/**
+ * G5 Bezier, the tolerance is only in the laser configuration
+ */
+#if ENABLED(G5_BEZIER) && DISABLED(BEZIER_TOLERANCE)
+  #define BEZIER_TOLERANCE 0.05   // Max distance of the G5 lines from the curve (mm)
+#endif
+
+/**
+ * SD metadata index size
+ */
+#if ENABLED(SD_METADATA_INDEX) && DISABLED(SD_METADATA_RECORDS)
+  #define SD_METADATA_RECORDS 64
+#endif
+
 /**
  * DELTA
  */
@@ -753,6 +767,13 @@
   #define MAX_PATH_NAME_LENGHT  (LONG_FILENAME_LENGTH * SD_MAX_FOLDER_DEPTH + SD_MAX_FOLDER_DEPTH + 1)
   #define SHORT_FILENAME_LENGTH 14
   #define GENBY_SIZE 16
+  #if ENABLED(GCZ_SUPPORT) && DISABLED(GCZ_WINDOW_BITS)
+    #if ENABLED(__AVR__)
+      #define GCZ_WINDOW_BITS 8     // 256 bytes window
+    #else
+      #define GCZ_WINDOW_BITS 11    // 2 KB window
+    #endif
+  #endif
 #else
   #undef SCROLL_LONG_FILENAMES
   #undef SDCARD_SORT_ALPHA
@@ -1684,6 +1705,7 @@
 #define HAS_BEDS            (MAX_BED > 0)
 #define HAS_CHAMBERS        (MAX_CHAMBER > 0)
 #define HAS_COOLERS         (MAX_COOLER > 0)
+#define MAX_HEATER          (MAX_HOTEND + MAX_BED + MAX_CHAMBER + MAX_COOLER)
 #define HAS_FAN             (MAX_FAN > 0)
 
 /**
@@ -304,6 +304,8 @@ void EEPROM::post_process() {
   // planner position so the stepper counts will be set correctly.
   #if MECH(DELTA)
     mechanics.recalc_delta_settings();
+  #elif IS_SCARA
+    mechanics.recalc_scara_settings();
   #endif
 
   tempManager.init();
@@ -329,6 +331,8 @@ void EEPROM::post_process() {
 
   #if ENABLED(AUTO_BED_LEVELING_BILINEAR)
     abl.refresh_bed_level();
+  #elif HAS_MESH
+    bedlevel.refresh_mesh();
   #endif
 
   #if ENABLED(FWRETRACT)
@@ -1327,6 +1331,8 @@ void EEPROM::post_process() {
       if (status) SERIAL_MSG("?Unable to load mesh data.\n");
       else        DEBUG_EMV("Mesh loaded from slot ", slot);
 
+      if (!into) bedlevel.refresh_mesh();
+
     }
 
   #endif // AUTO_BED_LEVELING_UBL
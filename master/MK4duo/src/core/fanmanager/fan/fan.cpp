@@ -80,23 +80,30 @@ void Fan::set_output_pwm() {
 
   const uint8_t new_speed = isHWinvert() ? 255 - actual_speed() : actual_speed();
 
+  #if ENABLED(SOFT_PWM_TIMER)
+    // Software PWM is driven by soft PWM timer
+    HAL::soft_pwm_set(MAX_HEATER + data.ID, (data.pin > NoPin && !USEABLE_HARDWARE_PWM(data.pin)) ? data.pin : NoPin, new_speed);
+  #endif
+
   if (data.pin > NoPin) {
     if (USEABLE_HARDWARE_PWM(data.pin))
       HAL::analogWrite(data.pin, new_speed, fanManager.data.frequency);
-    else {
-      #if ENABLED(SOFTWARE_PDM)
-        const uint8_t carry = pwm_soft_pos + new_speed;
-        HAL::digitalWrite(data.pin, (carry < pwm_soft_pos));
-        pwm_soft_pos = carry;
-      #else // SOFTWARE PWM
-        // Turn HIGH Software PWM
-        if (fanManager.pwm_soft_count == 0 && ((pwm_soft_pos = (new_speed & SOFT_PWM_MASK)) > 0))
-            HAL::digitalWrite(data.pin, HIGH);
-        // Turn LOW Software PWM
-        if (pwm_soft_pos == fanManager.pwm_soft_count && pwm_soft_pos != SOFT_PWM_MASK)
-          HAL::digitalWrite(data.pin, LOW);
-      #endif
-    }
+    #if DISABLED(SOFT_PWM_TIMER)
+      else {
+        #if ENABLED(SOFTWARE_PDM)
+          const uint8_t carry = pwm_soft_pos + new_speed;
+          HAL::digitalWrite(data.pin, (carry < pwm_soft_pos));
+          pwm_soft_pos = carry;
+        #else // SOFTWARE PWM
+          // Turn HIGH Software PWM
+          if (fanManager.pwm_soft_count == 0 && ((pwm_soft_pos = (new_speed & SOFT_PWM_MASK)) > 0))
+              HAL::digitalWrite(data.pin, HIGH);
+          // Turn LOW Software PWM
+          if (pwm_soft_pos == fanManager.pwm_soft_count && pwm_soft_pos != SOFT_PWM_MASK)
+            HAL::digitalWrite(data.pin, LOW);
+        #endif
+      }
+    #endif
   }
 
 }
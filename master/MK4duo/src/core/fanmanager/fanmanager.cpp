@@ -34,7 +34,7 @@ FanManager fanManager;
 /** Public Parameters */
 fans_data_t FanManager::data;
 
-#if DISABLED(SOFTWARE_PDM)
+#if DISABLED(SOFTWARE_PDM) && DISABLED(SOFT_PWM_TIMER)
   uint8_t FanManager::pwm_soft_count = 0;
 #endif
 
@@ -85,7 +85,7 @@ void FanManager::set_output_pwm() {
     }
   }
 
-  #if DISABLED(SOFTWARE_PDM)
+  #if DISABLED(SOFTWARE_PDM) && DISABLED(SOFT_PWM_TIMER)
     pwm_soft_count += SOFT_PWM_STEP;
   #endif
 }
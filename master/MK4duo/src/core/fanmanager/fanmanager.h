@@ -45,7 +45,7 @@ class FanManager {
 
     static fans_data_t data;
 
-    #if DISABLED(SOFTWARE_PDM)
+    #if DISABLED(SOFTWARE_PDM) && DISABLED(SOFT_PWM_TIMER)
       static uint8_t pwm_soft_count;
     #endif
 
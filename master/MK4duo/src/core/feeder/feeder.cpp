@@ -0,0 +1,157 @@
+/**
+ * MK4duo Firmware for 3D Printer, Laser and CNC
+ *
+ * Based on Marlin, Sprinter and grbl
+ * Copyright (c) 2011 Camiel Gubbels / Erik van der Zalm
+ * Copyright (c) 2020 Alberto Cotronei @MagoKimbra
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program. If not, see <http://www.gnu.org/licenses/>.
+ *
+ */
+
+/**
+ * feeder.cpp - Segment feeder for kinematic machines
+ *
+ * Copyright (c) 2020 Alberto Cotronei @MagoKimbra
+ *
+ * Segmented moves are queued whole and split in lines only when the
+ * planner has free blocks, so the main loop is not held generating
+ * lines and the command queue is read ahead. The newest block still
+ * plans a stop at its end, every line queued after it raises its exit
+ * speed through the usual look-ahead.
+ *
+ * Every line is still a planner block, so the look-ahead is the same
+ * as without the feeder: BLOCK_BUFFER_SIZE lines, and short lines limit
+ * the speed. See tools/test_segment_feeder.py.
+ */
+
+#include "../../../MK4duo.h"
+#include "sanitycheck.h"
+
+#if ENABLED(KINEMATIC_SEGMENT_FEEDER)
+
+SegmentFeeder feeder;
+
+/** Private Parameters */
+Circular_Queue<feeder_move_t, KINEMATIC_FEEDER_MOVES> SegmentFeeder::buffer;
+
+feeder_move_t SegmentFeeder::current;
+
+bool SegmentFeeder::feeding = false;
+
+#if ENABLED(DELTA_INCREMENTAL_TRANSFORM)
+  bool SegmentFeeder::incremental = false;
+#endif
+
+#if ENABLED(AUTO_BED_LEVELING_BILINEAR)
+  uint8_t SegmentFeeder::batch_left = 0;
+#endif
+
+/** Public Function */
+void SegmentFeeder::add(const xyze_pos_t &start, const xyze_pos_t &target, const uint16_t lines, const feedrate_t &fr_mm_s, const uint8_t extruder, const float line_mm) {
+
+  feeder_move_t move;
+  move.start    = start;
+  move.target   = target;
+  move.pos      = start;
+  move.step     = (target - start) * (1.0f / float(lines));
+  move.fr_mm_s  = fr_mm_s;
+  move.line_mm  = line_mm;
+  move.lines    = lines;
+  move.done     = 0;
+  move.extruder = extruder;
+
+  while (buffer.isFull()) printer.idle();
+
+  buffer.enqueue(move);
+
+  feed();
+
+}
+
+void SegmentFeeder::feed() {
+
+  // The planner can call back while a line is queued
+  if (feeding) return;
+  feeding = true;
+
+  while (!planner.is_full()) {
+
+    // Take the next move
+    if (current.done >= current.lines) {
+      if (buffer.isEmpty()) break;
+      current = buffer.dequeue();
+      #if ENABLED(DELTA_INCREMENTAL_TRANSFORM)
+        // Planar leveling rotates XY so the towers must be computed from scratch
+        #if ABL_PLANAR
+          incremental = !bedlevel.flag.leveling_active;
+        #else
+          incremental = true;
+        #endif
+        if (incremental) mechanics.walk_start(current.start, current.step);
+      #endif
+      #if ENABLED(AUTO_BED_LEVELING_BILINEAR)
+        batch_left = 0;
+      #endif
+    }
+
+    #if ENABLED(AUTO_BED_LEVELING_BILINEAR)
+      // Level the next lines of the move in one pass
+      if (bedlevel.flag.leveling_active && !batch_left) {
+        batch_left = MIN(current.lines - current.done - 1, ABL_BATCH_POINTS);
+        abl.bilinear_z_batch_line(current.pos, current.step, batch_left);
+      }
+      if (batch_left) batch_left--;
+    #endif
+
+    const bool last_line = ++current.done >= current.lines;
+
+    // Ensure last line arrives at target location
+    current.pos += current.step;
+    const xyze_pos_t &raw = last_line ? current.target : current.pos;
+
+    #if ENABLED(DELTA_INCREMENTAL_TRANSFORM)
+      const bool queued = incremental && !last_line
+        ? planner.buffer_delta_line(raw, mechanics.walk_next(), current.fr_mm_s, current.extruder, current.line_mm)
+        : planner.buffer_line(raw, current.fr_mm_s, current.extruder, current.line_mm);
+    #else
+      const bool queued = planner.buffer_line(raw, current.fr_mm_s, current.extruder, current.line_mm);
+    #endif
+
+    // The planner is dropping moves, drop all the queue
+    if (!queued) {
+      clear();
+      break;
+    }
+
+  }
+
+  feeding = false;
+
+}
+
+void SegmentFeeder::flush() {
+  if (feeding) return;
+  while (busy()) {
+    feed();
+    if (busy()) printer.idle();
+  }
+}
+
+void SegmentFeeder::clear() {
+  buffer.clear();
+  current.done = current.lines = 0;
+}
+
+#endif // ENABLED(KINEMATIC_SEGMENT_FEEDER)
@@ -0,0 +1,98 @@
+/**
+ * MK4duo Firmware for 3D Printer, Laser and CNC
+ *
+ * Based on Marlin, Sprinter and grbl
+ * Copyright (c) 2011 Camiel Gubbels / Erik van der Zalm
+ * Copyright (c) 2020 Alberto Cotronei @MagoKimbra
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program. If not, see <http://www.gnu.org/licenses/>.
+ *
+ */
+#pragma once
+
+/**
+ * feeder.h - Segment feeder for kinematic machines
+ *
+ * Copyright (c) 2020 Alberto Cotronei @MagoKimbra
+ */
+
+#if ENABLED(KINEMATIC_SEGMENT_FEEDER)
+
+// Struct cartesian move waiting to be split in lines
+typedef struct {
+  xyze_pos_t    start,      // Cartesian position at the start of the move
+                target,     // Cartesian position at the end of the move
+                pos;        // Cartesian position of the last line sent
+  xyze_float_t  step;       // Cartesian distance of one line
+  feedrate_t    fr_mm_s;    // Feedrate of the move
+  float         line_mm;    // Length of one line
+  uint16_t      lines,      // Number of lines of the move
+                done;       // Lines already sent to the planner
+  uint8_t       extruder;   // Extruder of the move
+} feeder_move_t;
+
+class SegmentFeeder {
+
+  public: /** Constructor */
+
+    SegmentFeeder() {}
+
+  private: /** Private Parameters */
+
+    static Circular_Queue<feeder_move_t, KINEMATIC_FEEDER_MOVES> buffer;
+
+    static feeder_move_t  current;
+
+    static bool           feeding;
+
+    #if ENABLED(DELTA_INCREMENTAL_TRANSFORM)
+      static bool         incremental;
+    #endif
+
+    #if ENABLED(AUTO_BED_LEVELING_BILINEAR)
+      static uint8_t      batch_left;
+    #endif
+
+  public: /** Public Function */
+
+    /**
+     * Queue a cartesian move to be split in lines of equal length.
+     * Wait if the queue is full.
+     */
+    static void add(const xyze_pos_t &start, const xyze_pos_t &target, const uint16_t lines, const feedrate_t &fr_mm_s, const uint8_t extruder, const float line_mm);
+
+    /**
+     * Send lines to the planner while it has free blocks.
+     * Called from Printer::idle()
+     */
+    static void feed();
+
+    /**
+     * Send all the queued moves to the planner, waiting for free blocks.
+     * Called by the planner before any other block or position change.
+     */
+    static void flush();
+
+    /**
+     * Drop all the queued moves
+     */
+    static void clear();
+
+    FORCE_INLINE static bool busy() { return current.done < current.lines || !buffer.isEmpty(); }
+
+};
+
+extern SegmentFeeder feeder;
+
+#endif // ENABLED(KINEMATIC_SEGMENT_FEEDER)
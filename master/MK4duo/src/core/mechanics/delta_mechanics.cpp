@@ -60,6 +60,19 @@ float       Delta_Mechanics::Xbc    = 0.0f,
             Delta_Mechanics::Q      = 0.0f,
             Delta_Mechanics::Q2     = 0.0f;
 
+#if ENABLED(DELTA_INCREMENTAL_TRANSFORM)
+  xy_pos_t    Delta_Mechanics::walk_pos{0.0f};
+  xy_float_t  Delta_Mechanics::walk_step{0.0f};
+  abc_float_t Delta_Mechanics::walk_q{0.0f},        // Radicand D2 - |r|^2 of each tower
+              Delta_Mechanics::walk_dq{0.0f},       // First forward difference of the radicand
+              Delta_Mechanics::walk_rsqrt{0.0f},    // Reciprocal square root of the radicand
+              Delta_Mechanics::walk_height{0.0f};   // Height of each tower above the effector
+  float       Delta_Mechanics::walk_ddq     = 0.0f, // Second forward difference, same for all towers
+              Delta_Mechanics::walk_limit   = 0.0f, // Largest h * e^2 for one Newton step
+              Delta_Mechanics::walk_limit2  = 0.0f; // Largest h * e^4 for two Newton steps
+  uint8_t     Delta_Mechanics::walk_count = 0;
+#endif
+
 /** Public Function */
 void Delta_Mechanics::factory_parameters() {
 
@@ -91,6 +104,7 @@ void Delta_Mechanics::factory_parameters() {
   data.segments_per_second_print  = DELTA_SEGMENTS_PER_SECOND_PRINT;
   data.segments_per_second_move   = DELTA_SEGMENTS_PER_SECOND_MOVE;
   data.segments_per_line          = DELTA_SEGMENTS_PER_LINE;
+  data.segment_tolerance          = DELTA_SEGMENT_TOLERANCE;
   data.print_radius               = DELTA_PRINTABLE_RADIUS;
   data.probe_radius               = DELTA_PROBEABLE_RADIUS;
   data.height                     = DELTA_HEIGHT;
@@ -172,6 +186,13 @@ void Delta_Mechanics::get_cartesian_from_steppers() {
     // Now compute the number of lines needed
     uint16_t numLines = (segments + data.segments_per_line - 1) / data.segments_per_line;
 
+    // With a tolerance the lines follow the curvature of the tower path instead,
+    // never finer than the single segments of the segments per second scheme
+    if (data.segment_tolerance > 0) {
+      numLines = tolerance_lines(difference, cartesian_distance);
+      NOMORE(numLines, segments);
+    }
+
     // The approximate length of each segment
     const float         inv_numLines = 1.0f / float(numLines),
                         cartesian_segment_mm = cartesian_distance * inv_numLines;
@@ -181,29 +202,69 @@ void Delta_Mechanics::get_cartesian_from_steppers() {
     DEBUG_MV("mm=", cartesian_distance);
     DEBUG_MV(" seconds=", seconds);
     DEBUG_MV(" segments=", segments);
+    DEBUG_MV(" tolerance=", data.segment_tolerance);
     DEBUG_MV(" numLines=", numLines);
     DEBUG_MV(" segment_mm=", cartesian_segment_mm);
     DEBUG_EOL();
     //*/
 
+    #if ENABLED(KINEMATIC_SEGMENT_FEEDER)
+
+      // Lines are sent to the planner as it empties
+      feeder.add(position, destination, numLines, _feedrate_mm_s, toolManager.extruder.active, cartesian_segment_mm);
+
+    #else
+
     // Get the current position as starting point
     xyze_pos_t raw = position;
 
+    #if ENABLED(DELTA_INCREMENTAL_TRANSFORM)
+      // Planar leveling rotates XY so the towers must be computed from scratch
+      #if ABL_PLANAR
+        const bool incremental = !bedlevel.flag.leveling_active;
+      #else
+        constexpr bool incremental = true;
+      #endif
+      if (incremental) walk_start(raw, segment_distance);
+    #endif
+
+    #if ENABLED(AUTO_BED_LEVELING_BILINEAR)
+      uint8_t batch_left = 0;
+    #endif
+
     // Calculate and execute the segments
     while (--numLines) {
 
       static short_timer_t next_idle_timer(millis());
       if (next_idle_timer.expired(200)) printer.idle();
 
+      #if ENABLED(AUTO_BED_LEVELING_BILINEAR)
+        // Level the next segments in one pass
+        if (bedlevel.flag.leveling_active && !batch_left) {
+          batch_left = MIN(numLines, ABL_BATCH_POINTS);
+          abl.bilinear_z_batch_line(raw, segment_distance, batch_left);
+        }
+        if (batch_left) batch_left--;
+      #endif
+
       raw += segment_distance;
 
-      if (!planner.buffer_line(raw, _feedrate_mm_s, toolManager.extruder.active, cartesian_segment_mm))
-        break;
+      #if ENABLED(DELTA_INCREMENTAL_TRANSFORM)
+        const bool queued = incremental
+          ? planner.buffer_delta_line(raw, walk_next(), _feedrate_mm_s, toolManager.extruder.active, cartesian_segment_mm)
+          : planner.buffer_line(raw, _feedrate_mm_s, toolManager.extruder.active, cartesian_segment_mm);
+        if (!queued) break;
+      #else
+        if (!planner.buffer_line(raw, _feedrate_mm_s, toolManager.extruder.active, cartesian_segment_mm))
+          break;
+      #endif
 
     }
 
     planner.buffer_line(destination, _feedrate_mm_s, toolManager.extruder.active, cartesian_segment_mm);
 
+    #endif // ENABLED(KINEMATIC_SEGMENT_FEEDER)
+
     return false; // caller will update position.x
 
   }
@@ -892,11 +953,12 @@ void Delta_Mechanics::report_logical_position(const xyze_pos_t &pos) {
     SERIAL_MV(" R", LINEAR_UNIT(data.radius));
     SERIAL_MV(" D", LINEAR_UNIT(data.diagonal_rod));
     SERIAL_EOL();
-    SERIAL_LM(CFG, "Delta Geometry adjustment: S<DELTA_SEGMENTS_PER_SECOND_PRINT> F<DELTA_SEGMENTS_PER_SECOND_MOVE> L<DELTA_SEGMENTS_PER_LINE>");
+    SERIAL_LM(CFG, "Delta Geometry adjustment: S<DELTA_SEGMENTS_PER_SECOND_PRINT> F<DELTA_SEGMENTS_PER_SECOND_MOVE> L<DELTA_SEGMENTS_PER_LINE> T<DELTA_SEGMENT_TOLERANCE>");
     SERIAL_SM(CFG, "  M666");
     SERIAL_MV(" S", data.segments_per_second_print);
     SERIAL_MV(" F", data.segments_per_second_move);
     SERIAL_MV(" L", data.segments_per_line);
+    SERIAL_MV(" T", LINEAR_UNIT(data.segment_tolerance), 3);
     SERIAL_EOL();
     SERIAL_LM(CFG, "Delta Geometry adjustment: O<DELTA_PRINTABLE_RADIUS> P<DELTA_PROBEABLE_RADIUS> H<DELTA_HEIGHT>");
     SERIAL_SM(CFG, "  M666");
@@ -997,6 +1059,141 @@ void Delta_Mechanics::Set_clip_start_height() {
   delta_clip_start_height = data.height - ABS(distance - delta.a);
 }
 
+#if ENABLED(DELTA_INCREMENTAL_TRANSFORM)
+
+  /**
+   * Along a straight move with constant step d the radicand
+   *   q(n) = D2 - |r0 + n * d|^2
+   * is a quadratic in the line index n, so it is advanced exactly by
+   * forward differencing with a second difference of -2 * |d|^2.
+   * The reciprocal square root y of the previous line is a very close
+   * guess for the next one and a Newton step
+   *   y = y * (1 + e / 2)  with  e = 1 - q * y^2
+   * refines it without divisions. After the step the residual is about
+   * 3/4 * e^2, so the error on the height h = q * y is about 3/8 * h * e^2
+   * and can be known before the step: within a quarter microstep the line
+   * takes one step, or two when 0.21 * h * e^4 is, else the full square root.
+   */
+  void Delta_Mechanics::walk_start(const xy_pos_t &raw, const xy_float_t &step) {
+
+    // Delta hotend offsets must be applied in Cartesian space
+    const xyz_pos_t &offset = nozzle.data.hotend_offset[toolManager.active_hotend()];
+
+    walk_pos.set(raw.x - offset.x, raw.y - offset.y);
+    walk_step = step;
+    walk_ddq  = -2.0f * (sq(step.x) + sq(step.y));
+    const float step_mm = 1.0f / MAX(data.axis_steps_per_mm.a, data.axis_steps_per_mm.b, data.axis_steps_per_mm.c);
+    walk_limit  = 0.6f * step_mm;
+    walk_limit2 = step_mm;
+
+    walk_sync();
+    LOOP_ABC(tower) walk_rsqrt[tower] = walk_q[tower] > 0.0f ? 1.0f / SQRT(walk_q[tower]) : 0.0f;
+  }
+
+  const abc_float_t& Delta_Mechanics::walk_next() {
+
+    walk_pos += walk_step;
+
+    if (++walk_count >= DELTA_INCREMENTAL_RESYNC)
+      walk_sync();
+    else {
+      walk_q += walk_dq;
+      walk_dq += walk_ddq;
+    }
+
+    LOOP_ABC(tower) {
+      const float q = walk_q[tower];
+      float &y = walk_rsqrt[tower];
+
+      if (q > 0.0f && y > 0.0f) {
+        const float h   = q * y,
+                    e   = 1.0f - h * y,
+                    he2 = h * sq(e),
+                    f   = 1.0f + 0.5f * e;
+        if (he2 < walk_limit) {
+          y *= f;
+          walk_height[tower] = h * f;
+          continue;
+        }
+        if (he2 * sq(e) < walk_limit2) {
+          const float h1 = h * f;
+          y *= f;
+          const float f1 = 1.5f - 0.5f * h1 * y;
+          y *= f1;
+          walk_height[tower] = h1 * f1;
+          continue;
+        }
+      }
+
+      // Far from the guess or unreachable, same result as Transform
+      walk_height[tower] = _SQRT(q);
+      y = q > 0.0f ? 1.0f / walk_height[tower] : 0.0f;
+    }
+
+    return walk_height;
+  }
+
+  void Delta_Mechanics::walk_sync() {
+    const float d2 = sq(walk_step.x) + sq(walk_step.y);
+    LOOP_ABC(tower) {
+      const xy_float_t r = { walk_pos.x - towerX[tower], walk_pos.y - towerY[tower] };
+      walk_q[tower]  = D2[tower] - sq(r.x) - sq(r.y);
+      walk_dq[tower] = -2.0f * (r.x * walk_step.x + r.y * walk_step.y) - d2;
+    }
+    walk_count = 0;
+  }
+
+#endif
+
+#if DISABLED(AUTO_BED_LEVELING_UBL)
+
+  /**
+   * Along a straight move the height of each tower is
+   *   h(s) = z(s) + w(s)  with  w = sqrt(D2 - |r|^2)
+   * where r is the XY vector from the tower to the effector.
+   * A line of length L between two points of h deviates
+   * at most L^2 * |h''| / 8 from it, with
+   *   |h''| = |u|^2 / w + (r.u)^2 / w^3
+   * and u the unit vector of the move in the XY plane.
+   * The curvature is taken at start, middle and end of the move
+   * and, for every tower, at the point of the move closest to it.
+   */
+  uint16_t Delta_Mechanics::tolerance_lines(const xyze_float_t &difference, const float cartesian_distance) {
+
+    const float     inv_distance = 1.0f / cartesian_distance;
+    const xy_float_t u = { difference.x * inv_distance, difference.y * inv_distance };
+    const float     u2 = sq(u.x) + sq(u.y);
+    const xyz_pos_t &offset = nozzle.data.hotend_offset[toolManager.active_hotend()];
+    const float     d2 = sq(difference.x) + sq(difference.y);
+
+    float max_curvature = 0.0f;
+
+    LOOP_ABC(tower) {
+      const xy_float_t r0 = { position.x - offset.x - towerX[tower],
+                              position.y - offset.y - towerY[tower] };
+      // Closest approach of the move to the tower
+      const float t_near = constrain(-(r0.x * difference.x + r0.y * difference.y) / d2, 0.0f, 1.0f),
+                  samples[] = { 0.0f, 0.5f, 1.0f, t_near };
+      LOOP_L_N(i, COUNT(samples)) {
+        const xy_float_t r = { r0.x + difference.x * samples[i], r0.y + difference.y * samples[i] };
+        const float w2 = D2[tower] - sq(r.x) - sq(r.y);
+        if (w2 <= 0.0f) return UINT16_MAX;
+        const float w = SQRT(w2),
+                    ru = r.x * u.x + r.y * u.y,
+                    curvature = (u2 + sq(ru) / w2) / w;
+        NOLESS(max_curvature, curvature);
+      }
+    }
+
+    // Straight in every tower, a single line is exact
+    if (max_curvature < 1e-9f) return 1;
+
+    const float line_mm = SQRT(8.0f * data.segment_tolerance / max_curvature);
+    return MAX(1.0f, CEIL(cartesian_distance / line_mm));
+  }
+
+#endif
+
 #if ENABLED(DELTA_FAST_SQRT) && ENABLED(__AVR__)
 
   /**
@@ -47,6 +47,8 @@ typedef struct : public generic_data_t {
 
   uint8_t     segments_per_line;
 
+  float       segment_tolerance;
+
 } mechanics_data_t;
 
 class Delta_Mechanics : public Mechanics {
@@ -74,6 +76,14 @@ class Delta_Mechanics : public Mechanics {
                         coreKa, coreKb, coreKc,
                         Q, Q2;
 
+    #if ENABLED(DELTA_INCREMENTAL_TRANSFORM)
+      static xy_pos_t     walk_pos;
+      static xy_float_t   walk_step;
+      static abc_float_t  walk_q, walk_dq, walk_rsqrt, walk_height;
+      static float        walk_ddq, walk_limit, walk_limit2;
+      static uint8_t      walk_count;
+    #endif
+
   public: /** Public Function */
 
     /**
@@ -102,6 +112,20 @@ class Delta_Mechanics : public Mechanics {
       static bool prepare_move_to_destination_mech_specific();
     #endif
 
+    #if ENABLED(DELTA_INCREMENTAL_TRANSFORM)
+      /**
+       * Start the incremental transform of a segmented move
+       * from the cartesian position with a constant step.
+       */
+      static void walk_start(const xy_pos_t &raw, const xy_float_t &step);
+
+      /**
+       * Advance one step and return the height of each
+       * tower above the effector, without the Z position.
+       */
+      static const abc_float_t& walk_next();
+    #endif
+
     /**
      * Move the planner to the current position from wherever it last moved
      * (or from wherever it has been told it is located).
@@ -233,6 +257,21 @@ class Delta_Mechanics : public Mechanics {
      */
     static void Set_clip_start_height();
 
+    #if ENABLED(DELTA_INCREMENTAL_TRANSFORM)
+      /**
+       * Compute exact radicand and differences at the current position
+       */
+      static void walk_sync();
+    #endif
+
+    #if DISABLED(AUTO_BED_LEVELING_UBL)
+      /**
+       * Number of lines needed to keep the tower
+       * positions within the segment tolerance.
+       */
+      static uint16_t tolerance_lines(const xyze_float_t &difference, const float cartesian_distance);
+    #endif
+
     #if ENABLED(DELTA_FAST_SQRT) && ENABLED(__AVR__)
       static float Q_rsqrt(float number);
     #endif
@@ -242,6 +242,26 @@
 #if DISABLED(N_ARC_CORRECTION)
   #error "DEPENDENCY ERROR: Missing setting N_ARC_CORRECTION."
 #endif
+#if ENABLED(ARC_SEGMENT_TOLERANCE)
+  #if DISABLED(MAX_MM_PER_ARC_SEGMENT)
+    #error "DEPENDENCY ERROR: Missing setting MAX_MM_PER_ARC_SEGMENT."
+  #elif ARC_SEGMENT_TOLERANCE <= 0
+    #error "DEPENDENCY ERROR: ARC_SEGMENT_TOLERANCE must be greater than 0."
+  #endif
+#endif
+#if ENABLED(ARC_STEPPER_BLOCKS)
+  #if DISABLED(ARC_SUPPORT)
+    #error "DEPENDENCY ERROR: ARC_STEPPER_BLOCKS requires ARC_SUPPORT."
+  #elif ENABLED(__AVR__)
+    #error "DEPENDENCY ERROR: ARC_STEPPER_BLOCKS requires a 32 bit board."
+  #elif IS_KINEMATIC || (IS_CORE && !CORE_IS_XY)
+    #error "DEPENDENCY ERROR: ARC_STEPPER_BLOCKS supports only Cartesian and CoreXY / CoreYX."
+  #elif CORE_IS_XY && CORE_FACTOR != 1
+    #error "DEPENDENCY ERROR: ARC_STEPPER_BLOCKS requires CORE_FACTOR 1."
+  #elif ENABLED(HYSTERESIS_FEATURE)
+    #error "DEPENDENCY ERROR: ARC_STEPPER_BLOCKS is not compatible with HYSTERESIS_FEATURE."
+  #endif
+#endif
 #if DISABLED(DEFAULT_AXIS_STEPS_PER_UNIT)
   #error "DEPENDENCY ERROR: Missing setting DEFAULT_AXIS_STEPS_PER_UNIT."
 #endif
@@ -395,6 +415,16 @@
   #if DISABLED(DELTA_DIAGONAL_ROD)
     #error "DEPENDENCY ERROR: Missing setting DELTA_DIAGONAL_ROD."
   #endif
+  #if ENABLED(DELTA_INCREMENTAL_TRANSFORM)
+    #if ENABLED(AUTO_BED_LEVELING_UBL)
+      #error "DEPENDENCY ERROR: DELTA_INCREMENTAL_TRANSFORM is not compatible with AUTO_BED_LEVELING_UBL."
+    #elif DISABLED(DELTA_INCREMENTAL_RESYNC)
+      #error "DEPENDENCY ERROR: Missing setting DELTA_INCREMENTAL_RESYNC."
+    #endif
+  #endif
+  #if DISABLED(DELTA_SEGMENT_TOLERANCE)
+    #error "DEPENDENCY ERROR: Missing setting DELTA_SEGMENT_TOLERANCE."
+  #endif
   #if DISABLED(DELTA_SMOOTH_ROD_OFFSET)
     #error "DEPENDENCY ERROR: Missing setting DELTA_SMOOTH_ROD_OFFSET."
   #endif
@@ -532,4 +562,18 @@
     #error "DEPENDENCY ERROR: BABYSTEPPING is not implemented for SCARA yet."
   #endif
 
+  /**
+   * IK table
+   */
+  #if ENABLED(SCARA_IK_TABLE)
+    #if DISABLED(SCARA_IK_TABLE_SIZE) || DISABLED(SCARA_IK_TABLE_LIMIT) || DISABLED(SCARA_IK_SEGMENT_MM)
+      #error "DEPENDENCY ERROR: Missing setting SCARA_IK_TABLE_SIZE, SCARA_IK_TABLE_LIMIT or SCARA_IK_SEGMENT_MM."
+    #elif SCARA_IK_TABLE_SIZE < 8
+      #error "DEPENDENCY ERROR: SCARA_IK_TABLE_SIZE must be at least 8."
+    #endif
+    static_assert(SCARA_IK_TABLE_LIMIT >= 0.1 && SCARA_IK_TABLE_LIMIT <= 0.98, "SCARA_IK_TABLE_LIMIT must be between 0.1 and 0.98.");
+    // The end points of the table are one step beyond the limit
+    static_assert(SCARA_IK_TABLE_LIMIT * (SCARA_IK_TABLE_SIZE - 1) < (SCARA_IK_TABLE_SIZE - 3), "SCARA_IK_TABLE_LIMIT is too high for SCARA_IK_TABLE_SIZE.");
+  #endif
+
 #endif // IS_SCARA
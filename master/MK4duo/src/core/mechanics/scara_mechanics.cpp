@@ -43,6 +43,14 @@ const float Scara_Mechanics::L1                   = SCARA_LINKAGE_1,
 
 float Scara_Mechanics::delta[ABC]                 = { 0.0 };
 
+/** Private Parameters */
+#if ENABLED(SCARA_IK_TABLE)
+  float Scara_Mechanics::ik_theta[SCARA_IK_TABLE_SIZE]  = { 0.0 },
+        Scara_Mechanics::ik_psi[SCARA_IK_TABLE_SIZE]    = { 0.0 },
+        Scara_Mechanics::ik_c2_start                    = 0.0,
+        Scara_Mechanics::ik_inv_step                    = 0.0;
+#endif
+
 /** Public Function */
 void Scara_Mechanics::factory_parameters() {
 
@@ -169,8 +177,12 @@ void Scara_Mechanics::get_cartesian_from_steppers() {
     // gives the number of segments we should produce
     uint16_t segments = data.segments_per_second * seconds;
 
-    // For SCARA minimum segment size is 0.5mm
-    NOMORE(segments, cartesian_mm * 2);
+    // For SCARA minimum segment size is 0.5mm, shorter with the IK table
+    #if ENABLED(SCARA_IK_TABLE)
+      NOMORE(segments, cartesian_mm * (1.0f / (SCARA_IK_SEGMENT_MM)));
+    #else
+      NOMORE(segments, cartesian_mm * 2);
+    #endif
 
     // At least one segment is required
     NOLESS(segments, 1U);
@@ -207,6 +219,14 @@ void Scara_Mechanics::get_cartesian_from_steppers() {
             oldB = planner.position_float[B_AXIS];
     #endif
 
+    #if ENABLED(KINEMATIC_SEGMENT_FEEDER)
+
+      // Lines are sent to the planner as it empties
+      feeder.add(position, destination, segments, _feedrate_mm_s, toolManager.extruder.active, cartesian_segment_mm);
+      return false; // caller will update position.x
+
+    #endif
+
     // Get the current position as starting point
     float raw[XYZE];
     COPY_ARRAY(raw, position.x);
@@ -350,6 +370,21 @@ void Scara_Mechanics::Transform(const float raw[XYZ]) {
   else
     C2 = (HYPOT2(sx, sy) - (L1_2 + L2_2)) / (2.0f * L1 * L2);
 
+  #if ENABLED(SCARA_IK_TABLE)
+
+    // Both angles from the Center-to-End line depend only on C2
+    const float t = (C2 - ik_c2_start) * ik_inv_step;
+
+    if (WITHIN(t, 1.0f, SCARA_IK_TABLE_SIZE - 2.0f)) {
+      const uint16_t i = MIN(uint16_t(t), SCARA_IK_TABLE_SIZE - 3);
+      const float   f = t - i;
+      THETA = ik_interpolate(ik_theta, i, f) - ATAN2(sx, sy);
+      PSI   = ik_interpolate(ik_psi, i, f);
+    }
+    else {
+
+  #endif
+
   S2 = SQRT(1 - sq(C2));
 
   // Unrotated Arm1 plus rotated Arm2 gives the distance from Center to End
@@ -364,12 +399,38 @@ void Scara_Mechanics::Transform(const float raw[XYZ]) {
   // Angle of Arm2
   PSI = ATAN2(S2, C2);
 
+  #if ENABLED(SCARA_IK_TABLE)
+    }
+  #endif
+
   delta[A_AXIS] = DEGREES(THETA);        // theta is support arm angle
   delta[B_AXIS] = DEGREES(THETA + PSI);  // equal to sub arm angle (inverted motor)
   delta[C_AXIS] = raw[Z_AXIS];
 
 }
 
+/**
+ * SCARA IK table.
+ *
+ * For an elbow cosine C2 the Arm1 angle from the Center-to-End line
+ * and the Arm2 angle are the same at any angle around the tower.
+ * The table covers C2 from -SCARA_IK_TABLE_LIMIT to SCARA_IK_TABLE_LIMIT
+ * with one more point at each end for the spline.
+ */
+void Scara_Mechanics::recalc_scara_settings() {
+  #if ENABLED(SCARA_IK_TABLE)
+    const float step = 2.0f * (SCARA_IK_TABLE_LIMIT) / float(SCARA_IK_TABLE_SIZE - 3);
+    ik_c2_start = -(SCARA_IK_TABLE_LIMIT) - step;
+    ik_inv_step = 1.0f / step;
+    LOOP_L_N(i, SCARA_IK_TABLE_SIZE) {
+      const float C2 = ik_c2_start + i * step,
+                  S2 = SQRT(1 - sq(C2));
+      ik_theta[i] = ATAN2(L1 + L2 * C2, L2 * S2);
+      ik_psi[i]   = ATAN2(S2, C2);
+    }
+  #endif
+}
+
 #if MECH(MORGAN_SCARA)
   bool Scara_Mechanics::move_to_cal(uint8_t delta_a, uint8_t delta_b) {
     if (printer.isRunning()) {
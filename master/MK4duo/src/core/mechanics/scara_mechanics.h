@@ -55,6 +55,15 @@ class Scara_Mechanics : public Mechanics {
 
     static float  delta[ABC];
 
+  private: /** Private Parameters */
+
+    #if ENABLED(SCARA_IK_TABLE)
+      static float  ik_theta[SCARA_IK_TABLE_SIZE],  // Arm1 angle from the Center-to-End line
+                    ik_psi[SCARA_IK_TABLE_SIZE],    // Arm2 angle from Arm1
+                    ik_c2_start,                    // Elbow cosine of the first point
+                    ik_inv_step;                    // Points per unit of elbow cosine
+    #endif
+
   public: /** Public Function */
 
     /**
@@ -107,6 +116,11 @@ class Scara_Mechanics : public Mechanics {
     static void InverseTransform(const float point[XYZ], float cartesian[XYZ]) { InverseTransform(point[X_AXIS], point[Y_AXIS], cartesian); }
     static void Transform(const float raw[XYZ]);
 
+    /**
+     * Build the IK table from the arm geometry
+     */
+    static void recalc_scara_settings();
+
     /**
      * MORGAN SCARA function
      */
@@ -171,6 +185,16 @@ class Scara_Mechanics : public Mechanics {
      */
     static void homeaxis(const AxisEnum axis);
 
+    #if ENABLED(SCARA_IK_TABLE)
+      /**
+       * Catmull-Rom interpolation between table points i and i + 1
+       */
+      FORCE_INLINE static float ik_interpolate(const float table[], const uint16_t i, const float f) {
+        const float p0 = table[i - 1], p1 = table[i], p2 = table[i + 1], p3 = table[i + 2];
+        return p1 + 0.5f * f * (p2 - p0 + f * (2.0f * p0 - 5.0f * p1 + 4.0f * p2 - p3 + f * (3.0f * (p1 - p2) + p3 - p0)));
+      }
+    #endif
+
 };
 
 extern Scara_Mechanics mechanics;
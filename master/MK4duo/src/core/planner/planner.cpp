@@ -105,6 +105,10 @@ float Planner::previous_nominal_speed_sqr = 0.0;
 
 uint32_t Planner::cutoff_long = 0;
 
+#if ENABLED(ARC_STEPPER_BLOCKS)
+  const arc_plan_t* Planner::arc_plan = nullptr;
+#endif
+
 #if ENABLED(DISABLE_INACTIVE_EXTRUDER)
   uint8_t Planner::g_uc_extruder_last_move[MAX_EXTRUDER] = { 0 };
 #endif
@@ -809,6 +813,11 @@ void Planner::quick_stop() {
   // Drop all queue entries
   block_buffer_nonbusy = block_buffer_planned = block_buffer_head = block_buffer_tail;
 
+  #if ENABLED(KINEMATIC_SEGMENT_FEEDER)
+    // And the moves not yet split in lines
+    feeder.clear();
+  #endif
+
   // And restart the block delay for the first movement - As the queue was
   // forced to empty, there is no risk the ISR could touch this variable.
   delay_before_delivering = BLOCK_DELAY_FOR_1ST_MOVE;
@@ -875,6 +884,9 @@ float Planner::get_axis_position_mm(const AxisEnum axis) {
 }
 
 void Planner::synchronize() {
+  #if ENABLED(KINEMATIC_SEGMENT_FEEDER)
+    feeder.flush();
+  #endif
   while (has_blocks_queued() || flag.clean_buffer) {
     printer.idle();
     PRINTER_KEEPALIVE(InProcess);
@@ -1151,6 +1163,11 @@ bool Planner::fill_block(block_t * const block, bool split_move,
   // Bail if this is a zero-length block
   if (printer.mode == PRINTER_MODE_FFF && block->step_event_count < MIN_STEPS_PER_SEGMENT) return false;
 
+  #if ENABLED(ARC_STEPPER_BLOCKS)
+    // Enough events along the arc to move each motor at most one step per event
+    if (arc_plan) NOLESS(block->step_event_count, arc_plan->events);
+  #endif
+
   // For a mixing extruder, get a magnified step_event_count for each
   #if ENABLED(COLOR_MIXING_EXTRUDER)
     mixer.populate_block(block->b_color);
@@ -1459,6 +1476,18 @@ bool Planner::fill_block(block_t * const block, bool split_move,
     block->nominal_speed_sqr = block->nominal_speed_sqr * sq(speed_factor);
   }
 
+  #if ENABLED(ARC_STEPPER_BLOCKS)
+    // An arc enters along the entry tangent and leaves along the exit tangent
+    xyze_float_t exit_speed = current_speed;
+    if (arc_plan) {
+      const float xy_speed = HYPOT(current_speed.x, current_speed.y);
+      current_speed.x = arc_plan->entry_tangent.x * xy_speed;
+      current_speed.y = arc_plan->entry_tangent.y * xy_speed;
+      exit_speed.x    = arc_plan->exit_tangent.x * xy_speed;
+      exit_speed.y    = arc_plan->exit_tangent.y * xy_speed;
+    }
+  #endif
+
   // Compute and limit the acceleration rate for the trapezoid generator.
   const float steps_per_mm = block->step_event_count * inverse_millimeters;
   uint32_t accel;
@@ -1583,6 +1612,18 @@ bool Planner::fill_block(block_t * const block, bool split_move,
         unit_vec *= inverse_millimeters;      // Use pre-calculated (1 / SQRT(x^2 + y^2 + z^2))
     #endif
 
+    #if ENABLED(ARC_STEPPER_BLOCKS)
+      // Junctions of an arc are along its tangents, not along its chord
+      xyze_float_t exit_unit_vec = unit_vec;
+      if (arc_plan) {
+        const float xy = HYPOT(unit_vec.x, unit_vec.y);
+        unit_vec.x      = arc_plan->entry_tangent.x * xy;
+        unit_vec.y      = arc_plan->entry_tangent.y * xy;
+        exit_unit_vec.x = arc_plan->exit_tangent.x * xy;
+        exit_unit_vec.y = arc_plan->exit_tangent.y * xy;
+      }
+    #endif
+
     // Skip first block or when previous_nominal_speed is used as a flag for homing and offset cycles.
     if (moves_queued && !UNEAR_ZERO(previous_nominal_speed_sqr)) {
       // Compute cosine of angle between previous and current path. (prev_unit_vec is negative)
@@ -1668,7 +1709,11 @@ bool Planner::fill_block(block_t * const block, bool split_move,
     else // Init entry speed to zero. Assume it starts from rest. Planner will correct this later.
       vmax_junction_sqr = 0;
 
-    previous_unit_vec = unit_vec;
+    #if ENABLED(ARC_STEPPER_BLOCKS)
+      previous_unit_vec = exit_unit_vec;
+    #else
+      previous_unit_vec = unit_vec;
+    #endif
 
   #endif // HAS_JUNCTION_DEVIATION
 
@@ -1789,7 +1834,11 @@ bool Planner::fill_block(block_t * const block, bool split_move,
   block->flag |= block->nominal_speed_sqr <= v_allowable_sqr ? BLOCK_FLAG_RECALCULATE | BLOCK_FLAG_NOMINAL_LENGTH : BLOCK_FLAG_RECALCULATE;
 
   // Update previous path unit_vector and nominal speed
-  previous_speed = current_speed;
+  #if ENABLED(ARC_STEPPER_BLOCKS)
+    previous_speed = exit_speed;
+  #else
+    previous_speed = current_speed;
+  #endif
   previous_nominal_speed_sqr = block->nominal_speed_sqr;
 
   // Update the position
@@ -1816,6 +1865,12 @@ bool Planner::fill_block(block_t * const block, bool split_move,
  * Add a block to the buffer that just updates the position
  */
 void Planner::buffer_sync_block() {
+
+  #if ENABLED(KINEMATIC_SEGMENT_FEEDER)
+    // Queued moves go first
+    feeder.flush();
+  #endif
+
   // Wait for the next available block
   uint8_t next_buffer_head;
   block_t * const block = get_next_free_block(next_buffer_head);
@@ -1864,6 +1919,11 @@ bool Planner::buffer_segment(const float &a, const float &b, const float &c, con
   // If we are cleaning, do not accept queuing of movements
   if (flag.clean_buffer) return false;
 
+  #if ENABLED(KINEMATIC_SEGMENT_FEEDER)
+    // Queued moves go first
+    feeder.flush();
+  #endif
+
   // The target position of the tool in absolute steps
   // Calculate target position in absolute steps
   const abce_long_t target = {
@@ -1997,6 +2057,164 @@ bool Planner::buffer_line(const float &rx, const float &ry, const float &rz, con
 
 }
 
+#if ENABLED(DELTA_INCREMENTAL_TRANSFORM)
+
+  /**
+   * Add a new linear movement to the buffer for a delta.
+   * Leveling and retract only change Z and E here, so the
+   * tower heights of the cartesian XY position can be used.
+   */
+  bool Planner::buffer_delta_line(const xyze_pos_t &cart, const abc_float_t &heights, const feedrate_t &fr_mm_s, const uint8_t extruder, const float millimeters/*=0.0*/) {
+
+    xyze_pos_t raw = cart;
+    #if HAS_POSITION_MODIFIERS
+      apply_modifiers(raw);
+    #endif
+
+    #if HAS_JUNCTION_DEVIATION
+      const xyze_pos_t cart_dist_mm = cart - position_cart;
+    #endif
+
+    float mm = millimeters;
+    if (mm == 0.0) {
+      const xyz_pos_t cart_dist = cart - position_cart;
+      mm = (cart_dist.x != 0.0 || cart_dist.y != 0.0) ? cart_dist.magnitude() : ABS(cart_dist.z);
+    }
+
+    if (buffer_segment(raw.z + heights.a, raw.z + heights.b, raw.z + heights.c, raw.e
+      #if HAS_JUNCTION_DEVIATION
+        , cart_dist_mm
+      #endif
+      , fr_mm_s, extruder, mm
+    )) {
+      position_cart = cart;
+      return true;
+    }
+    else
+      return false;
+
+  }
+
+#endif
+
+#if ENABLED(ARC_STEPPER_BLOCKS)
+
+  /**
+   * Add a new arc to the buffer as one block. The stepper rotates the start
+   * vector around the center once per step event with an integer rotation,
+   * so X and Y stay on the circle at any speed.
+   */
+  bool Planner::buffer_arc(const xyze_pos_t &cart, const xy_pos_t &center, feedrate_t fr_mm_s, const uint8_t extruder, const float &millimeters) {
+
+    // If we are cleaning, do not accept queuing of movements
+    if (flag.clean_buffer) return false;
+
+    xyze_pos_t raw = cart;
+    #if HAS_POSITION_MODIFIERS
+      apply_modifiers(raw);
+    #endif
+
+    const float spm = mechanics.data.axis_steps_per_mm.x; // Same as Y
+
+    // Center in whole steps and the rest in 1/4096 step
+    const float cx = center.x * spm, cy = center.y * spm;
+    const int32_t icx = LROUND(cx), icy = LROUND(cy);
+    const xy_long_t frac = { int32_t(LROUND((cx - icx) * 4096.0f)), int32_t(LROUND((cy - icy) * 4096.0f)) };
+
+    // Start from where the planner really is, rotate up to the target
+    const int32_t u0 = (position.x - icx) * 4096 - frac.x,
+                  v0 = (position.y - icy) * 4096 - frac.y;
+    const float u1 = raw.x * spm - cx,
+                v1 = raw.y * spm - cy,
+                angle = ATAN2(float(u0) * v1 - float(v0) * u1, float(u0) * u1 + float(v0) * v1),
+                radius = HYPOT(float(u0), float(v0)) * (1.0f / 4096.0f);
+
+    // Motors A and B of a CoreXY move up to SQRT(2) steps for a step along the arc
+    #if CORE_IS_XY
+      constexpr float motor_steps = 1.41421356f;
+    #else
+      constexpr float motor_steps = 1.0f;
+    #endif
+
+    arc_plan_t arc;
+    arc.events = CEIL(ABS(angle) * radius * motor_steps) + 1;
+
+    // Unit tangents at both ends
+    const float sense = angle < 0 ? -1.0f : 1.0f,
+                r0 = sense / HYPOT(float(u0), float(v0)),
+                r1 = sense / HYPOT(u1, v1);
+    arc.entry_tangent.set(-v0 * r0, u0 * r0);
+    arc.exit_tangent.set(-v1 * r1, u1 * r1);
+    #if CORE_IS_XY
+      arc.entry_tangent.set((arc.entry_tangent.x + arc.entry_tangent.y) * 0.70710678f, CORESIGN(arc.entry_tangent.x - arc.entry_tangent.y) * 0.70710678f);
+      arc.exit_tangent.set((arc.exit_tangent.x + arc.exit_tangent.y) * 0.70710678f, CORESIGN(arc.exit_tangent.x - arc.exit_tangent.y) * 0.70710678f);
+    #endif
+
+    // Keep the centripetal acceleration within the acceleration
+    NOMORE(fr_mm_s, SQRT(mechanics.data.acceleration * radius / spm));
+
+    const abce_long_t target = {
+      static_cast<int32_t>(FLOOR(raw.x * spm + 0.5f)),
+      static_cast<int32_t>(FLOOR(raw.y * spm + 0.5f)),
+      static_cast<int32_t>(FLOOR(raw.z * mechanics.data.axis_steps_per_mm.z + 0.5f)),
+      static_cast<int32_t>(FLOOR(raw.e * extruders[extruder]->data.axis_steps_per_mm + 0.5f))
+    };
+
+    // DRYRUN or Simulation prevents E moves from taking place
+    if (printer.debugDryrun() || printer.debugSimulation()) {
+      position.e = target.e;
+      #if HAS_POSITION_FLOAT
+        position_float.e = raw.e;
+      #endif
+    }
+
+    // Simulation Mode no movement
+    if (printer.debugSimulation()) position = target;
+
+    // Wait for the next available block
+    uint8_t next_buffer_head;
+    block_t * const block = get_next_free_block(next_buffer_head);
+
+    arc_plan = &arc;
+    const bool filled = fill_block(block, false, target
+      #if HAS_POSITION_FLOAT
+        , raw
+      #endif
+      , fr_mm_s, extruder, millimeters
+    );
+    arc_plan = nullptr;
+
+    // Movement too short, accept it as queued and done
+    if (!filled) return true;
+
+    // Rotation of one step event, the versine keeps the precision of small angles
+    const float phi = angle / block->step_event_count;
+    block->arc_u        = u0;
+    block->arc_v        = v0;
+    block->arc_sin      = LROUND(SIN(phi) * 2147483648.0f);
+    block->arc_vers     = uint32_t(2.0f * sq(SIN(0.5f * phi)) * 4294967296.0f + 0.5f);
+    #if CORE_IS_XY
+      block->arc_fraction.set(frac.x + frac.y, CORESIGN(frac.x - frac.y));
+    #else
+      block->arc_fraction = frac;
+    #endif
+    block->flag |= BLOCK_FLAG_ARC;
+
+    // If this is the first added movement, reload the delay, otherwise, cancel it.
+    if (block_buffer_head == block_buffer_tail) delay_before_delivering = BLOCK_DELAY_FOR_1ST_MOVE;
+
+    // Move buffer head
+    block_buffer_head = next_buffer_head;
+
+    // Recalculate and optimize trapezoidal speed profiles
+    recalculate();
+
+    stepper.wake_up();
+    return true;
+  }
+
+#endif // ARC_STEPPER_BLOCKS
+
 /**
  * Directly set the planner ABC position (and stepper positions)
  * converting mm (or angles for SCARA) into steps.
@@ -2005,6 +2223,11 @@ bool Planner::buffer_line(const float &rx, const float &ry, const float &rz, con
  */
 void Planner::set_machine_position_mm(const float &a, const float &b, const float &c, const float &e) {
 
+  #if ENABLED(KINEMATIC_SEGMENT_FEEDER)
+    // Queued moves are in the old coordinates
+    feeder.flush();
+  #endif
+
   position.set( static_cast<int32_t>(FLOOR(a * mechanics.data.axis_steps_per_mm.a + 0.5f)),
                 static_cast<int32_t>(FLOOR(b * mechanics.data.axis_steps_per_mm.b + 0.5f)),
                 static_cast<int32_t>(FLOOR(c * mechanics.data.axis_steps_per_mm.c + 0.5f)),
@@ -2026,6 +2249,11 @@ void Planner::set_machine_position_mm(const float &a, const float &b, const floa
 
 void Planner::set_position_mm(const float &rx, const float &ry, const float &rz, const float &e) {
 
+  #if ENABLED(KINEMATIC_SEGMENT_FEEDER)
+    // Queued moves are in the old coordinates
+    feeder.flush();
+  #endif
+
   xyze_pos_t raw = { rx, ry, rz, e };
 
   #if HAS_POSITION_MODIFIERS
@@ -2043,6 +2271,11 @@ void Planner::set_position_mm(const float &rx, const float &ry, const float &rz,
 
 void Planner::set_e_position_mm(const float &e) {
 
+  #if ENABLED(KINEMATIC_SEGMENT_FEEDER)
+    // Queued moves are in the old coordinates
+    feeder.flush();
+  #endif
+
   #if ENABLED(FWRETRACT)
     float e_new = e - fwretract.current_retract[toolManager.extruder.active];
   #else
@@ -45,6 +45,21 @@ union plan_flag_t {
   plan_flag_t() { all = 0x00; }
 };
 
+#if ENABLED(ARC_STEPPER_BLOCKS)
+  /**
+   * struct arc_plan_t
+   *
+   * Data handed from Planner::buffer_arc to Planner::fill_block.
+   * Tangents are unit vectors in the XY space of the planner
+   * steps (motor A B on CoreXY).
+   */
+  struct arc_plan_t {
+    uint32_t    events;       // Step events to travel the arc
+    xy_float_t  entry_tangent,
+                exit_tangent;
+  };
+#endif
+
 /**
  * struct block_t
  *
@@ -94,6 +109,13 @@ typedef struct block_t {
 
   uint8_t direction_bits;                   // The direction bit set for this block
 
+  #if ENABLED(ARC_STEPPER_BLOCKS)
+    int32_t   arc_u, arc_v,                 // Start from the arc center in 1/4096 step
+              arc_sin;                      // Sine of the rotation of one step event in 1/2^31
+    uint32_t  arc_vers;                     // Versine of the rotation of one step event in 1/2^32
+    xy_long_t arc_fraction;                 // Motor position of the center below one step in 1/4096 step
+  #endif
+
   // Advance extrusion
   #if ENABLED(LIN_ADVANCE)
     bool      use_advance_lead;
@@ -204,6 +226,13 @@ class Planner {
      */
     static uint32_t cutoff_long;
 
+    #if ENABLED(ARC_STEPPER_BLOCKS)
+      /**
+       * Arc of the block being filled, if any
+       */
+      static const arc_plan_t *arc_plan;
+    #endif
+
     #if ENABLED(DISABLE_INACTIVE_EXTRUDER)
       /**
        * Counters to manage disabling inactive extruders
@@ -396,6 +425,40 @@ class Planner {
       );
     }
 
+    #if ENABLED(DELTA_INCREMENTAL_TRANSFORM)
+      /**
+       * Planner::buffer_delta_line
+       *
+       * Add a new linear movement to the buffer for a delta, with the
+       * height of each tower above the effector already computed.
+       *
+       *  cart        - target cartesian position in mm
+       *  heights     - tower heights above the effector, without Z
+       *  fr_mm_s     - (target) speed of the move (mm/s)
+       *  extruder    - target extruder
+       *  millimeters - the length of the movement, if known
+       */
+      static bool buffer_delta_line(const xyze_pos_t &cart, const abc_float_t &heights, const feedrate_t &fr_mm_s, const uint8_t extruder, const float millimeters=0.0);
+    #endif
+
+    #if ENABLED(ARC_STEPPER_BLOCKS)
+      /**
+       * Planner::buffer_arc
+       *
+       * Add a new XY arc of 45° or less to the buffer as a single block.
+       * The stepper rotates X and Y around the center, Z and E are linear.
+       * The arc must not cross a multiple of 45°, so every motor keeps
+       * one direction. Leveling must be off.
+       *
+       *  cart        - target cartesian position in mm
+       *  center      - center of the arc in mm
+       *  fr_mm_s     - (target) speed of the move (mm/s)
+       *  extruder    - target extruder
+       *  millimeters - the length of the arc
+       */
+      static bool buffer_arc(const xyze_pos_t &cart, const xy_pos_t &center, feedrate_t fr_mm_s, const uint8_t extruder, const float &millimeters);
+    #endif
+
     /**
      * Set the planner.position and individual stepper positions.
      * Used by G92, G28, G29, and other procedures.
@@ -387,6 +387,14 @@ void Printer::idle(const bool no_stepper_sleep/*=false*/) {
     card.manage_sd();
   #endif
 
+  #if ENABLED(SD_DOUBLE_BUFFER)
+    card.read_ahead();
+  #endif
+
+  #if ENABLED(SDCARD_SORT_ALPHA)
+    card.presort_step();
+  #endif
+
   lcdui.update();
 
   #if HAS_POWER_CHECK
@@ -402,6 +410,10 @@ void Printer::idle(const bool no_stepper_sleep/*=false*/) {
 
   commands.get_available();
 
+  #if ENABLED(KINEMATIC_SEGMENT_FEEDER)
+    feeder.feed();
+  #endif
+
   handle_safety_watch();
 
   if (max_inactivity_timer.expired(SECOND_TO_MILLIS(max_inactive_time))) {
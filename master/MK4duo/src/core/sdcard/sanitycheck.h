@@ -36,8 +36,33 @@
   #if DISABLED(SD_FINISHED_RELEASECOMMAND)
     #error "DEPENDENCY ERROR: Missing setting SD_FINISHED_RELEASECOMMAND."
   #endif
+  #if ENABLED(SD_DOUBLE_BUFFER)
+    #if DISABLED(SD_READ_BUFFER_SIZE)
+      #error "DEPENDENCY ERROR: Missing setting SD_READ_BUFFER_SIZE."
+    #elif SD_READ_BUFFER_SIZE < 512 || SD_READ_BUFFER_SIZE > 16384 || (SD_READ_BUFFER_SIZE % 512)
+      #error "DEPENDENCY ERROR: SD_READ_BUFFER_SIZE must be a multiple of 512 up to 16384."
+    #endif
+  #endif
+  #if ENABLED(SD_WRITE_PREALLOCATE) && SD_WRITE_PREALLOCATE < 512
+    #error "DEPENDENCY ERROR: SD_WRITE_PREALLOCATE must be at least 512."
+  #endif
+  #if ENABLED(SD_PREFETCH_QUEUE)
+    #if DISABLED(SD_PREFETCH_SIZE)
+      #error "DEPENDENCY ERROR: Missing setting SD_PREFETCH_SIZE."
+    #elif SD_PREFETCH_SIZE < 2 * (MAX_CMD_SIZE + 4) || SD_PREFETCH_SIZE > 65535
+      #error "DEPENDENCY ERROR: SD_PREFETCH_SIZE must be at least 2 x (MAX_CMD_SIZE + 4) and at most 65535."
+    #endif
+  #endif
 #elif ENABLED(EEPROM_SETTINGS) && ENABLED(EEPROM_SD)
   #error "DEPENDENCY ERROR: You have to enable SDSUPPORT || USB_FLASH_DRIVE_SUPPORT to use EEPROM_SD."
+#elif ENABLED(SD_PREFETCH_QUEUE)
+  #error "DEPENDENCY ERROR: You have to enable SDSUPPORT || USB_FLASH_DRIVE_SUPPORT to use SD_PREFETCH_QUEUE."
+#elif ENABLED(SD_BINARY_UPLOAD)
+  #error "DEPENDENCY ERROR: You have to enable SDSUPPORT || USB_FLASH_DRIVE_SUPPORT to use SD_BINARY_UPLOAD."
+#endif
+
+#if ENABLED(SD_METADATA_INDEX) && (!HAS_SD_SUPPORT || DISABLED(JSON_OUTPUT))
+  #error "DEPENDENCY ERROR: SD_METADATA_INDEX requires SDSUPPORT and JSON_OUTPUT."
 #endif
 
 #if DISABLED(SDSUPPORT) && ENABLED(SERIAL_STATS_MAX_RX_QUEUED)
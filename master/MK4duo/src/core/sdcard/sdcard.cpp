@@ -41,6 +41,8 @@ int SDCard::autostart_index = -1;
 uint32_t  SDCard::fileSize  = 0,
           SDCard::sdpos     = 0;
 
+uint8_t   SDCard::seek_count = 0;
+
 float SDCard::objectHeight      = 0.0,
       SDCard::firstlayerHeight  = 0.0,
       SDCard::layerHeight       = 0.0,
@@ -54,7 +56,37 @@ char  SDCard::fileName[LONG_FILENAME_LENGTH*SD_MAX_FOLDER_DEPTH+SD_MAX_FOLDER_DE
 uint16_t SDCard::nrFile_index = 0;
 
 #if HAS_EEPROM_SD
-  SdFile SDCard::eeprom_file;
+  SdFile    SDCard::eeprom_file;
+  uint32_t  SDCard::eeprom_block = 0;
+#endif
+
+#if ENABLED(GCZ_SUPPORT)
+  bool SDCard::compressed = false;
+#endif
+
+#if ENABLED(SD_METADATA_INDEX)
+  SdFile SDCard::meta_file;
+#endif
+
+#if ENABLED(SD_DOUBLE_BUFFER)
+  uint8_t   SDCard::read_buffer[2][SD_READ_BUFFER_SIZE];
+  uint16_t  SDCard::read_count[2]   = { 0 },
+            SDCard::read_index      = 0;
+  uint8_t   SDCard::read_active     = 0;
+  uint32_t  SDCard::read_base       = 0;
+#endif
+
+#if ENABLED(SD_BINARY_UPLOAD)
+  uint8_t       SDCard::upload_buffer[UPLOAD_FRAME_SIZE + 2];
+  char          SDCard::upload_name[MAX_PATH_NAME_LENGHT];
+  uint32_t      SDCard::upload_block    = 0;
+  uint16_t      SDCard::upload_index    = 0;
+  uint32_t      SDCard::upload_size     = 0,
+                SDCard::upload_done     = 0;
+  int8_t        SDCard::upload_port     = -1;
+  uint8_t       SDCard::upload_retry    = 0;
+  bool          SDCard::upload_discard  = false;
+  short_timer_t SDCard::upload_timer;
 #endif
 
 uint16_t  SDCard::workDirDepth  = 0,
@@ -64,7 +96,14 @@ LsActionEnum SDCard::lsAction   = LS_Count;
 
 // Sort files and folders alphabetically.
 #if ENABLED(SDCARD_SORT_ALPHA)
-  uint16_t SDCard::sort_count = 0;
+  uint16_t SDCard::sort_count = 0,
+           SDCard::sort_total = 0,
+           SDCard::sort_width = 0,
+           SDCard::sort_lo    = 0,
+           SDCard::sort_i     = 0,
+           SDCard::sort_j     = 0,
+           SDCard::sort_k     = 0,
+           SDCard::lsReads    = 0;
   #if ENABLED(SDSORT_GCODE)
     bool  SDCard::sort_alpha    = true;
     int   SDCard::sort_folders  = FOLDER_SORTING;
@@ -73,9 +112,13 @@ LsActionEnum SDCard::lsAction   = LS_Count;
 
   // By default the sort index is static
   #if ENABLED(SDSORT_DYNAMIC_RAM)
-    uint8_t *SDCard::sort_order;
+    uint8_t *SDCard::sort_order, *SDCard::sort_merge;
   #else
-    uint8_t SDCard::sort_order[SDSORT_LIMIT];
+    uint8_t SDCard::sort_order[SDSORT_LIMIT], SDCard::sort_merge[SDSORT_LIMIT];
+  #endif
+
+  #if ENABLED(SDSORT_NAMES_IN_RAM)
+    SdFile SDCard::sort_dir;
   #endif
 
   // Cache filenames to speed up SD menus.
@@ -179,6 +222,7 @@ void SDCard::mount() {
   flag.WorkdirIsRoot = true;
 
   #if HAS_EEPROM_SD
+    eeprom_block = 0;
     import_eeprom();
   #endif
 
@@ -190,6 +234,7 @@ void SDCard::mount() {
 void SDCard::unmount() {
   setMounted(false);
   endFilePrint();
+  forget_contiguous();
 }
 
 void SDCard::ls() {
@@ -284,11 +329,17 @@ void SDCard::startFilePrint() {
     #if ENABLED(SDCARD_SORT_ALPHA)
       flush_presort();
     #endif
+    #if ENABLED(SD_LAYER_INDEX)
+      layerindex.start();
+    #endif
   }
 }
 
 void SDCard::endFilePrint() {
   setPrinting(false);
+  #if ENABLED(SD_LAYER_INDEX)
+    layerindex.close();
+  #endif
   if (isFileOpen()) gcode_file.close();
 }
 
@@ -324,7 +375,16 @@ void SDCard::startWrite(const char * const path, const bool silent/*=false*/) {
   if (!isMounted()) return;
 
   fat.chdir();
-  if (gcode_file.open(path, FILE_WRITE)) {
+
+  #if ENABLED(SD_WRITE_PREALLOCATE)
+    // A new file gets its clusters up front, M29 trims it to the size written
+    const bool opened = (!fat.exists(path) && open_contiguous(gcode_file, path, SD_WRITE_PREALLOCATE))
+                     || gcode_file.open(path, FILE_WRITE);
+  #else
+    const bool opened = gcode_file.open(path, FILE_WRITE);
+  #endif
+
+  if (opened) {
     setSaving(true);
     #if ENABLED(EMERGENCY_PARSER)
       emergency_parser.disable();
@@ -342,10 +402,12 @@ void SDCard::deleteFile(const char * const path) {
   endFilePrint();
   gcode_file.close();
   if (fat.remove(path)) {
+    forget_contiguous();
     SERIAL_EMT(STR_SD_FILE_DELETED, path);
   }
   else {
     if (fat.rmdir(path)) {
+      forget_contiguous();
       SERIAL_EMT(STR_SD_FILE_DELETED, path);
       sdpos = 0;
       #if ENABLED(SDCARD_SORT_ALPHA)
@@ -358,12 +420,161 @@ void SDCard::deleteFile(const char * const path) {
 }
 
 void SDCard::finishWrite() {
+  #if ENABLED(SD_BINARY_UPLOAD)
+    if (isBinaryWrite()) return endBinaryWrite(upload_done >= upload_size);
+  #endif
+  #if ENABLED(SD_WRITE_PREALLOCATE)
+    gcode_file.truncate(gcode_file.curPosition());
+  #endif
   gcode_file.sync();
   gcode_file.close();
   setSaving(false);
   SERIAL_EM(STR_SD_FILE_SAVED);
 }
 
+#if ENABLED(SD_BINARY_UPLOAD)
+
+  /**
+   * Binary upload, M28 B<size> <file>
+   *
+   * Every byte from the upload port comes here instead of the G-code line
+   * parser. A frame is UPLOAD_FRAME_SIZE bytes (the last one may be shorter)
+   * plus its CRC-16/XMODEM, high byte first. The host sends the next frame
+   * only after the answer, so every write starts on a card block boundary.
+   * The data goes to UPLOAD_TEMP_NAME, M29 then puts it in place of the
+   * file, so a failed upload never touches an existing file.
+   */
+  void SDCard::startBinaryWrite(const char * const path, const uint32_t size, const int8_t port) {
+    if (!isMounted()) return;
+
+    if (!size || port < 0) {
+      openFailed(path);
+      return;
+    }
+
+    fat.chdir();
+    if (fat.exists(UPLOAD_TEMP_NAME)) fat.remove(UPLOAD_TEMP_NAME);
+
+    // Allocate all clusters up front and write the frames straight to the
+    // card blocks, fall back to a growing file if there is no free run.
+    upload_block = open_contiguous(gcode_file, UPLOAD_TEMP_NAME, size);
+    if (!upload_block && !gcode_file.open(UPLOAD_TEMP_NAME, FILE_WRITE)) {
+      openFailed(UPLOAD_TEMP_NAME);
+      return;
+    }
+
+    strncpy(upload_name, path, MAX_PATH_NAME_LENGHT - 1);
+    upload_name[MAX_PATH_NAME_LENGHT - 1] = '\0';
+    setSaving(true);
+
+    upload_size     = size;
+    upload_done     = 0;
+    upload_index    = 0;
+    upload_retry    = 0;
+    upload_discard  = false;
+    upload_port     = port;
+    upload_timer.start();
+
+    #if ENABLED(EMERGENCY_PARSER)
+      emergency_parser.disable();
+    #endif
+
+    SERIAL_EMT(STR_SD_WRITE_TO_FILE, path);
+    lcdui.set_status(path);
+  }
+
+  void SDCard::upload_byte(const uint8_t c) {
+
+    upload_timer.start();
+    if (upload_discard) return;
+
+    const uint16_t len = MIN(upload_size - upload_done, uint32_t(UPLOAD_FRAME_SIZE));
+    upload_buffer[upload_index++] = c;
+    if (upload_index < len + 2) return;
+    upload_index = 0;
+
+    uint16_t crc = 0;
+    crc16(&crc, upload_buffer, len);
+    if (crc != ((uint16_t(upload_buffer[len]) << 8) | upload_buffer[len + 1])) {
+      upload_discard = true;  // Ask again once the line is quiet
+      return;
+    }
+
+    SERIAL_PORT(upload_port);
+
+    if (upload_block ? !write_contiguous(upload_block, upload_done, upload_buffer, len)
+                     : gcode_file.write(upload_buffer, len) != int(len)
+    ) {
+      SERIAL_LM(ER, STR_SD_ERR_WRITE_TO_FILE);
+      endBinaryWrite(false);
+    }
+    else {
+      upload_done += len;
+      upload_retry = 0;
+      if (upload_done >= upload_size) {
+        gcode_file.sync();
+        upload_port = -1;   // All data in, back to G-code lines to wait for M29
+      }
+      SERIAL_STR(OK);
+      SERIAL_EOL();
+    }
+
+    SERIAL_PORT(-1);
+  }
+
+  /**
+   * A bad frame is asked again once the line is quiet, a partial one
+   * after UPLOAD_TIMEOUT_MS. Only these count as retries. A line with
+   * no frame in progress is given UPLOAD_IDLE_MS, then the upload is
+   * dropped.
+   */
+  void SDCard::check_upload() {
+
+    const bool partial = upload_discard || upload_index;
+
+    if (!upload_timer.expired(upload_discard ? UPLOAD_QUIET_MS : upload_index ? UPLOAD_TIMEOUT_MS : UPLOAD_IDLE_MS)) return;
+
+    SERIAL_PORT(upload_port);
+
+    if (!partial || ++upload_retry > UPLOAD_RETRY)
+      endBinaryWrite(false);
+    else {
+      upload_index = 0;
+      upload_discard = false;
+      SERIAL_LV(RESEND, upload_done / UPLOAD_FRAME_SIZE);
+    }
+
+    SERIAL_PORT(-1);
+  }
+
+  /**
+   * Put the received file in place of upload_name, or drop it
+   */
+  void SDCard::endBinaryWrite(const bool saved) {
+    if (saved) {
+      gcode_file.sync();
+      fat.chdir();
+      if (fat.exists(upload_name)) fat.remove(upload_name);
+      if (gcode_file.rename(fat.vwd(), upload_name))
+        SERIAL_EM(STR_SD_FILE_SAVED);
+      else
+        openFailed(upload_name);
+      gcode_file.close();
+    }
+    else {
+      SERIAL_LM(ER, STR_SD_UPLOAD_ABORTED);
+      gcode_file.remove();  // Drop the partial file, its clusters are preallocated
+    }
+    upload_port = -1;
+    upload_size = 0;
+    setSaving(false);
+    #if ENABLED(EMERGENCY_PARSER)
+      emergency_parser.enable();
+    #endif
+  }
+
+#endif // SD_BINARY_UPLOAD
+
 void SDCard::makeDirectory(const char * const path) {
   if (!isMounted()) return;
   endFilePrint();
@@ -377,6 +588,12 @@ void SDCard::makeDirectory(const char * const path) {
 }
 
 void SDCard::closeFile() {
+  #if ENABLED(SD_BINARY_UPLOAD)
+    if (isBinaryWrite()) return endBinaryWrite(false);
+  #endif
+  #if ENABLED(SD_WRITE_PREALLOCATE)
+    if (isSaving()) gcode_file.truncate(gcode_file.curPosition());
+  #endif
   gcode_file.sync();
   gcode_file.close();
   setSaving(false);
@@ -387,6 +604,9 @@ void SDCard::closeFile() {
 
 void SDCard::fileHasFinished() {
   planner.synchronize();
+  #if ENABLED(SD_LAYER_INDEX)
+    layerindex.finish();
+  #endif
   endFilePrint();
   #if ENABLED(SDCARD_SORT_ALPHA)
     presort();
@@ -485,6 +705,7 @@ bool SDCard::selectFile(const char * const path, const bool silent/*=false*/) {
 
     fileSize = gcode_file.fileSize();
     sdpos = 0;
+    seek_count++;
 
     if (!silent) {
       SERIAL_MT(STR_SD_FILE_OPENED, fname);
@@ -495,10 +716,27 @@ bool SDCard::selectFile(const char * const path, const bool silent/*=false*/) {
       const_cast<char&>(fileName[c]) = '\0';
     strncpy(fileName, path, strlen(path));
 
-    #if ENABLED(JSON_OUTPUT)
+    #if ENABLED(SD_METADATA_INDEX)
+      load_metadata();
+    #elif ENABLED(JSON_OUTPUT)
       parsejson(gcode_file);
     #endif
 
+    #if ENABLED(SD_DOUBLE_BUFFER)
+      flush_read_buffer();
+    #endif
+
+    #if ENABLED(GCZ_SUPPORT)
+      // A compressed file this build can not decode is not printed as text
+      const GCZHeaderEnum header = gcz.begin();
+      compressed = header == GCZ_VALID;
+      if (header == GCZ_UNSUPPORTED) {
+        gcode_file.close();
+        return false;
+      }
+      if (!compressed) seek(0);
+    #endif
+
     return true;
   }
   else {
@@ -535,6 +773,85 @@ uint16_t SDCard::get_num_Files() {
   ;
 }
 
+/**
+ * Preallocated contiguous files
+ *
+ * open_contiguous() opens path in the working directory as a single run of
+ * card blocks of at least size bytes, creating it if needed, and returns
+ * its first block (0 if the card has no free run long enough).
+ * An existing file that does not fit is replaced only once the new one is
+ * allocated, so a full card keeps the old file.
+ * write_contiguous() then writes by file offset straight to the card:
+ * no cluster chain walk, no FAT or directory update, so the latency of a
+ * write does not depend on where it falls in the file.
+ */
+uint32_t SDCard::open_contiguous(SdFile &file, const char * const path, const uint32_t size) {
+
+  constexpr char temp_name[] = ".contig.tmp";
+  uint32_t bgn = 0, end;
+
+  if (file.open(fat.vwd(), path, O_RDWR)) {
+    if (file.fileSize() >= size && file.contiguousRange(&bgn, &end)) return bgn;
+    file.close();
+  }
+
+  SdFile::remove(fat.vwd(), temp_name);   // Left over from a power loss
+  if (!file.createContiguous(fat.vwd(), temp_name, size)) return 0;
+  if (!file.contiguousRange(&bgn, &end)) {
+    file.remove();
+    return 0;
+  }
+
+  SdFile::remove(fat.vwd(), path);
+  if (!file.rename(fat.vwd(), path)) {
+    file.remove();
+    return 0;
+  }
+
+  return bgn;
+}
+
+/**
+ * Forget the first blocks of the contiguous files, after a file is
+ * removed or the card changes they may belong to another file
+ */
+void SDCard::forget_contiguous() {
+  #if HAS_SD_RESTART
+    restart.close();
+  #endif
+  #if HAS_EEPROM_SD
+    eeprom_block = 0;
+  #endif
+}
+
+bool SDCard::write_contiguous(const uint32_t block, uint32_t pos, const void * const buf, uint16_t nbyte) {
+
+  // Drop the volume cache, it may hold one of the blocks and is used as scratch
+  uint8_t * const scratch = (uint8_t*)fat.vol()->cacheClear();
+  if (!scratch) return false;
+
+  const uint8_t *src = (const uint8_t*)buf;
+
+  while (nbyte) {
+    const uint32_t lbn = block + (pos >> 9);
+    const uint16_t offset = pos & 0x1FF,
+                   n = MIN(nbyte, uint16_t(512 - offset));
+    if (n == 512) {
+      if (!fat.card()->writeBlock(lbn, src)) return false;
+    }
+    else {
+      if (!fat.card()->readBlock(lbn, scratch)) return false;
+      memcpy(scratch + offset, src, n);
+      if (!fat.card()->writeBlock(lbn, scratch)) return false;
+    }
+    src += n;
+    pos += n;
+    nbyte -= n;
+  }
+
+  return true;
+}
+
 #if HAS_SD_RESTART
 
   constexpr char restart_file_name[8] = "restart";
@@ -543,13 +860,27 @@ uint16_t SDCard::get_num_Files() {
 
     if (!isMounted() || restart.job_file.isOpen()) return;
 
-    if (!restart.job_file.open(fat.vwd(), restart_file_name, read ? O_READ : (O_RDWR | O_CREAT | O_SYNC)))
+    if (!restart.job_file.open(fat.vwd(), restart_file_name, read ? O_READ : (O_RDWR | O_CREAT)))
       openFailed(restart_file_name);
     else if (!read) {
       if (printer.debugFeature()) DEBUG_EMT(STR_SD_WRITE_TO_FILE, restart_file_name);
     }
   }
 
+  // Replace the restart file with a new journal, return its first block
+  uint32_t SDCard::create_restart_file() {
+
+    if (!isMounted() || restart.job_file.isOpen()) return 0;
+
+    delete_restart_file();
+    const uint32_t block = open_contiguous(restart.job_file, restart_file_name, SD_RESTART_FILE_SIZE);
+    restart.job_file.close();
+    if (!block)
+      openFailed(restart_file_name);
+    else if (printer.debugFeature()) DEBUG_EMT(STR_SD_WRITE_TO_FILE, restart_file_name);
+    return block;
+  }
+
   void SDCard::delete_restart_file() {
     if (exist_restart_file()) {
       restart.job_file.remove(fat.vwd(), restart_file_name);
@@ -568,6 +899,47 @@ uint16_t SDCard::get_num_Files() {
 
 #endif
 
+#if ENABLED(GCZ_SUPPORT)
+
+  int16_t SDCard::get_gcode() { return compressed ? gcz.get() : get(); }
+
+  uint32_t SDCard::getIndex() { return compressed ? gcz.position() : sdpos; }
+
+  /**
+   * A compressed file can only be decoded from its start. Its index is
+   * an offset in the decompressed text, so decode the newpos characters
+   * before it and the next get_gcode() returns the one at newpos, as
+   * seek() does for a plain file. Deep in a big file this takes seconds,
+   * so heaters, LCD and host keepalive are served every 4KB.
+   */
+  void SDCard::setIndex(const uint32_t newpos) {
+    if (!compressed) return seek(newpos);
+    seek(0);
+    if (gcz.begin() != GCZ_VALID) return;
+    PRINTER_KEEPALIVE(InProcess);
+    for (uint32_t i = 0; i < newpos; i++) {
+      if (gcz.get() < 0) break;
+      if (!(i & 0xFFF)) printer.idle();
+    }
+  }
+
+#endif
+
+#if ENABLED(SD_DOUBLE_BUFFER)
+
+  /**
+   * Fill the spare buffer with the next block of the print file,
+   * so the parser swaps to it without waiting on the card.
+   * Called from idle while printing.
+   */
+  void SDCard::read_ahead() {
+    const uint8_t next = read_active ^ 1;
+    if (isPrinting() && !read_count[next] && read_base + read_count[read_active] < fileSize)
+      fill_read_buffer(next);
+  }
+
+#endif
+
 #if HAS_EEPROM_SD
 
   void SDCard::import_eeprom() {
@@ -584,12 +956,15 @@ uint16_t SDCard::get_num_Files() {
       return;
     }
 
-    if (!eeprom_file.open(EEPROM_FILE_NAME, O_RDWR | O_CREAT | O_SYNC) ||
-        !eeprom_file.seekSet(0) ||
-        !eeprom_file.write(memorystore.eeprom_data, EEPROM_SIZE) == EEPROM_SIZE
-    ) SERIAL_LM(ER, "Could not write eeprom to sd card");
+    if (!eeprom_block) {
+      eeprom_block = open_contiguous(eeprom_file, EEPROM_FILE_NAME, EEPROM_SIZE);
+      eeprom_file.close();
+    }
 
-    eeprom_file.close();
+    if (!eeprom_block || !write_contiguous(eeprom_block, 0, memorystore.eeprom_data, EEPROM_SIZE)) {
+      eeprom_block = 0;
+      SERIAL_LM(ER, "Could not write eeprom to sd card");
+    }
   }
 
 #endif
@@ -609,12 +984,16 @@ uint16_t SDCard::get_num_Files() {
   }
 
   /**
-   * Read all the files and produce a sort key
+   * Start sorting the files of the current directory
+   *
+   * The sort runs a few steps at a time from Printer::idle, so the LCD
+   * stays responsive on big directories. Until it is done sort_count
+   * stays 0 and the listing is shown unsorted.
    *
-   * We can do this in 3 ways...
-   *  - Minimal RAM: Read two filenames at a time sorting along...
-   *  - Some RAM: Buffer the directory just for this sort
-   *  - Most RAM: Buffer the directory and return filenames from RAM
+   * The order is produced by a bottom-up merge sort. Names are compared...
+   *  - Minimal RAM: Re-reading the two names from SD for every compare
+   *  - Some RAM: From a buffer of the directory, filled one name per step
+   *  - Most RAM: As above, and filenames are then returned from RAM
    */
   void SDCard::presort() {
 
@@ -623,7 +1002,7 @@ uint16_t SDCard::get_num_Files() {
       if (!sort_alpha) return;
     #endif
 
-    // Throw away old sort index
+    // Throw away old sort index, and any sort in progress
     flush_presort();
 
     // If there are files, sort up to the limit
@@ -637,171 +1016,212 @@ uint16_t SDCard::get_num_Files() {
       // Sort order is always needed. May be static or dynamic.
       #if ENABLED(SDSORT_DYNAMIC_RAM)
         sort_order = new uint8_t[fileCnt];
-      #endif
-
-      // Use RAM to store the entire directory during pre-sort.
-      // SDSORT_LIMIT should be set to prevent over-allocation.
-      #if ENABLED(SDSORT_USES_RAM)
-
-        // If using dynamic ram for names, allocate on the heap.
-        #if ENABLED(SDSORT_CACHE_NAMES)
-          #if ENABLED(SDSORT_DYNAMIC_RAM)
+        sort_merge = new uint8_t[fileCnt];
+        #if ENABLED(SDSORT_NAMES_IN_RAM)
+          #if ENABLED(SDSORT_CACHE_NAMES)
             sortnames = new char*[fileCnt];
           #endif
-        #elif ENABLED(SDSORT_USES_STACK)
-          char sortnames[fileCnt][SORTED_LONGNAME_MAXLEN];
-        #endif
-
-        // Folder sorting needs 1 bit per entry for flags.
-        #if HAS_FOLDER_SORTING
-          #if ENABLED(SDSORT_DYNAMIC_RAM)
+          #if HAS_FOLDER_SORTING
             isDir = new uint8_t[(fileCnt + 7) >> 3];
-          #elif ENABLED(SDSORT_USES_STACK)
-            uint8_t isDir[(fileCnt + 7) >> 3];
           #endif
         #endif
+      #endif
 
-      #else // !SDSORT_USES_RAM
-
-        // By default re-read the names from SD for every compare
-        // retaining only two filenames at a time. This is very
-        // slow but is safest and uses minimal RAM.
-        char name1[LONG_FILENAME_LENGTH + 1];
+      for (uint16_t i = 0; i < fileCnt; i++) sort_order[i] = i;
+      sort_total = fileCnt;
 
+      #if ENABLED(SDSORT_NAMES_IN_RAM)
+        sort_width = sort_k = 0;  // Load the names first
+        sort_dir = workDir;
+        sort_dir.rewind();
+      #else
+        presort_merge(1);
       #endif
+    }
+  }
 
-      if (fileCnt > 1) {
-
-        // Init sort order.
-        for (uint16_t i = 0; i < fileCnt; i++) {
-          sort_order[i] = i;
-          // If using RAM then read all filenames now.
-          #if ENABLED(SDSORT_USES_RAM)
-            getfilename(i);
-            #if ENABLED(SDSORT_DYNAMIC_RAM)
-              // Use dynamic method to copy long fileName
-              sortnames[i] = strdup(fileName);
-            #else
-              // Copy filenames into the static array
-              #if SORTED_LONGNAME_MAXLEN != LONG_FILENAME_LENGTH
-                strncpy(sortnames[i], fileName, SORTED_LONGNAME_MAXLEN);
-                sortnames[i][SORTED_LONGNAME_MAXLEN - 1] = '\0';
-              #else
-                strcpy(sortnames[i], SORTED_LONGNAME_MAXLEN);
-              #endif
-            #endif
-            // char out[30];
-            // sprintf_P(out, PSTR("---- %i %s %s"), i, isFilenameIsDir( ? "D" : " ", sortnames[i]);
-            // SERIAL_ECHOLN(out);
-            #if HAS_FOLDER_SORTING
-              const uint16_t bit = i & 0x07, ind = i >> 3;
-              if (bit == 0) isDir[ind] = 0x00;
-              if (isFilenameIsDir()) isDir[ind] |= _BV(bit);
-            #endif
-          #endif
-        }
+  /**
+   * Advance the sort started by presort.
+   * Each step loads one name or moves one item of a merge. A call ends
+   * after sort_steps steps or once sort_reads directory entries are read.
+   * Names are loaded in one pass over the directory. Without names in RAM
+   * each compare reads the directory again, so big directories get one
+   * compare per call.
+   */
+  void SDCard::presort_step() {
 
-        // Bubble Sort
-        for (uint16_t i = fileCnt; --i;) {
-          bool didSwap = false;
-          for (uint16_t j = 0; j < i; ++j) {
-            const uint16_t o1 = sort_order[j], o2 = sort_order[j + 1];
-
-            // Compare names from the array or just the two buffered names
-            #if ENABLED(SDSORT_USES_RAM)
-              #define _SORT_CMP_NODIR() (strcasecmp(sortnames[o1], sortnames[o2]) > 0)
-            #else
-              #define _SORT_CMP_NODIR() (strcasecmp(name1, name2) > 0)
-            #endif
-
-            #if HAS_FOLDER_SORTING
-              #if ENABLED(SDSORT_USES_RAM)
-                // Folder sorting needs an index and bit to test for folder-ness.
-                const uint8_t ind1 = o1 >> 3, bit1 = o1 & 0x07,
-                              ind2 = o2 >> 3, bit2 = o2 & 0x07;
-                #define _SORT_CMP_DIR(fs) \
-                  (((isDir[ind1] & _BV(bit1)) != 0) == ((isDir[ind2] & _BV(bit2)) != 0) \
-                    ? _SORT_CMP_NODIR() \
-                    : (isDir[fs > 0 ? ind1 : ind2] & (fs > 0 ? _BV(bit1) : _BV(bit2))) != 0)
-              #else
-                #define _SORT_CMP_DIR(fs) ((dir1 == isFilenameIsDir()) ? _SORT_CMP_NODIR() : (fs > 0 ? dir1 : !dir1))
-              #endif
-            #endif
-
-            // The most economical method reads names as-needed
-            // throughout the loop. Slow if there are many.
-            #if DISABLED(SDSORT_USES_RAM)
-              getfilename(o1);
-              strcpy(name1, fileName); // save (or getfilename below will trounce it)
-              #if HAS_FOLDER_SORTING
-                bool dir1 = isFilenameIsDir();
-              #endif
-              getfilename(o2);
-              char *name2 = fileName; // use the string in-place
-            #endif // !SDSORT_USES_RAM
-
-            // Sort the current pair according to settings.
-            if (
-              #if HAS_FOLDER_SORTING
-                #if ENABLED(SDSORT_GCODE)
-                  sort_folders ? _SORT_CMP_DIR(sort_folders) : _SORT_CMP_NODIR()
-                #else
-                  _SORT_CMP_DIR(FOLDER_SORTING)
-                #endif
-              #else
-                _SORT_CMP_NODIR()
-              #endif
-            ) {
-              sort_order[j] = o2;
-              sort_order[j + 1] = o1;
-              didSwap = true;
-            }
+    if (!sort_total || sort_count) return;
+
+    constexpr uint8_t   sort_steps = 32;
+    constexpr uint16_t  sort_reads = 32;
+
+    lsReads = 0;
+
+    for (uint8_t steps = sort_steps; steps-- && lsReads < sort_reads;) {
+
+      #if ENABLED(SDSORT_NAMES_IN_RAM)
+        if (!sort_width) {
+          SdFile file;
+          if (!lsNext(sort_dir, file)) {
+            // The directory lost entries, sort the names loaded so far
+            if (!sort_k) return flush_presort();
+            sort_total = sort_k;
+            presort_merge(1);
+            if (sort_count) return;
+            continue;
           }
-          if (!didSwap) break;
-        }
-        // Using RAM but not keeping names around
-        #if ENABLED(SDSORT_USES_RAM) && DISABLED(SDSORT_CACHE_NAMES)
-          #if ENABLED(SDSORT_DYNAMIC_RAM)
-            for (uint16_t i = 0; i < fileCnt; ++i) free(sortnames[i]);
-            #if HAS_FOLDER_SORTING
-              free(isDir);
-            #endif
-          #endif
-        #endif
-      }
-      else {
-        sort_order[0] = 0;
-        #if ENABLED(SDSORT_USES_RAM) && ENABLED(SDSORT_CACHE_NAMES)
-          getfilename(0);
-          #if ENABLED(SDSORT_DYNAMIC_RAM)
-            sortnames = new char*[1];
-            sortnames[0] = strdup(fileName); // malloc
-            isDir = new uint8_t[1];
+          #if ENABLED(SDSORT_DYNAMIC_RAM) && ENABLED(SDSORT_CACHE_NAMES)
+            // Use dynamic method to copy long fileName
+            sortnames[sort_k] = strdup(tempLongFilename);
           #else
-            #if SORTED_LONGNAME_MAXLEN != LONG_FILENAME_LENGTH
-              strncpy(sortnames[0], fileName, SORTED_LONGNAME_MAXLEN);
-              sortnames[0][SORTED_LONGNAME_MAXLEN - 1] = '\0';
-            #else
-              strcpy(sortnames[0], SORTED_LONGNAME_MAXLEN);
-            #endif
+            // Copy filenames into the static array
+            strncpy(sortnames[sort_k], tempLongFilename, SORTED_LONGNAME_MAXLEN);
+            sortnames[sort_k][SORTED_LONGNAME_MAXLEN - 1] = '\0';
           #endif
-          isDir[0] = isFilenameIsDir() ? 0x01 : 0x00;
-        #endif
-      }
+          #if HAS_FOLDER_SORTING
+            const uint16_t bit = sort_k & 0x07, ind = sort_k >> 3;
+            if (bit == 0) isDir[ind] = 0x00;
+            if (file.isSubDir()) isDir[ind] |= _BV(bit);
+          #endif
+          file.close();
+          if (++sort_k >= sort_total) presort_merge(1);
+          if (sort_count) return;
+          continue;
+        }
+      #endif
+
+      // Merge the runs [sort_lo, mid) and [mid, hi) into sort_merge
+      const uint16_t  mid = MIN(sort_lo + sort_width, sort_total),
+                      hi  = MIN(sort_lo + 2 * sort_width, sort_total);
+
+      if (sort_j >= hi || (sort_i < mid && !sort_after(sort_order[sort_i], sort_order[sort_j])))
+        sort_merge[sort_k++] = sort_order[sort_i++];
+      else
+        sort_merge[sort_k++] = sort_order[sort_j++];
 
-      sort_count = fileCnt;
+      if (sort_k >= hi) {
+        memcpy(&sort_order[sort_lo], &sort_merge[sort_lo], hi - sort_lo);
+        if (hi < sort_total) {
+          sort_lo = sort_i = sort_k = hi;
+          sort_j = MIN(sort_lo + sort_width, sort_total);
+        }
+        else
+          presort_merge(sort_width * 2);
+        if (sort_count) return;
+      }
     }
   }
 
   void SDCard::flush_presort() {
-    if (sort_count > 0) {
+    if (sort_total > 0) {
       #if ENABLED(SDSORT_DYNAMIC_RAM)
-        delete sort_order;
+        delete [] sort_order;
+        delete [] sort_merge;
+        #if ENABLED(SDSORT_NAMES_IN_RAM)
+          #if ENABLED(SDSORT_CACHE_NAMES)
+            for (uint16_t i = sort_width ? sort_total : sort_k; i--;) free(sortnames[i]);
+            delete [] sortnames;
+          #endif
+          #if HAS_FOLDER_SORTING
+            delete [] isDir;
+          #endif
+        #endif
       #endif
-      sort_count = 0;
+      sort_count = sort_total = 0;
     }
   }
 
+  /**
+   * Start a merge pass with runs of the given width,
+   * or publish the order once a single run is left.
+   */
+  void SDCard::presort_merge(const uint16_t width) {
+    if (width < sort_total) {
+      sort_width = width;
+      sort_lo = sort_i = sort_k = 0;
+      sort_j = MIN(width, sort_total);
+      return;
+    }
+
+    sort_count = sort_total;
+  }
+
+  /**
+   * Compare two items by directory index according to the settings.
+   * Return true if o1 sorts after o2.
+   */
+  bool SDCard::sort_after(const uint8_t o1, const uint8_t o2) {
+
+    // Compare names from the array or just the two buffered names
+    #if ENABLED(SDSORT_NAMES_IN_RAM)
+      #define _SORT_CMP_NODIR() (strcasecmp(sortnames[o1], sortnames[o2]) > 0)
+    #else
+      #define _SORT_CMP_NODIR() (strcasecmp(name1, name2) > 0)
+    #endif
+
+    #if HAS_FOLDER_SORTING
+      #if ENABLED(SDSORT_NAMES_IN_RAM)
+        // Folder sorting needs an index and bit to test for folder-ness.
+        const uint8_t ind1 = o1 >> 3, bit1 = o1 & 0x07,
+                      ind2 = o2 >> 3, bit2 = o2 & 0x07;
+        #define _SORT_CMP_DIR(fs) \
+          (((isDir[ind1] & _BV(bit1)) != 0) == ((isDir[ind2] & _BV(bit2)) != 0) \
+            ? _SORT_CMP_NODIR() \
+            : (isDir[fs > 0 ? ind1 : ind2] & (fs > 0 ? _BV(bit1) : _BV(bit2))) != 0)
+      #else
+        #define _SORT_CMP_DIR(fs) ((dir1 == dir2) ? _SORT_CMP_NODIR() : (fs > 0 ? dir1 : !dir1))
+      #endif
+    #endif
+
+    // The most economical method reads names as-needed, into its own
+    // buffers: this runs from idle and must not touch fileName
+    #if DISABLED(SDSORT_NAMES_IN_RAM)
+      char name1[LONG_FILENAME_LENGTH + 1], name2[LONG_FILENAME_LENGTH + 1];
+      #if HAS_FOLDER_SORTING
+        const bool dir1 = sort_name(o1, name1), dir2 = sort_name(o2, name2);
+      #else
+        sort_name(o1, name1);
+        sort_name(o2, name2);
+      #endif
+    #endif
+
+    return
+      #if HAS_FOLDER_SORTING
+        #if ENABLED(SDSORT_GCODE)
+          sort_folders ? _SORT_CMP_DIR(sort_folders) : _SORT_CMP_NODIR()
+        #else
+          _SORT_CMP_DIR(FOLDER_SORTING)
+        #endif
+      #else
+        _SORT_CMP_NODIR()
+      #endif
+    ;
+  }
+
+  #if DISABLED(SDSORT_NAMES_IN_RAM)
+
+    /**
+     * Copy the name of entry nr of the working directory into name.
+     * Unlike getfilename it leaves fileName and the folder flag alone.
+     * Return true if the entry is a folder.
+     */
+    bool SDCard::sort_name(const uint8_t nr, char * const name) {
+      SdFile dir = workDir, file;
+      dir.rewind();
+      for (uint8_t cnt = 0; lsNext(dir, file); cnt++) {
+        const bool is_dir = file.isSubDir();
+        file.close();
+        if (cnt == nr) {
+          strcpy(name, tempLongFilename);
+          return is_dir;
+        }
+      }
+      name[0] = '\0';
+      return false;
+    }
+
+  #endif
+
 #endif // SDCARD_SORT_ALPHA
 
 #if ENABLED(ADVANCED_SD_COMMAND)
@@ -956,22 +1376,7 @@ void SDCard::lsDive(SdFile parent, PGM_P const match/*=NULL*/) {
   uint8_t cnt = 0;
 
   // Read the next entry from a directory
-  while (file.openNext(&parent, O_READ)) {
-    file.getName(tempLongFilename, LONG_FILENAME_LENGTH);
-
-    if (workDirDepth >= SD_MAX_FOLDER_DEPTH && strcmp(tempLongFilename, "..") == 0) {
-      file.close();
-      continue;
-    }
-    if (tempLongFilename[0] == '.' && tempLongFilename[1] != '.') {
-      file.close();
-      continue; // MAC CRAP
-    }
-
-    if (!(file.isFile() || file.isSubDir()) || file.isHidden()) {
-      file.close();
-      continue;
-    }
+  while (lsNext(parent, file)) {
 
     setFilenameIsDir(file.isSubDir());
 
@@ -999,6 +1404,38 @@ void SDCard::lsDive(SdFile parent, PGM_P const match/*=NULL*/) {
   } // while readDir
 }
 
+/**
+ * Open the next entry of parent that is listed, with its
+ * name in tempLongFilename. Return false at the end.
+ */
+bool SDCard::lsNext(SdFile &parent, SdFile &file) {
+
+  while (file.openNext(&parent, O_READ)) {
+    #if ENABLED(SDCARD_SORT_ALPHA)
+      lsReads++;
+    #endif
+    file.getName(tempLongFilename, LONG_FILENAME_LENGTH);
+
+    if (workDirDepth >= SD_MAX_FOLDER_DEPTH && strcmp(tempLongFilename, "..") == 0) {
+      file.close();
+      continue;
+    }
+    if (tempLongFilename[0] == '.' && tempLongFilename[1] != '.') {
+      file.close();
+      continue; // MAC CRAP
+    }
+
+    if (!(file.isFile() || file.isSubDir()) || file.isHidden()) {
+      file.close();
+      continue;
+    }
+
+    return true;
+  }
+
+  return false;
+}
+
 // --------------------------------------------------------------- //
 // Code that gets gcode information is adapted from RepRapFirmware //
 // Originally licenced under GPL                                   //
@@ -1056,6 +1493,76 @@ void SDCard::parsejson(SdFile &parser_file) {
   parser_file.rewind();
 }
 
+#if ENABLED(SD_METADATA_INDEX)
+
+  /**
+   * Take the metadata of the selected file from the index on the card.
+   * The file is analyzed with parsejson only when it has no record yet
+   * or its size or date no longer match, and the record is then
+   * written in place or appended. The index is kept to
+   * SD_METADATA_RECORDS records: once full, a new record takes the
+   * slot picked by its key.
+   */
+  void SDCard::load_metadata() {
+
+    char name[MAX_PATH_NAME_LENGHT];
+    getAbsFilename(name);
+
+    // FNV-1a, seeded with the record size so an index written with
+    // another layout never matches
+    uint32_t key = 2166136261UL ^ sizeof(sd_meta_t);
+    for (const char *c = name; *c; c++) key = (key ^ uint8_t(*c)) * 16777619UL;
+
+    dir_t dir;
+    gcode_file.dirEntry(&dir);
+    fileSize = gcode_file.fileSize();
+
+    sd_meta_t meta;
+    uint32_t meta_pos = 0;
+    constexpr uint32_t meta_max = uint32_t(SD_METADATA_RECORDS) * sizeof(sd_meta_t);
+    const bool index_open = meta_file.open(fat.vwd(), META_FILE_NAME, O_RDWR | O_CREAT);
+
+    if (index_open) {
+      if (meta_file.fileSize() > meta_max) meta_file.truncate(meta_max);
+      while (meta_file.read(&meta, sizeof(meta)) == sizeof(meta)) {
+        if (meta.key == key) {
+          if (meta.size == fileSize && meta.date == dir.lastWriteDate && meta.time == dir.lastWriteTime) {
+            firstlayerHeight  = meta.firstlayerHeight;
+            layerHeight       = meta.layerHeight;
+            objectHeight      = meta.objectHeight;
+            filamentNeeded    = meta.filamentNeeded;
+            memcpy(generatedBy, meta.generatedBy, GENBY_SIZE);
+            meta_file.close();
+            return;
+          }
+          break;  // Stale, rewrite this record
+        }
+        meta_pos += sizeof(meta);
+      }
+    }
+
+    parsejson(gcode_file);
+
+    if (index_open) {
+      meta.key              = key;
+      meta.size             = fileSize;
+      meta.date             = dir.lastWriteDate;
+      meta.time             = dir.lastWriteTime;
+      meta.firstlayerHeight = firstlayerHeight;
+      meta.layerHeight      = layerHeight;
+      meta.objectHeight     = objectHeight;
+      meta.filamentNeeded   = filamentNeeded;
+      memcpy(meta.generatedBy, generatedBy, GENBY_SIZE);
+      if (meta_pos >= meta_max) meta_pos = (key % SD_METADATA_RECORDS) * sizeof(meta);
+      if (!meta_file.seekSet(meta_pos) || meta_file.write(&meta, sizeof(meta)) != sizeof(meta))
+        SERIAL_LM(ER, STR_SD_ERR_WRITE_TO_FILE);
+      meta_file.close();
+    }
+
+  }
+
+#endif
+
 bool SDCard::findGeneratedBy(char* buf, char* genBy) {
   // Slic3r & S3D
   PGM_P generatedByString = PSTR("generated by ");
@@ -1224,6 +1731,36 @@ bool SDCard::findTotalHeight(char* buf, float &height) {
   return false;
 }
 
+#if ENABLED(SD_DOUBLE_BUFFER)
+
+  /**
+   * Read into buffer b up to the next block boundary of the file.
+   * After a seek the first read is short, every later one is a whole
+   * aligned block that SdFat transfers straight into the buffer.
+   */
+  void SDCard::fill_read_buffer(const uint8_t b) {
+    const uint16_t len = SD_READ_BUFFER_SIZE - (gcode_file.curPosition() % SD_READ_BUFFER_SIZE);
+    const int16_t n = gcode_file.read(read_buffer[b], len);
+    read_count[b] = n > 0 ? n : 0;
+  }
+
+  /**
+   * Active buffer consumed: swap to the other one, reading it now
+   * if read_ahead had no chance to. False on end of file or error.
+   */
+  bool SDCard::next_read_buffer() {
+    const uint8_t next = read_active ^ 1;
+    if (!read_count[next]) fill_read_buffer(next);
+    if (!read_count[next]) return false;
+    read_base += read_count[read_active];
+    read_count[read_active] = 0;
+    read_active = next;
+    read_index = 0;
+    return true;
+  }
+
+#endif
+
 #if ENABLED(ADVANCED_SD_COMMAND)
 
   uint8_t SDCard::cidDmp() {
@@ -44,6 +44,21 @@ union flagcard_t {
   flagcard_t() { all = 0x00; }
 };
 
+#if ENABLED(SD_METADATA_INDEX)
+  // Record of the metadata index, one for each analyzed G-code file
+  struct sd_meta_t {
+    uint32_t  key,              // Hash of the absolute file name
+              size;
+    uint16_t  date,             // FAT last write date and time
+              time;
+    float     firstlayerHeight,
+              layerHeight,
+              objectHeight,
+              filamentNeeded;
+    char      generatedBy[GENBY_SIZE];
+  };
+#endif
+
 class SDCard {
 
   public: /** Constructor */
@@ -65,6 +80,8 @@ class SDCard {
     static uint32_t fileSize,
                     sdpos;
 
+    static uint8_t  seek_count;   // Bumped on every file select or seek, read-ahead data is stale
+
     static float  objectHeight,
                   firstlayerHeight,
                   layerHeight,
@@ -81,6 +98,43 @@ class SDCard {
     #if HAS_EEPROM_SD
       #define EEPROM_FILE_NAME "eeprom.bin"
       static SdFile eeprom_file;
+      static uint32_t eeprom_block;       // First card block of the EEPROM file, 0 = not known yet
+    #endif
+
+    #if ENABLED(GCZ_SUPPORT)
+      static bool compressed;             // Print file has a GCZ header
+    #endif
+
+    #if ENABLED(SD_METADATA_INDEX)
+      #define META_FILE_NAME ".meta.idx"  // Dot file, skipped by the listings
+      static SdFile meta_file;
+    #endif
+
+    #if ENABLED(SD_DOUBLE_BUFFER)
+      static uint8_t  read_buffer[2][SD_READ_BUFFER_SIZE];
+      static uint16_t read_count[2],      // Valid bytes in each buffer, 0 = empty
+                      read_index;         // Next byte of the active buffer
+      static uint8_t  read_active;        // Buffer the parser is consuming
+      static uint32_t read_base;          // File position of read_buffer[read_active][0]
+    #endif
+
+    #if ENABLED(SD_BINARY_UPLOAD)
+      #define UPLOAD_TEMP_NAME ".upload.tmp"  // Renamed to upload_name by M29
+      static const uint16_t UPLOAD_FRAME_SIZE = 512,
+                            UPLOAD_QUIET_MS   = 50,
+                            UPLOAD_TIMEOUT_MS = 1000,
+                            UPLOAD_IDLE_MS    = 10000;
+      static const uint8_t  UPLOAD_RETRY      = 10;
+      static uint8_t  upload_buffer[UPLOAD_FRAME_SIZE + 2]; // Frame data and CRC
+      static char     upload_name[MAX_PATH_NAME_LENGHT];    // File name given with M28 B
+      static uint32_t upload_block;       // First card block of the file, 0 = write through gcode_file
+      static uint16_t upload_index;       // Bytes of the current frame received
+      static uint32_t upload_size,        // File size given with M28 B, 0 = no binary write
+                      upload_done;        // Bytes written to the file
+      static int8_t   upload_port;        // Serial port of the upload, -1 = none
+      static uint8_t  upload_retry;       // Resends of the same bad or partial frame
+      static bool     upload_discard;     // Bad frame, skip bytes until the line is quiet
+      static short_timer_t upload_timer;  // Restarted on every byte received
     #endif
 
     static uint16_t     workDirDepth,
@@ -96,11 +150,19 @@ class SDCard {
         //static bool sort_reverse;       // Flag to enable / disable reverse sorting
       #endif
 
+      // Background merge sort state, see presort_step
+      static uint16_t sort_total,         // Items being sorted, sort_count stays 0 until done
+                      sort_width,         // Width of the runs being merged, 0 while loading names
+                      sort_lo,            // Start of the current pair of runs
+                      sort_i, sort_j,     // Next item of the left and of the right run
+                      sort_k,             // Next slot of sort_merge, or name to load
+                      lsReads;            // Directory entries read, budget of presort_step
+
       // By default the sort index is static
       #if ENABLED(SDSORT_DYNAMIC_RAM)
-        static uint8_t *sort_order;
+        static uint8_t *sort_order, *sort_merge;
       #else
-        static uint8_t sort_order[SDSORT_LIMIT];
+        static uint8_t sort_order[SDSORT_LIMIT], sort_merge[SDSORT_LIMIT];
       #endif
 
       #if ENABLED(SDSORT_USES_RAM) && ENABLED(SDSORT_CACHE_NAMES) && DISABLED(SDSORT_DYNAMIC_RAM)
@@ -109,6 +171,12 @@ class SDCard {
         #define SORTED_LONGNAME_MAXLEN LONG_FILENAME_LENGTH
       #endif
 
+      // Names buffered for the whole sort, otherwise re-read for each compare
+      #if ENABLED(SDSORT_USES_RAM) && (ENABLED(SDSORT_CACHE_NAMES) || DISABLED(SDSORT_USES_STACK))
+        #define SDSORT_NAMES_IN_RAM
+        static SdFile sort_dir;           // Directory read in a single pass to load the names
+      #endif
+
       // Cache filenames to speed up SD menus.
       #if ENABLED(SDSORT_USES_RAM)
 
@@ -206,8 +274,12 @@ class SDCard {
     static uint16_t getnrfilenames();
     static uint16_t get_num_Files();
 
+    static uint32_t open_contiguous(SdFile &file, const char * const path, const uint32_t size);
+    static bool write_contiguous(const uint32_t block, uint32_t pos, const void * const buf, uint16_t nbyte);
+
     #if HAS_SD_RESTART
       static void open_restart_file(const bool read);
+      static uint32_t create_restart_file();
       static void delete_restart_file();
       static bool exist_restart_file();
     #endif
@@ -217,8 +289,18 @@ class SDCard {
       static void write_eeprom();
     #endif
 
+    #if ENABLED(SD_BINARY_UPLOAD)
+      static void startBinaryWrite(const char * const path, const uint32_t size, const int8_t port);
+      static void upload_byte(const uint8_t c);
+      static void check_upload();
+      static inline bool isUploading() { return upload_port >= 0; }
+      static inline bool isUploading(const uint8_t port) { return upload_port == port; }
+      static inline bool isBinaryWrite() { return upload_size > 0; }
+    #endif
+
     #if ENABLED(SDCARD_SORT_ALPHA)
       static void presort();
+      static void presort_step();
       static void getfilename_sorted(const uint16_t nr);
       #if ENABLED(SDSORT_GCODE)
         static inline void setSortOn(const bool b) { sort_alpha = b; presort(); }
@@ -260,10 +342,35 @@ class SDCard {
     static inline void pauseSDPrint() { setPrinting(false); }
     static inline bool isFileOpen()   { return isMounted() && gcode_file.isOpen(); }
     static inline bool isPaused()     { return isFileOpen() && !isPrinting(); }
-    static inline void setIndex(uint32_t newpos) { sdpos = newpos; gcode_file.seekSet(sdpos); }
-    static inline uint32_t getIndex() { return sdpos; }
     static inline bool eof() { return sdpos >= fileSize; }
-    static inline int16_t get() { sdpos = gcode_file.curPosition(); return (int16_t)gcode_file.read(); }
+
+    #if ENABLED(SD_DOUBLE_BUFFER)
+      static void read_ahead();
+      static inline void seek(uint32_t newpos) { sdpos = newpos; seek_count++; gcode_file.seekSet(sdpos); flush_read_buffer(); }
+      static inline int16_t get() {
+        const bool ok = read_index < read_count[read_active] || next_read_buffer();
+        sdpos = read_base + read_index;
+        return ok ? read_buffer[read_active][read_index++] : -1;
+      }
+    #else
+      static inline void seek(uint32_t newpos) { sdpos = newpos; seek_count++; gcode_file.seekSet(sdpos); }
+      static inline int16_t get() { sdpos = gcode_file.curPosition(); return (int16_t)gcode_file.read(); }
+    #endif
+
+    // G-code characters of the print file, decompressed for .gcz files
+    // The index of a .gcz file counts decompressed characters
+    #if ENABLED(GCZ_SUPPORT)
+      static uint32_t getIndex();
+      static void setIndex(const uint32_t newpos);
+      static int16_t get_gcode();
+      static inline bool isCompressed() { return compressed; }
+    #else
+      static inline uint32_t getIndex() { return sdpos; }
+      static inline void setIndex(const uint32_t newpos) { seek(newpos); }
+      static inline int16_t get_gcode() { return get(); }
+      static inline bool isCompressed() { return false; }
+    #endif
+
     static inline uint8_t percentDone() { return (isFileOpen() && fileSize) ? sdpos / ((fileSize + 99) / 100) : 0; }
     static inline void getWorkDirName() { workDir.getName(fileName, LONG_FILENAME_LENGTH); }
     static inline size_t read(void* buf, uint16_t nbyte) { return gcode_file.isOpen() ? gcode_file.read(buf, nbyte) : -1; }
@@ -279,9 +386,14 @@ class SDCard {
   private: /** Private Function */
 
     static void openFailed(const char * const path);
+    static void forget_contiguous();
     static void lsRecursive(FatFile *dir, uint8_t level=0);
     static void lsDive(SdFile parent, PGM_P const match = NULL);
+    static bool lsNext(SdFile &parent, SdFile &file);
     static void parsejson(SdFile &parser_file);
+    #if ENABLED(SD_METADATA_INDEX)
+      static void load_metadata();
+    #endif
     static bool findGeneratedBy(char* buf, char* genBy);
     static bool findFirstLayerHeight(char* buf, float &firstlayerHeight);
     static bool findLayerHeight(char* buf, float &layerHeight);
@@ -290,6 +402,24 @@ class SDCard {
 
     #if ENABLED(SDCARD_SORT_ALPHA)
       static void flush_presort();
+      static void presort_merge(const uint16_t width);
+      static bool sort_after(const uint8_t o1, const uint8_t o2);
+      #if DISABLED(SDSORT_NAMES_IN_RAM)
+        static bool sort_name(const uint8_t nr, char * const name);
+      #endif
+    #endif
+
+    #if ENABLED(SD_BINARY_UPLOAD)
+      static void endBinaryWrite(const bool saved);
+    #endif
+
+    #if ENABLED(SD_DOUBLE_BUFFER)
+      static void fill_read_buffer(const uint8_t b);
+      static bool next_read_buffer();
+      static inline void flush_read_buffer() {
+        read_count[0] = read_count[1] = read_index = read_active = 0;
+        read_base = sdpos;
+      }
     #endif
 
     #if ENABLED(ADVANCED_SD_COMMAND)
@@ -133,6 +133,18 @@ uint32_t      Stepper::advance_divisor        = 0,
 uint8_t       Stepper::active_extruder        = 0,
               Stepper::active_extruder_driver = 0;
 
+#if ENABLED(ARC_STEPPER_BLOCKS)
+  bool        Stepper::arc_block              = false;
+  int32_t     Stepper::arc_u                  = 0,
+              Stepper::arc_v                  = 0,
+              Stepper::arc_sin                = 0;
+  uint32_t    Stepper::arc_vers               = 0,
+              Stepper::arc_events_left        = 0;
+  xy_long_t   Stepper::arc_motor{0},
+              Stepper::arc_fraction{0};
+  xy_ulong_t  Stepper::arc_steps_left{0};
+#endif
+
 #if ENABLED(BEZIER_JERK_CONTROL)
   int32_t __attribute__((used))   Stepper::bezier_A __asm__("bezier_A");      //  A coefficient in Bézier speed curve with alias for assembler
   int32_t __attribute__((used))   Stepper::bezier_B __asm__("bezier_B");      //  B coefficient in Bézier speed curve with alias for assembler
@@ -1712,9 +1724,34 @@ uint32_t Stepper::block_phase_step() {
         oversampling_factor = oversampling;
       #endif
 
+      #if ENABLED(ARC_STEPPER_BLOCKS)
+        // The arc rotates once per planned event, so no oversampling
+        arc_block = TEST(current_block->flag, BLOCK_BIT_ARC);
+        #if ENABLED(ADAPTIVE_STEP_SMOOTHING)
+          if (arc_block) oversampling_factor = oversampling = 0;
+        #endif
+      #endif
+
       // Based on the oversampling factor, do the calculations
       step_event_count = current_block->step_event_count << oversampling;
 
+      #if ENABLED(ARC_STEPPER_BLOCKS)
+        if (arc_block) {
+          arc_u           = current_block->arc_u;
+          arc_v           = current_block->arc_v;
+          arc_sin         = current_block->arc_sin;
+          arc_vers        = current_block->arc_vers;
+          arc_fraction    = current_block->arc_fraction;
+          arc_events_left = step_event_count;
+          arc_steps_left.set(current_block->steps.x, current_block->steps.y);
+          #if CORE_IS_XY
+            arc_motor.set((arc_u + arc_v + arc_fraction.x + 2048) >> 12, (CORESIGN(arc_u - arc_v) + arc_fraction.y + 2048) >> 12);
+          #else
+            arc_motor.set((arc_u + arc_fraction.x + 2048) >> 12, (arc_v + arc_fraction.y + 2048) >> 12);
+          #endif
+        }
+      #endif
+
       // Initialize Bresenham delta errors to 1/2
       delta_error = -int32_t(step_event_count);
 
@@ -1835,23 +1872,30 @@ uint32_t Stepper::block_phase_step() {
 
 FORCE_INLINE void Stepper::pulse_tick_prepare() {
 
-  #if HAS_X_STEP
-    delta_error.x += advance_dividend.x;
-    step_needed.x = (delta_error.x >= 0);
-    if (step_needed.x) {
-      count_position.x += count_direction.x;
-      delta_error.x -= advance_divisor;
-    }
+  #if ENABLED(ARC_STEPPER_BLOCKS)
+    if (arc_block)
+      arc_tick_prepare();
+    else
   #endif
+  {
+    #if HAS_X_STEP
+      delta_error.x += advance_dividend.x;
+      step_needed.x = (delta_error.x >= 0);
+      if (step_needed.x) {
+        count_position.x += count_direction.x;
+        delta_error.x -= advance_divisor;
+      }
+    #endif
 
-  #if HAS_Y_STEP
-    delta_error.y += advance_dividend.y;
-    step_needed.y = (delta_error.y >= 0);
-    if (step_needed.y) {
-      count_position.y += count_direction.y;
-      delta_error.y -= advance_divisor;
-    }
-  #endif
+    #if HAS_Y_STEP
+      delta_error.y += advance_dividend.y;
+      step_needed.y = (delta_error.y >= 0);
+      if (step_needed.y) {
+        count_position.y += count_direction.y;
+        delta_error.y -= advance_divisor;
+      }
+    #endif
+  }
 
   #if HAS_Z_STEP
     delta_error.z += advance_dividend.z;
@@ -1886,6 +1930,49 @@ FORCE_INLINE void Stepper::pulse_tick_prepare() {
 
 }
 
+#if ENABLED(ARC_STEPPER_BLOCKS)
+
+  /**
+   * Rotate the arc position by one event and step X and Y
+   * when their rounded position moves on. Once the steps
+   * left fill the events left, step every event so the
+   * block always ends on its target.
+   */
+  FORCE_INLINE void Stepper::arc_tick_prepare() {
+
+    const int64_t du = int64_t(arc_u) * arc_vers + int64_t(arc_v) * arc_sin * 2,
+                  dv = int64_t(arc_v) * arc_vers - int64_t(arc_u) * arc_sin * 2;
+    arc_u -= int32_t((du + 0x80000000LL) >> 32);
+    arc_v -= int32_t((dv + 0x80000000LL) >> 32);
+    arc_events_left--;
+
+    #if CORE_IS_XY
+      const int32_t a = arc_u + arc_v, b = CORESIGN(arc_u - arc_v);
+    #else
+      const int32_t a = arc_u, b = arc_v;
+    #endif
+
+    step_needed.x = arc_step_needed(arc_motor.x, arc_steps_left.x, (a + arc_fraction.x + 2048) >> 12, count_direction.x);
+    if (step_needed.x) count_position.x += count_direction.x;
+
+    step_needed.y = arc_step_needed(arc_motor.y, arc_steps_left.y, (b + arc_fraction.y + 2048) >> 12, count_direction.y);
+    if (step_needed.y) count_position.y += count_direction.y;
+
+  }
+
+  FORCE_INLINE bool Stepper::arc_step_needed(int32_t &motor, uint32_t &steps_left, const int32_t target, const int8_t dir) {
+    if (!steps_left) return false;
+    // Rounding near a tangent may go back a step, the motor only goes on
+    if ((dir > 0 ? target > motor : target < motor) || steps_left > arc_events_left) {
+      motor += dir;
+      steps_left--;
+      return true;
+    }
+    return false;
+  }
+
+#endif // ARC_STEPPER_BLOCKS
+
 FORCE_INLINE void Stepper::pulse_tick_start() {
 
   #if HAS_X_STEP
@@ -113,6 +113,18 @@ class Stepper {
     static uint8_t      active_extruder,        // Active extruder
                         active_extruder_driver; // Active extruder driver
 
+    #if ENABLED(ARC_STEPPER_BLOCKS)
+      // Integer circle tracer for the arc blocks
+      static bool         arc_block;              // The current block is an arc
+      static int32_t      arc_u, arc_v,           // Position from the arc center in 1/4096 step
+                          arc_sin;                // Sine of the rotation of one event in 1/2^31
+      static uint32_t     arc_vers,               // Versine of the rotation of one event in 1/2^32
+                          arc_events_left;        // Events left in the arc
+      static xy_long_t    arc_motor,              // Motor positions from the arc center in steps
+                          arc_fraction;           // Motor position of the center below one step
+      static xy_ulong_t   arc_steps_left;         // Motor steps left in the arc
+    #endif
+
     #if ENABLED(BEZIER_JERK_CONTROL)
       static int32_t  bezier_A,     // A coefficient in Bzier speed curve
                       bezier_B,     // B coefficient in Bzier speed curve
@@ -380,6 +392,14 @@ class Stepper {
      */
     FORCE_INLINE static void pulse_tick_prepare();
 
+    #if ENABLED(ARC_STEPPER_BLOCKS)
+      /**
+       * Arc tick prepare for X Y
+       */
+      FORCE_INLINE static void arc_tick_prepare();
+      FORCE_INLINE static bool arc_step_needed(int32_t &motor, uint32_t &steps_left, const int32_t target, const int8_t dir);
+    #endif
+
     /**
      * Pulse tick Start
      */
@@ -27,6 +27,8 @@
 #include "../../../../MK4duo.h"
 #include "sanitycheck.h"
 
+Heater heaters[MAX_HEATER];
+
 #if HAS_HOTENDS
   Heater* hotends[MAX_HOTEND]   = { nullptr };
 #endif
@@ -41,6 +43,14 @@
 #endif
 
 /** Public Function */
+void Heater::set_type(const HeatertypeEnum type_p, const uint16_t temp_check_interval_p, const uint8_t temp_hysteresis_p, const uint8_t watch_period_p, const uint8_t watch_increase_p) {
+  type                = type_p;
+  temp_check_interval = temp_check_interval_p;
+  temp_hysteresis     = temp_hysteresis_p;
+  watch_period        = watch_period_p;
+  watch_increase      = watch_increase_p;
+}
+
 void Heater::init() {
 
   // Reset valor
@@ -56,6 +66,7 @@ void Heater::init() {
   setActive(false);
   setIdle(false);
   ResetFault();
+  setHWpwm(isHWpwm());  // Flag loaded from EEPROM, keep soft PWM if the pin has no hardware channel
   next_check_timer.start();
   data.pid.init();
 
@@ -65,6 +76,14 @@ void Heater::init() {
 
   thermal_runaway_state = TRInactive;
 
+  #if ENABLED(THERMAL_MODEL_PROTECTION)
+    thermal_model_reset();
+  #endif
+
+  #if ENABLED(HEATER_POWER_BUDGET)
+    budget_limited      = false;
+  #endif
+
   data.sensor.CalcDerivedParameters();
 
   if (printer.isRunning()) return; // All running not reinitialize
@@ -269,23 +288,30 @@ void Heater::set_output_pwm() {
 
   const uint8_t new_pwm = isHWinvert() ? 255 - pwm_value : pwm_value;
 
+  #if ENABLED(SOFT_PWM_TIMER)
+    // Software PWM is driven by soft PWM timer
+    HAL::soft_pwm_set(this - heaters, (data.pin > NoPin && !isHWpwm()) ? data.pin : NoPin, new_pwm);
+  #endif
+
   if (data.pin > NoPin) {
     if (isHWpwm())
       HAL::analogWrite(data.pin, new_pwm, data.freq);
-    else {
-      #if ENABLED(SOFTWARE_PDM)
-        const uint8_t carry = pwm_soft_pos + new_pwm;
-        HAL::digitalWrite(data.pin, (carry < pwm_soft_pos));
-        pwm_soft_pos = carry;
-      #else // SOFTWARE PWM
-        // Turn HIGH Software PWM
-        if (tempManager.pwm_soft_count == 0 && ((pwm_soft_pos = (new_pwm & SOFT_PWM_MASK)) > 0))
-          HAL::digitalWrite(data.pin, HIGH);
-        // Turn LOW Software PWM
-        if (pwm_soft_pos == tempManager.pwm_soft_count && pwm_soft_pos != SOFT_PWM_MASK)
-          HAL::digitalWrite(data.pin, LOW);
-      #endif
-    }
+    #if DISABLED(SOFT_PWM_TIMER)
+      else {
+        #if ENABLED(SOFTWARE_PDM)
+          const uint8_t carry = pwm_soft_pos + new_pwm;
+          HAL::digitalWrite(data.pin, (carry < pwm_soft_pos));
+          pwm_soft_pos = carry;
+        #else // SOFTWARE PWM
+          // Turn HIGH Software PWM
+          if (tempManager.pwm_soft_count == 0 && ((pwm_soft_pos = (new_pwm & SOFT_PWM_MASK)) > 0))
+            HAL::digitalWrite(data.pin, HIGH);
+          // Turn LOW Software PWM
+          if (pwm_soft_pos == tempManager.pwm_soft_count && pwm_soft_pos != SOFT_PWM_MASK)
+            HAL::digitalWrite(data.pin, LOW);
+        #endif
+      }
+    #endif
   }
 
 }
@@ -302,7 +328,12 @@ void Heater::check_and_power() {
 
   // Check for thermal runaway
   if (isThermalProtection()) {
-    thermal_runaway_protection();
+    #if ENABLED(THERMAL_MODEL_PROTECTION)
+      if (useThermalModel())
+        thermal_model_protection();
+      else
+    #endif
+        thermal_runaway_protection();
     if (thermal_runaway_state == TRRunaway)
       temp_error(PSTR(STR_T_THERMAL_RUNAWAY), GET_TEXT(MSG_THERMAL_RUNAWAY));
   }
@@ -310,10 +341,15 @@ void Heater::check_and_power() {
   // Ignore heater we are currently testing
   if (Pidtuning) return;
 
-  get_output();
+  // Held back by the power budget, the heater is not expected to heat up
+  if (isBudgetLimited() && next_watch_timer.isRunning()) start_watching();
 
-  // Make sure temperature is increasing
-  if (isThermalProtection() && next_watch_timer.isRunning() && next_watch_timer.expired(watch_period * 1000, false)) {
+  // Make sure temperature is increasing, the thermal model already check the heating
+  if (isThermalProtection()
+    #if ENABLED(THERMAL_MODEL_PROTECTION)
+      && !useThermalModel()
+    #endif
+    && next_watch_timer.isRunning() && next_watch_timer.expired(watch_period * 1000, false)) {
     if (current_temperature < watch_target_temp)
       temp_error(PSTR(STR_HEATING_FAILED), GET_TEXT(MSG_HEATING_FAILED));
     else
@@ -369,6 +405,12 @@ void Heater::PID_autotune(const float target_temp, const uint8_t ncycles, const
     LEDColor color = ledevents.onHeatingStart(isHotend);
   #endif
 
+  #if ENABLED(THERMAL_MODEL_PROTECTION)
+    // First heating at full power is used to identify the thermal model
+    const float model_start_temp = current_temperature;
+    millis_l    model_heat_ms    = 0;
+  #endif
+
   // PID Tuning loop
   while (printer.isWaitForHeatUp()) {
 
@@ -386,6 +428,10 @@ void Heater::PID_autotune(const float target_temp, const uint8_t ncycles, const
       ledevents.onHeating(isHotend, start_temp, current_temp, target_temp);
     #endif
 
+    #if ENABLED(THERMAL_MODEL_PROTECTION)
+      if (!model_heat_ms && cycles == 0 && current_temp > target_temp) model_heat_ms = now - t2;
+    #endif
+
     if (heating && current_temp > target_temp) {
       if (ELAPSED(now, t2 + 5000UL)) {
         heating = false;
@@ -547,6 +593,10 @@ void Heater::PID_autotune(const float target_temp, const uint8_t ncycles, const
       data.pid.Ki = tune_pid.Ki;
       data.pid.Kd = tune_pid.Kd;
 
+      #if ENABLED(THERMAL_MODEL_PROTECTION)
+        if (type != IS_COOLER) thermal_model_identify(target_temp, model_start_temp, model_heat_ms, bias);
+      #endif
+
       setPidTuned(true);
       Pidtuning = false;
       ResetFault();
@@ -623,7 +673,15 @@ void Heater::print_M306() {
   const int8_t heater_id = type == IS_HOTEND ? data.ID : -type;
   SERIAL_SM(CFG, "Heater parameters: H<Heater>");
   if (heater_id < 0) SERIAL_MSG(" T<tools>");
-  SERIAL_EM(" P<Pin> A<Power Drive Min> B<Power Drive Max> C<Power Max> F<Freq> L<Min Temp> O<Max Temp> U<Use Pid 0-1> I<Hardware Inverted 0-1> R<Thermal Protection 0-1> Q<Pwm Hardware 0-1>:");
+  SERIAL_MSG(" P<Pin> A<Power Drive Min> B<Power Drive Max> C<Power Max> F<Freq> L<Min Temp> O<Max Temp> U<Use Pid 0-1> I<Hardware Inverted 0-1> R<Thermal Protection 0-1> Q<Pwm Hardware 0-1>");
+  #if ENABLED(THERMAL_MODEL_PROTECTION)
+    if (type != IS_COOLER) SERIAL_MSG(" D<Model gain> K<Model time constant> V<Model fan loss>");
+  #endif
+  #if ENABLED(HEATER_POWER_BUDGET)
+    SERIAL_MSG(" W<Watts>");
+  #endif
+  SERIAL_CHR(':');
+  SERIAL_EOL();
   SERIAL_SMV(CFG, "  M306 H", (int)heater_id);
   if (heater_id < 0) SERIAL_MV(" T", int(data.ID));
   SERIAL_MV(" P", data.pin);
@@ -637,6 +695,16 @@ void Heater::print_M306() {
   SERIAL_MV(" I", isHWinvert());
   SERIAL_MV(" Q", isHWpwm());
   SERIAL_MV(" R", isThermalProtection());
+  #if ENABLED(THERMAL_MODEL_PROTECTION)
+    if (type != IS_COOLER) {
+      SERIAL_MV(" D", data.model.gain);
+      SERIAL_MV(" K", data.model.tau);
+      SERIAL_MV(" V", data.model.fan_loss);
+    }
+  #endif
+  #if ENABLED(HEATER_POWER_BUDGET)
+    SERIAL_MV(" W", data.watts);
+  #endif
   SERIAL_EOL();
 
   if (printer.debugFeature()) {
@@ -709,7 +777,7 @@ void Heater::thermal_runaway_protection() {
         }
       #endif
 
-      if (current_temperature >= target_temperature - THERMAL_PROTECTION_HYSTERESIS) {
+      if (current_temperature >= target_temperature - THERMAL_PROTECTION_HYSTERESIS || isBudgetLimited()) {
         thermal_runaway_timer.start();
         break;
       }
@@ -739,6 +807,58 @@ void Heater::start_watching() {
 
 }
 
+#if ENABLED(THERMAL_MODEL_PROTECTION)
+
+  void Heater::thermal_model_reset() {
+    model_temp    = current_temperature;
+    model_ambient = THERMAL_MODEL_AMBIENT;
+    model_residual_timer.stop();
+  }
+
+  /**
+   * Thermal model protection
+   *
+   * Called every 100ms, predict the temperature from the applied power
+   * and compare it with the measured temperature. Slow differences
+   * (enclosure, draft) are absorbed by the ambient correction, a residual
+   * over THERMAL_MODEL_RESIDUAL for THERMAL_MODEL_PERIOD is a runaway
+   * (heater disconnected, thermistor fallout or heater stuck on).
+   */
+  void Heater::thermal_model_protection() {
+
+    constexpr float dt = 0.1f;
+
+    if (!isActive()) {
+      thermal_model_reset();
+      return;
+    }
+
+    float fan = 0.0f;
+    #if HAS_FAN
+      if (type == IS_HOTEND && fanManager.data.fans > 0) fan = fans[0]->actual_speed() * (1.0f / 255.0f);
+    #endif
+
+    model_temp = data.model.predict(model_temp, pwm_value * (1.0f / 255.0f), fan, model_ambient, dt);
+
+    const float residual = current_temperature - model_temp;
+
+    model_ambient += residual * (dt / (THERMAL_MODEL_ADAPT));
+    LIMIT(model_ambient, THERMAL_MODEL_AMBIENT - data.model.gain * 0.5f, THERMAL_MODEL_AMBIENT + data.model.gain * 0.25f);
+
+    if (ABS(residual) < THERMAL_MODEL_RESIDUAL)
+      model_residual_timer.stop();
+    else if (!model_residual_timer.isRunning())
+      model_residual_timer.start();
+    else if (model_residual_timer.expired(SECOND_TO_MILLIS(THERMAL_MODEL_PERIOD), false)) {
+      SERIAL_SMV(ER, "Thermal model residual:", residual, 1);
+      SERIAL_EOL();
+      thermal_runaway_state = TRRunaway;
+    }
+
+  }
+
+#endif // ENABLED(THERMAL_MODEL_PROTECTION)
+
 /** Private Function */
 // Temperature Error Handlers
 void Heater::temp_error(PGM_P const serial_msg, PGM_P const lcd_msg) {
@@ -835,3 +955,30 @@ void Heater::update_idle_timer() {
   if (!isIdle() && idle_timeout_ms && (ELAPSED(millis(), idle_timeout_ms)))
     setIdle(true);
 }
+
+#if ENABLED(THERMAL_MODEL_PROTECTION)
+
+  /**
+   * Identify the thermal model from PID autotune:
+   *  gain from the bias power that hold the target,
+   *  time constant from the first heating at full power.
+   */
+  void Heater::thermal_model_identify(const float target_temp, const float start_temp, const millis_l heat_ms, const long bias) {
+
+    if (!heat_ms || bias <= 0) return;
+
+    const float gain     = (target_temp - (THERMAL_MODEL_AMBIENT)) * 255.0f / bias,
+                end_temp = (THERMAL_MODEL_AMBIENT) + gain * data.pid.Max * (1.0f / 255.0f);
+
+    if (end_temp <= target_temp || start_temp >= target_temp) return;
+
+    data.model.gain = gain;
+    data.model.tau  = -(heat_ms * 0.001f) / LOG((end_temp - target_temp) / (end_temp - start_temp));
+    NOLESS(data.model.tau, 1.0f);
+
+    SERIAL_MV("Thermal model D", data.model.gain);
+    SERIAL_EMV(" K", data.model.tau);
+
+  }
+
+#endif // ENABLED(THERMAL_MODEL_PROTECTION)
@@ -43,6 +43,24 @@ union heater_flag_t {
 enum HeatertypeEnum : uint8_t { IS_HOTEND, IS_BED, IS_CHAMBER, IS_COOLER };
 enum TRState        : uint8_t { TRInactive, TRFirstHeating, TRStable, TRRunaway };
 
+#if ENABLED(THERMAL_MODEL_PROTECTION)
+  // Struct first order thermal model
+  struct thermal_model_t {
+
+    float gain,     // Temperature rise over ambient at full power (°C)
+          tau,      // Time constant (s)
+          fan_loss; // Heat loss increase with fan at full speed (1 = double)
+
+    FORCE_INLINE bool isValid() const { return gain > 0 && tau > 0; }
+
+    // Temperature after dt seconds with power and fan 0.0 - 1.0
+    FORCE_INLINE float predict(const float temp, const float power, const float fan, const float ambient, const float dt) const {
+      return temp + (gain * power - (temp - ambient) * (1.0f + fan_loss * fan)) * dt / tau;
+    }
+
+  };
+#endif
+
 // Struct Heater data
 struct heater_data_t {
   uint8_t         ID;
@@ -52,19 +70,19 @@ struct heater_data_t {
   limit_int_t     temp;
   pid_data_t      pid;
   sensor_data_t   sensor;
+  #if ENABLED(THERMAL_MODEL_PROTECTION)
+    thermal_model_t model;
+  #endif
+  #if ENABLED(HEATER_POWER_BUDGET)
+    uint16_t        watts;
+  #endif
 };
 
 class Heater {
 
   public: /** Constructor */
 
-    Heater(HeatertypeEnum type_p, uint16_t temp_check_interval_p, uint8_t temp_hysteresis_p, uint8_t watch_period_p, uint8_t watch_increase_p) :
-      type(type_p),
-      temp_check_interval(temp_check_interval_p),
-      temp_hysteresis(temp_hysteresis_p),
-      watch_period(watch_period_p),
-      watch_increase(watch_increase_p)
-    {}
+    Heater() {}
 
   public: /** Public Parameters */
 
@@ -77,13 +95,13 @@ class Heater {
 
     float           current_temperature;
 
-    const HeatertypeEnum type;
+    HeatertypeEnum  type;
 
   private: /** Private Parameters */
 
-    const uint16_t  temp_check_interval;
+    uint16_t        temp_check_interval;
 
-    const uint8_t   temp_hysteresis,
+    uint8_t         temp_hysteresis,
                     watch_period,
                     watch_increase;
 
@@ -101,8 +119,20 @@ class Heater {
 
     bool            Pidtuning;
 
+    #if ENABLED(THERMAL_MODEL_PROTECTION)
+      float         model_temp,
+                    model_ambient;
+      long_timer_t  model_residual_timer;
+    #endif
+
+    #if ENABLED(HEATER_POWER_BUDGET)
+      bool          budget_limited;
+    #endif
+
   public: /** Public Function */
 
+    void set_type(const HeatertypeEnum type_p, const uint16_t temp_check_interval_p, const uint8_t temp_hysteresis_p, const uint8_t watch_period_p, const uint8_t watch_increase_p);
+
     void init();
 
     void set_target_temp(const int16_t celsius);
@@ -129,6 +159,12 @@ class Heater {
     void thermal_runaway_protection();
     void start_watching();
 
+    #if ENABLED(THERMAL_MODEL_PROTECTION)
+      void thermal_model_reset();
+      void thermal_model_protection();
+      FORCE_INLINE bool useThermalModel() { return type != IS_COOLER && data.model.isValid(); }
+    #endif
+
     FORCE_INLINE void update_current_temperature() { this->current_temperature = this->data.sensor.getTemperature(); }
     FORCE_INLINE int16_t deg_current()  { return this->current_temperature + 0.5f; }
     FORCE_INLINE int16_t deg_target()   { return this->target_temperature;  }
@@ -136,6 +172,18 @@ class Heater {
     FORCE_INLINE bool tempisrange()     { return (WITHIN(this->current_temperature, this->data.temp.min, this->data.temp.max)); }
     FORCE_INLINE bool isHeating()       { return this->target_temperature > this->current_temperature;  }
     FORCE_INLINE bool isCooling()       { return this->target_temperature <= this->current_temperature; }
+    FORCE_INLINE bool isPidTuning()     { return this->Pidtuning; }
+
+    #if ENABLED(HEATER_POWER_BUDGET)
+      FORCE_INLINE void setBudgetLimited(const bool onoff) { budget_limited = onoff; }
+      FORCE_INLINE bool isBudgetLimited() { return budget_limited; }
+      // Inside the hysteresis band the output holds the temperature (PID or bang bang)
+      FORCE_INLINE bool isHolding() {
+        return ABS((this->isIdle() ? this->idle_temperature : this->target_temperature) - this->current_temperature) < temp_hysteresis;
+      }
+    #else
+      FORCE_INLINE bool isBudgetLimited() { return false; }
+    #endif
 
     FORCE_INLINE bool wait_for_heating() {
       return this->isActive() && ABS(this->current_temperature - this->target_temperature) > temp_hysteresis;
@@ -162,8 +210,8 @@ class Heater {
     FORCE_INLINE void setHWinvert(const bool onoff) { data.flag.HWInvert = onoff; }
     FORCE_INLINE bool isHWinvert() { return data.flag.HWInvert; }
 
-    // Flag bit 4 Set PWM Hardware
-    FORCE_INLINE void setHWpwm(const bool onoff) { data.flag.HWpwm = onoff; }
+    // Flag bit 4 Set PWM Hardware, only on a pin with a usable hardware channel
+    FORCE_INLINE void setHWpwm(const bool onoff) { data.flag.HWpwm = onoff && data.pin > NoPin && USEABLE_HARDWARE_PWM(data.pin); }
     FORCE_INLINE bool isHWpwm() { return data.flag.HWpwm; }
 
     // Flag bit 5 Set Thermal Protection
@@ -208,8 +256,14 @@ class Heater {
 
     void update_idle_timer();
 
+    #if ENABLED(THERMAL_MODEL_PROTECTION)
+      void thermal_model_identify(const float target_temp, const float start_temp, const millis_l heat_ms, const long bias);
+    #endif
+
 };
 
+extern Heater heaters[MAX_HEATER];
+
 #if HAS_HOTENDS
   extern Heater* hotends[MAX_HOTEND];
 #endif
@@ -96,4 +96,10 @@ struct pid_data_t {
       return pid_output;
     }
 
+    // The output was cut outside the PID (power budget), keep the integral
+    // at the output really applied so it does not wind up against the limit
+    void limit_output(const float output) {
+      if (output < pid_output) NOMORE(iState_sum, MAX(output, float(drive.min)));
+    }
+
 };
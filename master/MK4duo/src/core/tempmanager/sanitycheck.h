@@ -258,6 +258,46 @@
   #endif
 #endif
 
+#if ENABLED(THERMAL_MODEL_PROTECTION)
+  #if !HAS_THERMAL_PROTECTION
+    #error "DEPENDENCY ERROR: THERMAL_MODEL_PROTECTION requires THERMAL_PROTECTION for at least one heater."
+  #endif
+  #if DISABLED(THERMAL_MODEL_RESIDUAL)
+    #error "DEPENDENCY ERROR: Missing setting THERMAL_MODEL_RESIDUAL."
+  #endif
+  #if DISABLED(THERMAL_MODEL_PERIOD)
+    #error "DEPENDENCY ERROR: Missing setting THERMAL_MODEL_PERIOD."
+  #endif
+  #if DISABLED(THERMAL_MODEL_ADAPT)
+    #error "DEPENDENCY ERROR: Missing setting THERMAL_MODEL_ADAPT."
+  #endif
+  #if DISABLED(THERMAL_MODEL_AMBIENT)
+    #error "DEPENDENCY ERROR: Missing setting THERMAL_MODEL_AMBIENT."
+  #endif
+  #if DISABLED(THERMAL_MODEL_FAN_LOSS)
+    #error "DEPENDENCY ERROR: Missing setting THERMAL_MODEL_FAN_LOSS."
+  #endif
+#endif
+
+#if ENABLED(HEATER_POWER_BUDGET)
+  #if DISABLED(HEATER_POWER_BUDGET_WATTS)
+    #error "DEPENDENCY ERROR: Missing setting HEATER_POWER_BUDGET_WATTS."
+  #endif
+  #if DISABLED(HOTEND_WATTS) || DISABLED(BED_WATTS) || DISABLED(CHAMBER_WATTS) || DISABLED(COOLER_WATTS)
+    #error "DEPENDENCY ERROR: Missing setting HOTEND_WATTS, BED_WATTS, CHAMBER_WATTS or COOLER_WATTS."
+  #endif
+#endif
+
+// Soft PWM timer
+#if ENABLED(SOFT_PWM_TIMER)
+  #if DISABLED(ARDUINO_ARCH_SAM)
+    #error "DEPENDENCY ERROR: SOFT_PWM_TIMER is only supported on Arduino DUE."
+  #endif
+  #if DISABLED(SOFT_PWM_TIMER_FREQUENCY)
+    #error "DEPENDENCY ERROR: Missing setting SOFT_PWM_TIMER_FREQUENCY."
+  #endif
+#endif
+
 /**
  * MK4duo supports only one DHT sensor
  */
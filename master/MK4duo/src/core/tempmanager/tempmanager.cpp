@@ -32,7 +32,9 @@ TempManager tempManager;
 /** Public Parameters */
 temp_data_t TempManager::heater;
 
-#if DISABLED(SOFTWARE_PDM)
+uint8_t TempManager::heater_count = 0;
+
+#if DISABLED(SOFTWARE_PDM) && DISABLED(SOFT_PWM_TIMER)
   uint8_t TempManager::pwm_soft_count = 0;
 #endif
 
@@ -69,74 +71,130 @@ void TempManager::init() {
     paused = false;
   #endif
 
+  LOOP_HEATER() heaters[h].init();
+
+  // Called by EEPROM post_process once the sensor pins are loaded or reset.
+  // All running not reinitialize HAL::analogStart, only the ADC channel table
+  if (printer.isRunning()) return HAL::analogSetupHeaters();
+
+  HAL::analogStart();
+
+  // Wait for temperature measurement to settle
+  HAL::delayMilliseconds(250);
+
+}
+
+#define NO_HEATER_SLOT 0xFF
+
+/**
+ * Heaters live packed in heaters[] as hotends, beds, chambers and coolers.
+ * Heaters already configured are kept, moving them to their new slot if
+ * the number of heaters of a previous type changed.
+ */
+void TempManager::create_object() {
+
+  uint8_t old_slot[MAX_HEATER],
+          slot = 0;
+
   #if HAS_HOTENDS
-    LOOP_HOTEND()   hotends[h]->init();
+    LOOP_HOTEND()   old_slot[slot++] = hotends[h]   ? hotends[h]  - heaters : NO_HEATER_SLOT;
   #endif
   #if HAS_BEDS
-    LOOP_BED()      beds[h]->init();
+    LOOP_BED()      old_slot[slot++] = beds[h]      ? beds[h]     - heaters : NO_HEATER_SLOT;
   #endif
   #if HAS_CHAMBERS
-    LOOP_CHAMBER()  chambers[h]->init();
+    LOOP_CHAMBER()  old_slot[slot++] = chambers[h]  ? chambers[h] - heaters : NO_HEATER_SLOT;
   #endif
   #if HAS_COOLERS
-    LOOP_COOLER()   coolers[h]->init();
+    LOOP_COOLER()   old_slot[slot++] = coolers[h]   ? coolers[h]  - heaters : NO_HEATER_SLOT;
   #endif
 
-  if (printer.isRunning()) return; // All running not reinitialize HAL::analogStart
-
-  HAL::analogStart();
+  // Stop the Tick loops while the heaters are moved
+  heater_count = 0;
 
-  // Wait for temperature measurement to settle
-  HAL::delayMilliseconds(250);
+  // Moving down in ascending order and up in descending order never
+  // overwrites a heater that has still to be moved.
+  LOOP_L_N(h, slot)
+    if (old_slot[h] != NO_HEATER_SLOT && old_slot[h] > h) heaters[h] = heaters[old_slot[h]];
+  for (int8_t h = slot - 1; h >= 0; h--)
+    if (old_slot[h] != NO_HEATER_SLOT && old_slot[h] < h) heaters[h] = heaters[old_slot[h]];
 
-}
-
-void TempManager::create_object() {
+  slot = 0;
 
   #if HAS_HOTENDS
-    LOOP_HOTEND() {
-      if (!hotends[h]) {
-        hotends[h] = new Heater(IS_HOTEND, HOTEND_CHECK_INTERVAL, HOTEND_HYSTERESIS, WATCH_HOTEND_PERIOD, WATCH_HOTEND_INCREASE);
-        hotends_factory_parameters(h);
-        SERIAL_LMV(ECHO, "Create H", int(h));
-        hotends[h]->init();
+    LOOP_L_N(h, MAX_HOTEND) {
+      if (h < heater.hotends) {
+        hotends[h] = &heaters[slot];
+        if (old_slot[slot++] == NO_HEATER_SLOT) {
+          hotends[h]->set_type(IS_HOTEND, HOTEND_CHECK_INTERVAL, HOTEND_HYSTERESIS, WATCH_HOTEND_PERIOD, WATCH_HOTEND_INCREASE);
+          hotends_factory_parameters(h);
+          SERIAL_LMV(ECHO, "Create H", int(h));
+          hotends[h]->init();
+        }
+      }
+      else if (hotends[h]) {
+        hotends[h] = nullptr;
+        SERIAL_LMV(ECHO, "Delete H", int(h));
       }
     }
   #endif
 
   #if HAS_BEDS
-    LOOP_BED() {
-      if (!beds[h]) {
-        beds[h] = new Heater(IS_BED, BED_CHECK_INTERVAL, BED_HYSTERESIS, WATCH_BED_PERIOD, WATCH_BED_INCREASE);
-        beds_factory_parameters(h);
-        SERIAL_LMV(ECHO, "Create Bed", int(h));
-        beds[h]->init();
+    LOOP_L_N(h, MAX_BED) {
+      if (h < heater.beds) {
+        beds[h] = &heaters[slot];
+        if (old_slot[slot++] == NO_HEATER_SLOT) {
+          beds[h]->set_type(IS_BED, BED_CHECK_INTERVAL, BED_HYSTERESIS, WATCH_BED_PERIOD, WATCH_BED_INCREASE);
+          beds_factory_parameters(h);
+          SERIAL_LMV(ECHO, "Create Bed", int(h));
+          beds[h]->init();
+        }
+      }
+      else if (beds[h]) {
+        beds[h] = nullptr;
+        SERIAL_LMV(ECHO, "Delete Bed", int(h));
       }
     }
   #endif
 
   #if HAS_CHAMBERS
-    LOOP_CHAMBER() {
-      if (!chambers[h]) {
-        chambers[h] = new Heater(IS_CHAMBER, CHAMBER_CHECK_INTERVAL, CHAMBER_HYSTERESIS, WATCH_CHAMBER_PERIOD, WATCH_CHAMBER_INCREASE);
-        chambers_factory_parameters(h);
-        SERIAL_LMV(ECHO, "Create Chamber", int(h));
-        chambers[h]->init();
+    LOOP_L_N(h, MAX_CHAMBER) {
+      if (h < heater.chambers) {
+        chambers[h] = &heaters[slot];
+        if (old_slot[slot++] == NO_HEATER_SLOT) {
+          chambers[h]->set_type(IS_CHAMBER, CHAMBER_CHECK_INTERVAL, CHAMBER_HYSTERESIS, WATCH_CHAMBER_PERIOD, WATCH_CHAMBER_INCREASE);
+          chambers_factory_parameters(h);
+          SERIAL_LMV(ECHO, "Create Chamber", int(h));
+          chambers[h]->init();
+        }
+      }
+      else if (chambers[h]) {
+        chambers[h] = nullptr;
+        SERIAL_LMV(ECHO, "Delete Chamber", int(h));
       }
     }
   #endif
 
   #if HAS_COOLERS
-    LOOP_COOLER() {
-      if (!coolers[h]) {
-        coolers[h] = new Heater(IS_COOLER, COOLER_CHECK_INTERVAL, COOLER_HYSTERESIS, WATCH_COOLER_PERIOD, WATCH_COOLER_INCREASE);
-        coolers_factory_parameters(h);
-        SERIAL_LMV(ECHO, "Create Cooler", int(h));
-        coolers[h]->init();
+    LOOP_L_N(h, MAX_COOLER) {
+      if (h < heater.coolers) {
+        coolers[h] = &heaters[slot];
+        if (old_slot[slot++] == NO_HEATER_SLOT) {
+          coolers[h]->set_type(IS_COOLER, COOLER_CHECK_INTERVAL, COOLER_HYSTERESIS, WATCH_COOLER_PERIOD, WATCH_COOLER_INCREASE);
+          coolers_factory_parameters(h);
+          SERIAL_LMV(ECHO, "Create Cooler", int(h));
+          coolers[h]->init();
+        }
+      }
+      else if (coolers[h]) {
+        coolers[h] = nullptr;
+        SERIAL_LMV(ECHO, "Delete Cooler", int(h));
       }
     }
   #endif
 
+  heater_count = slot;
+
 }
 
 void TempManager::factory_parameters() {
@@ -169,79 +227,34 @@ void TempManager::factory_parameters() {
 
 void TempManager::change_number_heater(const HeatertypeEnum type, const uint8_t h) {
 
-  if (type == IS_HOTEND) {
-    if (heater.hotends < h) {
-      heater.hotends = h;
-      create_object();
-    }
-    else if (heater.hotends > h) {
-      for (uint8_t hh = h; hh < MAX_HOTEND; hh++) {
-        if (hotends[hh]) {
-          delete (hotends[hh]);
-          hotends[hh] = nullptr;
-          SERIAL_LMV(ECHO, "Delete H", int(hh));
-        }
-      }
-      heater.hotends = h;
-    }
+  switch (type) {
+    #if HAS_HOTENDS
+      case IS_HOTEND:   heater.hotends  = h; break;
+    #endif
+    #if HAS_BEDS
+      case IS_BED:      heater.beds     = h; break;
+    #endif
+    #if HAS_CHAMBERS
+      case IS_CHAMBER:  heater.chambers = h; break;
+    #endif
+    #if HAS_COOLERS
+      case IS_COOLER:   heater.coolers  = h; break;
+    #endif
+    default: return;
   }
 
-  #if HAS_BEDS
-    else if (type == IS_BED) {
-      if (heater.beds < h) {
-        heater.beds = h;
-        create_object();
-      }
-      else if (heater.beds > h) {
-        for (uint8_t hh = h; hh < MAX_BED; hh++) {
-          if (beds[hh]) {
-            delete (beds[hh]);
-            beds[hh] = nullptr;
-            SERIAL_LMV(ECHO, "Delete Bed", int(hh));
-          }
-        }
-        heater.beds = h;
-      }
-    }
-  #endif
+  create_object();
 
-  #if HAS_CHAMBERS
-    else if (type == IS_CHAMBER) {
-      if (heater.chambers < h) {
-        heater.chambers = h;
-        create_object();
-      }
-      else if (heater.chambers > h) {
-        for (uint8_t hh = h; hh < MAX_CHAMBER; hh++) {
-          if (chambers[hh]) {
-            delete (chambers[hh]);
-            chambers[hh] = nullptr;
-            SERIAL_LMV(ECHO, "Delete Chamber", int(hh));
-          }
-        }
-        heater.chambers = h;
-      }
-    }
-  #endif
+  // Heaters may have moved to other slots, rebuild the ADC channel table
+  HAL::analogSetupHeaters();
 
 }
 
 void TempManager::set_output_pwm() {
 
-  #if HAS_HOTENDS
-    LOOP_HOTEND() hotends[h]->set_output_pwm();
-  #endif
-  #if HAS_BEDS
-    LOOP_BED() beds[h]->set_output_pwm();
-  #endif
-  #if HAS_CHAMBERS
-    LOOP_CHAMBER() chambers[h]->set_output_pwm();
-  #endif
-  #if HAS_COOLERS
-    LOOP_COOLER() coolers[h]->set_output_pwm();
-  #endif
+  LOOP_HEATER() heaters[h].set_output_pwm();
 
-  #if DISABLED(SOFTWARE_PDM)
+  #if DISABLED(SOFTWARE_PDM) && DISABLED(SOFT_PWM_TIMER)
     pwm_soft_count += SOFT_PWM_STEP;
   #endif
 
@@ -262,36 +275,21 @@ void TempManager::spin() {
     if (emergency_parser.killed_by_M112) printer.kill(PSTR("M112"));
   #endif
 
-  #if HAS_HOTENDS
-    LOOP_HOTEND() {
-      // Update Current TempManager
-      hotends[h]->update_current_temperature();
-      hotends[h]->check_and_power();
-    }
-  #endif
+  LOOP_HEATER() {
+    // Update Current TempManager
+    heaters[h].update_current_temperature();
+    if (!heaters[h].isPidTuning()) heaters[h].get_output();
+  }
 
-  #if HAS_BEDS
-    LOOP_BED() {
-      // Update Current TempManager
-      beds[h]->update_current_temperature();
-      beds[h]->check_and_power();
-    } // LOOP_BED
+  // Cut the outputs to the budget before the protections look at them
+  #if ENABLED(HEATER_POWER_BUDGET)
+    apply_power_budget();
   #endif
 
-  #if HAS_CHAMBERS
-    LOOP_CHAMBER() {
-      // Update Current TempManager
-      chambers[h]->update_current_temperature();
-      chambers[h]->check_and_power();
-    } // LOOP_CHAMBER
-  #endif
+  LOOP_HEATER() heaters[h].check_and_power();
 
-  #if HAS_COOLERS
-    LOOP_COOLER() {
-      // Update Current TempManager
-      coolers[h]->update_current_temperature();
-      coolers[h]->check_and_power();
-    } // LOOP_COOLER
+  #if ENABLED(TEMP_TELEMETRY)
+    telemetry.sample();
   #endif
 
   #if HAS_MCU_TEMPERATURE
@@ -358,30 +356,10 @@ void TempManager::disable_all_heaters() {
     planner.flag.autotemp_enabled = false;
   #endif
 
-  #if HAS_HOTENDS
-    LOOP_HOTEND() {
-      hotends[h]->set_target_temp(0);
-      hotends[h]->start_watching();
-    }
-  #endif
-  #if HAS_BEDS
-    LOOP_BED() {
-      beds[h]->set_target_temp(0);
-      beds[h]->start_watching();
-    }
-  #endif
-  #if HAS_CHAMBERS
-    LOOP_CHAMBER() {
-      chambers[h]->set_target_temp(0);
-      chambers[h]->start_watching();
-    }
-  #endif
-  #if HAS_COOLERS
-    LOOP_COOLER() {
-      coolers[h]->set_target_temp(0);
-      coolers[h]->start_watching();
-    }
-  #endif
+  LOOP_HEATER() {
+    heaters[h].set_target_temp(0);
+    heaters[h].start_watching();
+  }
 
   #if ENABLED(LASER)
     // No laser firing with no coolers running! (paranoia)
@@ -402,18 +380,7 @@ void TempManager::disable_all_heaters() {
  * Check if there are heaters Active
  */
 bool TempManager::heaters_isActive() {
-  #if HAS_HOTENDS
-    LOOP_HOTEND()   if (hotends[h]->isActive())   return true;
-  #endif
-  #if HAS_BEDS
-    LOOP_BED()      if (beds[h]->isActive())      return true;
-  #endif
-  #if HAS_CHAMBERS
-    LOOP_CHAMBER()  if (chambers[h]->isActive())  return true;
-  #endif
-  #if HAS_COOLERS
-    LOOP_COOLER()   if (coolers[h]->isActive())   return true;
-  #endif
+  LOOP_HEATER() if (heaters[h].isActive()) return true;
   return false;
 }
 
@@ -494,45 +461,16 @@ bool TempManager::heaters_isActive() {
 
   void TempManager::getTemperature_SPI() {
 
-    #if HAS_HOTENDS
-      LOOP_HOTEND() {
-        if (false) {}
-        #if HAS_MAX31855
-          else if (hotends[h]->data.sensor.type == -4)
-            hotends[h]->data.sensor.adc_raw = hotends[h]->data.sensor.read_max31855();
-        #endif
-        #if HAS_MAX6675
-          else if (hotends[h]->data.sensor.type == -3)
-            hotends[h]->data.sensor.adc_raw = hotends[h]->data.sensor.read_max6675();
-        #endif
-      }
-    #endif
-    #if HAS_BEDS
-      LOOP_BED() {
-        if (false) {}
-        #if HAS_MAX31855
-          else if (beds[h]->data.sensor.type == -4)
-            beds[h]->data.sensor.adc_raw = beds[h]->data.sensor.read_max31855();
-        #endif
-        #if HAS_MAX6675
-          else if (beds[h]->data.sensor.type == -3)
-            beds[h]->data.sensor.adc_raw = beds[h]->data.sensor.read_max6675();
-        #endif
-      }
-    #endif
-    #if HAS_CHAMBERS
-      LOOP_CHAMBER() {
-        if (false) {}
-        #if HAS_MAX31855
-          else if (chambers[h]->data.sensor.type == -4)
-            chambers[h]->data.sensor.adc_raw = chambers[h]->data.sensor.read_max31855();
-        #endif
-        #if HAS_MAX6675
-          else if (chambers[h]->data.sensor.type == -3)
-            chambers[h]->data.sensor.adc_raw = chambers[h]->data.sensor.read_max6675();
-        #endif
-      }
-    #endif
+    LOOP_HEATER() {
+      sensor_data_t &sens = heaters[h].data.sensor;
+      if (false) {}
+      #if HAS_MAX31855
+        else if (sens.type == -4) sens.adc_raw = sens.read_max31855();
+      #endif
+      #if HAS_MAX6675
+        else if (sens.type == -3) sens.adc_raw = sens.read_max6675();
+      #endif
+    }
 
   }
 
@@ -653,6 +591,70 @@ void TempManager::report_temperatures(const bool showRaw/*=false*/) {
 }
 
 /** Private Function */
+#if ENABLED(HEATER_POWER_BUDGET)
+
+  /**
+   * Limit the heaters PWM to stay within HEATER_POWER_BUDGET_WATTS.
+   * Power is assigned first to the heaters holding their target, so a
+   * heater at full power just out of its band can not push them out,
+   * then to the heaters farthest from target.
+   * The last heater served gets the remaining power.
+   * Heaters with no watts set or in PID autotune are not limited.
+   */
+  void TempManager::apply_power_budget() {
+
+    float requested = 0.0f;
+    LOOP_HEATER() {
+      heaters[h].setBudgetLimited(false);
+      if (heaters[h].data.watts && !heaters[h].isPidTuning())
+        requested += heaters[h].data.watts * heaters[h].pwm_value * (1.0f / 255.0f);
+    }
+
+    if (requested <= HEATER_POWER_BUDGET_WATTS) return;
+
+    float budget = HEATER_POWER_BUDGET_WATTS;
+    bool served[MAX_HEATER] = { false };
+
+    for (;;) {
+
+      int8_t next = -1;
+      bool holding = false;
+      float max_error = 0.0f;
+
+      LOOP_HEATER() {
+        Heater * const act = &heaters[h];
+        if (served[h] || !act->data.watts || act->isPidTuning() || !act->pwm_value) continue;
+        const bool hold = act->isHolding();
+        const float error = ABS((act->isIdle() ? act->deg_idle() : act->deg_target()) - act->current_temperature);
+        if (next < 0 || (hold && !holding) || (hold == holding && error > max_error)) {
+          next = h;
+          holding = hold;
+          max_error = error;
+        }
+      }
+
+      if (next < 0) break;
+
+      Heater * const act = &heaters[next];
+      served[next] = true;
+
+      const float power = act->data.watts * act->pwm_value * (1.0f / 255.0f);
+      if (power <= budget)
+        budget -= power;
+      else {
+        act->pwm_value = budget * 255.0f / act->data.watts;
+        act->setBudgetLimited(true);
+        // Only a PID output winds up, out of the band the output was the bang bang maximum
+        if (act->isUsePid() && act->isHolding()) act->data.pid.limit_output(act->pwm_value);
+        budget = 0.0f;
+      }
+
+    }
+
+  }
+
+#endif // ENABLED(HEATER_POWER_BUDGET)
+
 #if HAS_HOTENDS
   void TempManager::hotends_factory_parameters(const uint8_t h) {
 
@@ -706,6 +708,14 @@ void TempManager::report_temperatures(const bool showRaw/*=false*/) {
     heat->setHWinvert(INVERTED_HEATER_PINS);
     heat->setHWpwm(USEABLE_HARDWARE_PWM(heat->data.pin));
     heat->setThermalProtection(THERMAL_PROTECTION_HOTENDS);
+    #if ENABLED(HEATER_POWER_BUDGET)
+      heat->data.watts = HOTEND_WATTS;
+    #endif
+    #if ENABLED(THERMAL_MODEL_PROTECTION)
+      heat->data.model.gain     = 0;
+      heat->data.model.tau      = 0;
+      heat->data.model.fan_loss = THERMAL_MODEL_FAN_LOSS;
+    #endif
     #if HAS_EEPROM
       heat->setPidTuned(false);
     #else
@@ -762,6 +772,14 @@ void TempManager::report_temperatures(const bool showRaw/*=false*/) {
     heat->setHWinvert(INVERTED_BED_PIN);
     heat->setHWpwm(USEABLE_HARDWARE_PWM(heat->data.pin));
     heat->setThermalProtection(THERMAL_PROTECTION_BED);
+    #if ENABLED(HEATER_POWER_BUDGET)
+      heat->data.watts = BED_WATTS;
+    #endif
+    #if ENABLED(THERMAL_MODEL_PROTECTION)
+      heat->data.model.gain     = 0;
+      heat->data.model.tau      = 0;
+      heat->data.model.fan_loss = 0;
+    #endif
     #if HAS_EEPROM
       heat->setPidTuned(false);
     #else
@@ -818,6 +836,14 @@ void TempManager::report_temperatures(const bool showRaw/*=false*/) {
     heat->setHWinvert(INVERTED_CHAMBER_PIN);
     heat->setHWpwm(USEABLE_HARDWARE_PWM(heat->data.pin));
     heat->setThermalProtection(THERMAL_PROTECTION_CHAMBER);
+    #if ENABLED(HEATER_POWER_BUDGET)
+      heat->data.watts = CHAMBER_WATTS;
+    #endif
+    #if ENABLED(THERMAL_MODEL_PROTECTION)
+      heat->data.model.gain     = 0;
+      heat->data.model.tau      = 0;
+      heat->data.model.fan_loss = 0;
+    #endif
     #if HAS_EEPROM
       heat->setPidTuned(false);
     #else
@@ -867,6 +893,14 @@ void TempManager::report_temperatures(const bool showRaw/*=false*/) {
     heat->setHWinvert(INVERTED_COOLER_PIN);
     heat->setHWpwm(USEABLE_HARDWARE_PWM(heat->data.pin));
     heat->setThermalProtection(THERMAL_PROTECTION_COOLER);
+    #if ENABLED(HEATER_POWER_BUDGET)
+      heat->data.watts = COOLER_WATTS;
+    #endif
+    #if ENABLED(THERMAL_MODEL_PROTECTION)
+      heat->data.model.gain     = 0;
+      heat->data.model.tau      = 0;
+      heat->data.model.fan_loss = 0;
+    #endif
     #if HAS_EEPROM
       heat->setPidTuned(false);
     #else
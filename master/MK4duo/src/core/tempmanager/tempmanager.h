@@ -49,7 +49,9 @@ class TempManager {
 
     static temp_data_t heater;
 
-    #if DISABLED(SOFTWARE_PDM)
+    static uint8_t heater_count;  // Heaters in use, packed at the start of heaters[]
+
+    #if DISABLED(SOFTWARE_PDM) && DISABLED(SOFT_PWM_TIMER)
       static uint8_t pwm_soft_count;
     #endif
 
@@ -188,6 +190,13 @@ class TempManager {
 
   private: /** Private Function */
 
+    /**
+     * Share the power budget between heaters
+     */
+    #if ENABLED(HEATER_POWER_BUDGET)
+      static void apply_power_budget();
+    #endif
+
     /**
      * Hotends Factory parameters
      */
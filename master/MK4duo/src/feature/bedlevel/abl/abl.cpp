@@ -32,6 +32,11 @@ abl_data_t AutoBedLevel::data;
 /** Private Parameters */
 xy_float_t  AutoBedLevel::bilinear_grid_factor;
 
+xy_pos_t    AutoBedLevel::batch_points[ABL_BATCH_POINTS];
+float       AutoBedLevel::batch_offsets[ABL_BATCH_POINTS];
+uint8_t     AutoBedLevel::batch_index = 0,
+            AutoBedLevel::batch_count = 0;
+
 /** Public Function */
 /**
  * Extrapolate a single point from its neighbors
@@ -237,6 +242,8 @@ void AutoBedLevel::refresh_bed_level() {
   #if ENABLED(ABL_BILINEAR_SUBDIVISION)
     virt_interpolate();
   #endif
+  bedlevel.refresh_mesh();
+  batch_index = batch_count = 0;
 }
 
 #if ENABLED(ABL_BILINEAR_SUBDIVISION)
@@ -256,6 +263,14 @@ void AutoBedLevel::refresh_bed_level() {
 // Get the Z adjustment for non-linear bed leveling
 float AutoBedLevel::bilinear_z_offset(const xy_pos_t &raw) {
 
+  // Next point of a line leveled in advance
+  if (batch_index < batch_count && raw == batch_points[batch_index])
+    return batch_offsets[batch_index++];
+
+  #if ENABLED(MESH_BICUBIC_INTERPOLATION)
+    return bicubic_z_offset(raw);
+  #endif
+
   static float  z1, d2, z3, d4, L, D;
 
   static xy_pos_t prev { -999.999, -999.999 }, ratio;
@@ -332,73 +347,97 @@ float AutoBedLevel::bilinear_z_offset(const xy_pos_t &raw) {
   return offset;
 }
 
-#if !IS_KINEMATIC
+void AutoBedLevel::bilinear_z_offsets(const xy_pos_t points[], float offsets[], const uint8_t count) {
+
+  #if ENABLED(MESH_BICUBIC_INTERPOLATION)
+    LOOP_L_N(i, count) offsets[i] = bicubic_z_offset(points[i]);
+    return;
+  #endif
+
+  constexpr int32_t max_gx = int32_t(ABL_BG_POINTS_X - 1) << 16,
+                    max_gy = int32_t(ABL_BG_POINTS_Y - 1) << 16;
+
+  // Z at the box corners in microns
+  int32_t z1 = 0, d2 = 0, z3 = 0, d4 = 0;
+
+  xy_int8_t lastg { -1, -1 };
+
+  LOOP_L_N(i, count) {
+
+    // Grid position in 16.16 fixed point, constrained within bounds
+    const xy_pos_t rel = points[i] - data.bilinear_start.asFloat();
+    int32_t gx = LROUND(rel.x * ABL_BG_FACTOR(x) * 65536.0f),
+            gy = LROUND(rel.y * ABL_BG_FACTOR(y) * 65536.0f);
+    LIMIT(gx, 0, max_gx);
+    LIMIT(gy, 0, max_gy);
+
+    // The last grid line belongs to the last box, with ratio 1
+    const xy_int8_t thisg { int8_t(MIN(gx >> 16, ABL_BG_POINTS_X - 2)), int8_t(MIN(gy >> 16, ABL_BG_POINTS_Y - 2)) };
+    const int32_t rx = gx - (int32_t(thisg.x) << 16),
+                  ry = gy - (int32_t(thisg.y) << 16);
+
+    if (lastg != thisg) {
+      lastg = thisg;
+      z1 = LROUND(ABL_BG_GRID(thisg.x,     thisg.y    ) * 1000.0f);       // left-front
+      d2 = LROUND(ABL_BG_GRID(thisg.x,     thisg.y + 1) * 1000.0f) - z1;  // left-back (delta)
+      z3 = LROUND(ABL_BG_GRID(thisg.x + 1, thisg.y    ) * 1000.0f);       // right-front
+      d4 = LROUND(ABL_BG_GRID(thisg.x + 1, thisg.y + 1) * 1000.0f) - z3;  // right-back (delta)
+    }
+
+    // Bilinear interpolate in microns
+    const int32_t L = z1 + ((d2 * ry) >> 16),
+                  R = z3 + ((d4 * ry) >> 16);
+
+    offsets[i] = (L + (((R - L) * rx) >> 16)) * 0.001f;
+  }
+
+}
 
-  #define CELL_INDEX(A,V) ((V - data.bilinear_start.A) * ABL_BG_FACTOR(A))
+#if ENABLED(MESH_BICUBIC_INTERPOLATION)
+
+  float AutoBedLevel::bicubic_z_offset(const xy_pos_t &raw) {
+    // Grid position, the node is constrained within bounds
+    const xy_pos_t g = (raw - data.bilinear_start.asFloat()) * bilinear_grid_factor;
+    const int8_t gx = constrain(int16_t(FLOOR(g.x)), 0, GRID_MAX_POINTS_X - 1),
+                 gy = constrain(int16_t(FLOOR(g.y)), 0, GRID_MAX_POINTS_Y - 1);
+    return bicubic.get_z(gx, gy, g.x - gx, g.y - gy);
+  }
+
+#endif
+
+void AutoBedLevel::bilinear_z_batch_line(const xy_pos_t &start, const xy_float_t &step, const uint8_t count) {
+
+  batch_count = MIN(count, ABL_BATCH_POINTS);
+
+  xy_pos_t pos = start;
+  LOOP_L_N(i, batch_count) {
+    pos += step;
+    batch_points[i] = pos;
+  }
+
+  bilinear_z_offsets(batch_points, batch_offsets, batch_count);
+  batch_index = 0;
+
+}
+
+#if !IS_KINEMATIC
 
   /**
    * Prepare a bilinear-leveled linear move on Cartesian,
    * splitting the move where it crosses mesh borders.
    */
-  void AutoBedLevel::line_to_destination(const feedrate_t scaled_fr_mm_s, uint16_t x_splits/*= 0xFFFF*/, uint16_t y_splits/*= 0xFFFF*/) {
-
-    // Get current and destination cells for this line
-    xy_int_t  c1 { CELL_INDEX(x, mechanics.position.x),     CELL_INDEX(y, mechanics.position.y) },
-              c2 { CELL_INDEX(x, mechanics.destination.x),  CELL_INDEX(y, mechanics.destination.y) };
+  void AutoBedLevel::line_to_destination(const feedrate_t scaled_fr_mm_s) {
 
-    LIMIT(c1.x, 0, ABL_BG_POINTS_X - 2);
-    LIMIT(c1.y, 0, ABL_BG_POINTS_Y - 2);
-    LIMIT(c2.x, 0, ABL_BG_POINTS_X - 2);
-    LIMIT(c2.y, 0, ABL_BG_POINTS_Y - 2);
+    MeshCellWalk walk(mechanics.position, mechanics.destination,
+                      data.bilinear_start.asFloat(),
+                      { ABL_BG_SPACING(x), ABL_BG_SPACING(y) },
+                      { ABL_BG_POINTS_X - 1, ABL_BG_POINTS_Y - 1 });
 
-    // Start and end on same mesh square
-    if (c1 == c2) {
+    while (walk.next(mechanics.destination)) {
       mechanics.line_to_destination(scaled_fr_mm_s);
       mechanics.position = mechanics.destination;
-      return;
-    }
-
-    #define LINE_SEGMENT_END(A) (mechanics.position.A + (mechanics.destination.A - mechanics.position.A) * normalized_dist)
-
-    xyze_pos_t end;
-    float normalized_dist;
-    const xy_int8_t gc { MAX(c1.x, c2.x), MAX(c1.y, c2.y) };
-
-    // Crosses on the X and not already split on this X?
-    // The x_splits flags are insurance against rounding errors.
-    if (c2.x != c1.x && TEST(x_splits, gc.x)) {
-      // Split on the X grid line
-      CBI(x_splits, gc.x);
-      end = mechanics.destination;
-      mechanics.destination.x = data.bilinear_start.x + ABL_BG_SPACING(x) * gc.x;
-      normalized_dist = (mechanics.destination.x - mechanics.position.x) / (end.x - mechanics.position.x);
-      mechanics.destination.y = LINE_SEGMENT_END(y);
-    }
-    // Crosses on the Y and not already split on this Y?
-    else if (c2.y != c1.y && TEST(y_splits, gc.y)) {
-      CBI(y_splits, gc.y);
-      COPY_ARRAY(end, mechanics.destination);
-      mechanics.destination.y = data.bilinear_start.y + ABL_BG_SPACING(y) * gc.y;
-      normalized_dist = (mechanics.destination.y - mechanics.position.y) / (end.y - mechanics.position.y);
-      mechanics.destination.x = LINE_SEGMENT_END(x);
     }
-    else {
-      // Must already have been split on these border(s)
-      // This should be a rare case.
-      mechanics.line_to_destination(scaled_fr_mm_s);
-      mechanics.position = mechanics.destination;
-      return;
-    }
-
-    mechanics.destination.z = LINE_SEGMENT_END(z);
-    mechanics.destination.e = LINE_SEGMENT_END(e);
-
-    // Do the split and look for more borders
-    line_to_destination(scaled_fr_mm_s, x_splits, y_splits);
 
-    // Restore destination from stack
-    mechanics.destination = end;
-    line_to_destination(scaled_fr_mm_s, x_splits, y_splits);
   }
 
 #endif // !IS_KINEMATIC
@@ -21,6 +21,9 @@
  */
 #pragma once
 
+// Points of a segmented line leveled in one pass
+#define ABL_BATCH_POINTS 16
+
 // Struct ABL data
 typedef struct {
   xy_pos_t    bilinear_grid_spacing,
@@ -42,6 +45,11 @@ class AutoBedLevel {
 
     static xy_float_t bilinear_grid_factor;
 
+    static xy_pos_t   batch_points[ABL_BATCH_POINTS];
+    static float      batch_offsets[ABL_BATCH_POINTS];
+    static uint8_t    batch_index,
+                      batch_count;
+
     #if ENABLED(ABL_BILINEAR_SUBDIVISION)
       #define ABL_GRID_POINTS_VIRT_X (GRID_MAX_POINTS_X - 1) * (BILINEAR_SUBDIVISIONS) + 1
       #define ABL_GRID_POINTS_VIRT_Y (GRID_MAX_POINTS_Y - 1) * (BILINEAR_SUBDIVISIONS) + 1
@@ -55,6 +63,20 @@ class AutoBedLevel {
   public: /** Public Function */
 
     static float bilinear_z_offset(const xy_pos_t &raw);
+
+    /**
+     * Z offsets of an array of points in one pass.
+     * The grid position is computed in 16.16 fixed point and the
+     * corners of a cell are read only when the cell changes.
+     */
+    static void bilinear_z_offsets(const xy_pos_t points[], float offsets[], const uint8_t count);
+
+    /**
+     * Level in one pass the next count points of a segmented line,
+     * start + step, start + 2 * step, ... added as the caller does.
+     * bilinear_z_offset returns them as the points are queued.
+     */
+    static void bilinear_z_batch_line(const xy_pos_t &start, const xy_float_t &step, const uint8_t count);
     static void refresh_bed_level();
 
     /**
@@ -71,7 +93,7 @@ class AutoBedLevel {
     #endif
 
     #if !IS_KINEMATIC
-      static void line_to_destination(const feedrate_t scaled_fr_mm_s, uint16_t x_splits=0xFFFF, uint16_t y_splits=0xFFFF);
+      static void line_to_destination(const feedrate_t scaled_fr_mm_s);
     #endif
 
   private: /** Private Function */
@@ -87,6 +109,10 @@ class AutoBedLevel {
       static float bed_level_virt_2cmr(const uint8_t x, const uint8_t y, const float &tx, const float &ty);
     #endif
 
+    #if ENABLED(MESH_BICUBIC_INTERPOLATION)
+      static float bicubic_z_offset(const xy_pos_t &raw);
+    #endif
+
 };
 
 extern AutoBedLevel abl;
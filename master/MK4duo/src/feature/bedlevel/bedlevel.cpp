@@ -163,6 +163,11 @@ void Bedlevel::set_bed_leveling_enabled(const bool enable/*=true*/) {
     constexpr bool can_change = true;
   #endif
 
+  #if HAS_MESH
+    // The mesh may have been loaded or edited since leveling was enabled
+    if (can_change && enable) refresh_mesh();
+  #endif
+
   if (can_change && enable != flag.leveling_active) {
 
     planner.synchronize();
@@ -215,6 +220,20 @@ void Bedlevel::set_bed_leveling_enabled(const bool enable/*=true*/) {
 
 #endif // LEVELING_FADE_HEIGHT
 
+#if HAS_MESH
+
+  /**
+   * Rebuild what is derived from the mesh. Called by every path
+   * that loads or edits the mesh, G29, M421, EEPROM and enable.
+   */
+  void Bedlevel::refresh_mesh() {
+    #if ENABLED(MESH_BICUBIC_INTERPOLATION)
+      bicubic.refresh(Z_VALUES_ARR);
+    #endif
+  }
+
+#endif
+
 /**
  * Reset calibration results to zero.
  */
@@ -44,6 +44,12 @@
 
   typedef float bed_mesh_t[GRID_MAX_POINTS_X][GRID_MAX_POINTS_Y];
 
+  #include "cellwalk/cellwalk.h"
+
+  #if ENABLED(MESH_BICUBIC_INTERPOLATION)
+    #include "bicubic/bicubic.h"
+  #endif
+
   #if ENABLED(AUTO_BED_LEVELING_BILINEAR)
     #include "abl/abl.h"
   #elif HAS_UBL
@@ -137,6 +143,10 @@ class Bedlevel {
     static void set_bed_leveling_enabled(const bool enable=true);
     static void reset();
 
+    #if HAS_MESH
+      static void refresh_mesh();
+    #endif
+
     FORCE_INLINE static void restore_bed_leveling_state() { set_bed_leveling_enabled(flag.leveling_previous); }
 
     #if ENABLED(ENABLE_LEVELING_FADE_HEIGHT)
@@ -0,0 +1,101 @@
+/**
+ * MK4duo Firmware for 3D Printer, Laser and CNC
+ *
+ * Based on Marlin, Sprinter and grbl
+ * Copyright (c) 2011 Camiel Gubbels / Erik van der Zalm
+ * Copyright (c) 2020 Alberto Cotronei @MagoKimbra
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program. If not, see <http://www.gnu.org/licenses/>.
+ *
+ */
+
+/**
+ * bicubic.cpp - Bicubic interpolation of the bed mesh
+ *
+ * Each cell is a Catmull-Rom patch of its 4x4 neighbour nodes, so the
+ * correction and its slope are continuous across the cell edges and
+ * the patch passes through the probed points.
+ * Neighbours off the mesh or undefined are extrapolated from the cell.
+ *
+ * Copyright (c) 2020 Alberto Cotronei @MagoKimbra
+ */
+
+#include "../../../../MK4duo.h"
+
+#if ENABLED(MESH_BICUBIC_INTERPOLATION)
+
+MeshBicubic bicubic;
+
+/** Private Parameters */
+float MeshBicubic::coeff[GRID_MAX_POINTS_X - 1][GRID_MAX_POINTS_Y - 1][4][4];
+
+/** Public Function */
+void MeshBicubic::refresh(const bed_mesh_t &z_values) {
+
+  // Catmull-Rom basis, coefficients of t^k from P[-1..2]
+  static constexpr float M[4][4] = {
+    {  0.0f,  1.0f,  0.0f,  0.0f },
+    { -0.5f,  0.0f,  0.5f,  0.0f },
+    {  1.0f, -2.5f,  2.0f, -0.5f },
+    { -0.5f,  1.5f, -1.5f,  0.5f }
+  };
+
+  for (uint8_t cx = 0; cx < GRID_MAX_POINTS_X - 1; cx++) {
+    for (uint8_t cy = 0; cy < GRID_MAX_POINTS_Y - 1; cy++) {
+
+      const float z00 = z_values[cx][cy],     z10 = z_values[cx + 1][cy],
+                  z01 = z_values[cx][cy + 1], z11 = z_values[cx + 1][cy + 1];
+
+      float (&a)[4][4] = coeff[cx][cy];
+
+      // The cell has an undefined corner
+      if (isnan(z00) || isnan(z10) || isnan(z01) || isnan(z11)) {
+        LOOP_L_N(i, 4) LOOP_L_N(j, 4) a[i][j] = NAN;
+        continue;
+      }
+
+      // Neighbour nodes
+      float P[4][4];
+      LOOP_L_N(m, 4) {
+        LOOP_L_N(n, 4) {
+          const int8_t x = cx + m - 1, y = cy + n - 1;
+          float z = (WITHIN(x, 0, GRID_MAX_POINTS_X - 1) && WITHIN(y, 0, GRID_MAX_POINTS_Y - 1)) ? z_values[x][y] : NAN;
+          if (isnan(z)) {
+            // Bilinear extrapolation of the cell
+            const float u = m - 1, v = n - 1,
+                        z0 = z00 + (z10 - z00) * u,
+                        z1 = z01 + (z11 - z01) * u;
+            z = z0 + (z1 - z0) * v;
+          }
+          P[m][n] = z;
+        }
+      }
+
+      // a = M * P * Mt
+      float T[4][4];
+      LOOP_L_N(i, 4) LOOP_L_N(n, 4) {
+        T[i][n] = 0.0f;
+        LOOP_L_N(m, 4) T[i][n] += M[i][m] * P[m][n];
+      }
+      LOOP_L_N(i, 4) LOOP_L_N(j, 4) {
+        a[i][j] = 0.0f;
+        LOOP_L_N(n, 4) a[i][j] += T[i][n] * M[j][n];
+      }
+
+    }
+  }
+
+}
+
+#endif // ENABLED(MESH_BICUBIC_INTERPOLATION)
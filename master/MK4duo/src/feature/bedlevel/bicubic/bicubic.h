@@ -0,0 +1,73 @@
+/**
+ * MK4duo Firmware for 3D Printer, Laser and CNC
+ *
+ * Based on Marlin, Sprinter and grbl
+ * Copyright (c) 2011 Camiel Gubbels / Erik van der Zalm
+ * Copyright (c) 2020 Alberto Cotronei @MagoKimbra
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program. If not, see <http://www.gnu.org/licenses/>.
+ *
+ */
+#pragma once
+
+/**
+ * bicubic.h - Bicubic interpolation of the bed mesh
+ *
+ * Copyright (c) 2020 Alberto Cotronei @MagoKimbra
+ */
+
+#if ENABLED(MESH_BICUBIC_INTERPOLATION)
+
+class MeshBicubic {
+
+  public: /** Constructor */
+
+    MeshBicubic() {}
+
+  private: /** Private Parameters */
+
+    // Patch coefficients of each cell, a[i][j] of fx^i * fy^j
+    static float coeff[GRID_MAX_POINTS_X - 1][GRID_MAX_POINTS_Y - 1][4][4];
+
+  public: /** Public Function */
+
+    /**
+     * Compute the Catmull-Rom patch of every cell of the mesh.
+     * Call after the mesh is changed.
+     */
+    static void refresh(const bed_mesh_t &z_values);
+
+    /**
+     * Z of the mesh at node (cx, cy) plus the fraction (fx, fy)
+     * of a cell, with 16 multiply-adds. The node may be the last
+     * of the mesh. Outside the mesh the edge is held.
+     * Returns NAN on a cell with an undefined corner.
+     */
+    static float get_z(int8_t cx, int8_t cy, float fx, float fy) {
+      if (cx > GRID_MAX_POINTS_X - 2) { cx = GRID_MAX_POINTS_X - 2; fx += 1.0f; }
+      if (cy > GRID_MAX_POINTS_Y - 2) { cy = GRID_MAX_POINTS_Y - 2; fy += 1.0f; }
+      LIMIT(fx, 0.0f, 1.0f);
+      LIMIT(fy, 0.0f, 1.0f);
+
+      const float (&a)[4][4] = coeff[cx][cy];
+      float b[4];
+      LOOP_L_N(i, 4) b[i] = ((a[i][3] * fy + a[i][2]) * fy + a[i][1]) * fy + a[i][0];
+      return ((b[3] * fx + b[2]) * fx + b[1]) * fx + b[0];
+    }
+
+};
+
+extern MeshBicubic bicubic;
+
+#endif // ENABLED(MESH_BICUBIC_INTERPOLATION)
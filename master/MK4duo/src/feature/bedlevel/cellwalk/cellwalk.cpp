@@ -0,0 +1,93 @@
+/**
+ * MK4duo Firmware for 3D Printer, Laser and CNC
+ *
+ * Based on Marlin, Sprinter and grbl
+ * Copyright (c) 2011 Camiel Gubbels / Erik van der Zalm
+ * Copyright (c) 2020 Alberto Cotronei @MagoKimbra
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program. If not, see <http://www.gnu.org/licenses/>.
+ *
+ */
+
+/**
+ * cellwalk.cpp - Split a line where it crosses the mesh grid lines
+ *
+ * A DDA over the grid lines shared by MBL, ABL and UBL: the crossings
+ * of the X and Y grid lines are merged in order of the line parameter,
+ * in one pass and without recursion.
+ *
+ * Copyright (c) 2020 Alberto Cotronei @MagoKimbra
+ */
+
+#include "../../../../MK4duo.h"
+
+#if HAS_MESH
+
+MeshCellWalk::MeshCellWalk(const xyze_pos_t &start_p, const xyze_pos_t &end_p, const xy_pos_t &origin_p, const xy_float_t &spacing_p, const xy_uint8_t &cells) {
+
+  start   = start_p;
+  end     = end_p;
+  dist    = end - start;
+  origin  = origin_p;
+  spacing = spacing_p;
+  done    = false;
+
+  LOOP_XY(i) {
+    // Cells of the line ends, constrained within bounds
+    int16_t c1 = FLOOR((start[i] - origin[i]) / spacing[i]),
+            c2 = FLOOR((end[i] - origin[i]) / spacing[i]);
+    LIMIT(c1, 0, cells[i] - 1);
+    LIMIT(c2, 0, cells[i] - 1);
+
+    inv_dist[i] = dist[i] ? 1.0f / dist[i] : 0.0f;
+    cross[i]    = ABS(c2 - c1);
+    dir[i]      = c2 < c1 ? -1 : 1;
+    line[i]     = c2 < c1 ? c1 : c1 + 1;
+  }
+
+}
+
+bool MeshCellWalk::next(xyze_pos_t &point) {
+
+  if (done) return false;
+
+  while (cross.x || cross.y) {
+
+    // Line parameter of the next X and Y grid line
+    const float gx = origin.x + line.x * spacing.x,
+                gy = origin.y + line.y * spacing.y,
+                tx = cross.x ? (gx - start.x) * inv_dist.x : 2.0f,
+                ty = cross.y ? (gy - start.y) * inv_dist.y : 2.0f,
+                t  = MIN(tx, ty);
+
+    const bool on_x = tx <= t, on_y = ty <= t;
+    if (on_x) { line.x += dir.x; cross.x--; }
+    if (on_y) { line.y += dir.y; cross.y--; }
+
+    // A line starting or ending on a grid line has nothing to split there
+    if (t <= 0.0f || t >= 1.0f) continue;
+
+    point = start + dist * t;
+    if (on_x) point.x = gx;
+    if (on_y) point.y = gy;
+    return true;
+  }
+
+  point = end;
+  done = true;
+  return true;
+
+}
+
+#endif // HAS_MESH
@@ -0,0 +1,64 @@
+/**
+ * MK4duo Firmware for 3D Printer, Laser and CNC
+ *
+ * Based on Marlin, Sprinter and grbl
+ * Copyright (c) 2011 Camiel Gubbels / Erik van der Zalm
+ * Copyright (c) 2020 Alberto Cotronei @MagoKimbra
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program. If not, see <http://www.gnu.org/licenses/>.
+ *
+ */
+#pragma once
+
+/**
+ * cellwalk.h - Split a line where it crosses the mesh grid lines
+ *
+ * Copyright (c) 2020 Alberto Cotronei @MagoKimbra
+ */
+
+class MeshCellWalk {
+
+  public: /** Constructor */
+
+    /**
+     * Walk the line from start to end over a mesh with the first grid
+     * line at origin, the given spacing and cells per axis.
+     * Positions past the first or the last cell belong to that cell,
+     * so only the grid lines between the cells split the line.
+     */
+    MeshCellWalk(const xyze_pos_t &start_p, const xyze_pos_t &end_p, const xy_pos_t &origin_p, const xy_float_t &spacing_p, const xy_uint8_t &cells);
+
+  private: /** Private Parameters */
+
+    xyze_pos_t    start, end;
+    xyze_float_t  dist;
+    xy_pos_t      origin;
+    xy_float_t    spacing,
+                  inv_dist;
+    xy_int8_t     line,     // Next grid line crossed
+                  dir;      // Grid line increment
+    xy_uint8_t    cross;    // Grid lines still to cross
+    bool          done;
+
+  public: /** Public Function */
+
+    /**
+     * Get the end of the next sub-segment, in order along the line.
+     * Crossings are exactly on the grid line, a crossing on a grid
+     * node gives one sub-segment. The last one is the line end.
+     * Returns false when the line is done.
+     */
+    bool next(xyze_pos_t &point);
+
+};
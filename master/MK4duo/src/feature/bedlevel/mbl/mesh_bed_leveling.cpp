@@ -45,63 +45,19 @@ void mesh_bed_leveling::factory_parameters() {
  * Prepare a mesh-leveled linear move in a Cartesian setup,
  * splitting the move where it crosses mesh borders.
  */
-void mesh_bed_leveling::line_to_destination(const feedrate_t &scaled_fr_mm_s, uint8_t x_splits/*=0xFF*/, uint8_t y_splits/*=0xFF*/) {
-  // Get current and destination cells for this line
-  xy_int8_t scel = cell_indexes(mechanics.position), ecel = cell_indexes(mechanics.destination);
-  NOMORE(scel.x, GRID_MAX_POINTS_X - 2);
-  NOMORE(scel.y, GRID_MAX_POINTS_Y - 2);
-  NOMORE(ecel.x, GRID_MAX_POINTS_X - 2);
-  NOMORE(ecel.y, GRID_MAX_POINTS_Y - 2);
+void mesh_bed_leveling::line_to_destination(const feedrate_t &scaled_fr_mm_s) {
 
-  // Start and end in the same cell? No split needed.
-  if (scel == ecel) {
-    mechanics.line_to_destination(scaled_fr_mm_s);
-    mechanics.position = mechanics.destination;
-    return;
-  }
-
-  #define MBL_SEGMENT_END(A) (mechanics.position.A + (mechanics.destination.A - mechanics.position.A) * normalized_dist)
-
-  float normalized_dist;
-  xyze_pos_t end;
-  const int8_t gcx = MAX(scel.x, ecel.x), gcy = MAX(scel.y, ecel.y);
+  MeshCellWalk walk(mechanics.position, mechanics.destination,
+                    { MESH_MIN_X, MESH_MIN_Y },
+                    { MESH_X_DIST, MESH_Y_DIST },
+                    { GRID_MAX_POINTS_X - 1, GRID_MAX_POINTS_Y - 1 });
 
-  // Crosses on the X and not already split on this X?
-  // The x_splits flags are insurance against rounding errors.
-  if (ecel.x != scel.x && TEST(x_splits, gcx)) {
-    // Split on the X grid line
-    CBI(x_splits, gcx);
-    end = mechanics.destination;
-    mechanics.destination.x = data.index_to_xpos[gcx];
-    normalized_dist = (mechanics.destination.x - mechanics.position.x) / (end.x - mechanics.position.x);
-    mechanics.destination.y = MBL_SEGMENT_END(y);
-  }
-  // Crosses on the Y and not already split on this Y?
-  else if (ecel.y != scel.y && TEST(y_splits, gcy)) {
-    // Split on the Y grid line
-    CBI(y_splits, gcy);
-    end = mechanics.destination;
-    mechanics.destination.y = data.index_to_ypos[gcy];
-    normalized_dist = (mechanics.destination.y - mechanics.position.y) / (end.y - mechanics.position.y);
-    mechanics.destination.x = MBL_SEGMENT_END(x);
-  }
-  else {
-    // Must already have been split on these border(s)
-    // This should be a rare case.
+  // Split the line where it crosses the mesh lines
+  while (walk.next(mechanics.destination)) {
     mechanics.line_to_destination(scaled_fr_mm_s);
     mechanics.position = mechanics.destination;
-    return;
   }
 
-  mechanics.destination.z = MBL_SEGMENT_END(z);
-  mechanics.destination.e = MBL_SEGMENT_END(e);
-
-  // Do the split and look for more borders
-  line_to_destination(scaled_fr_mm_s, x_splits, y_splits);
-
-  // Restore destination from stack
-  mechanics.destination = end;
-  line_to_destination(scaled_fr_mm_s, x_splits, y_splits);
 }
 
 void mesh_bed_leveling::report_mesh() {
@@ -51,7 +51,7 @@ class mesh_bed_leveling {
 
     static void set_z(const int8_t px, const int8_t py, const float &z) { data.z_values[px][py] = z; }
 
-    static void line_to_destination(const feedrate_t &scaled_fr_mm_s, uint8_t x_splits=0xFF, uint8_t y_splits=0xFF);
+    static void line_to_destination(const feedrate_t &scaled_fr_mm_s);
 
     static void report_mesh();
 
@@ -117,6 +117,12 @@ class mesh_bed_leveling {
         constexpr float factor = 1.0f;
       #endif
       const xy_int8_t ind = cell_indexes(pos);
+      #if ENABLED(MESH_BICUBIC_INTERPOLATION)
+        const float z0 = bicubic.get_z(ind.x, ind.y,
+                                       (pos.x - data.index_to_xpos[ind.x]) * RECIPROCAL(MESH_X_DIST),
+                                       (pos.y - data.index_to_ypos[ind.y]) * RECIPROCAL(MESH_Y_DIST));
+        return data.z_offset + z0 * factor;
+      #endif
       const float x1 = data.index_to_xpos[ind.x], x2 = data.index_to_xpos[ind.x + 1],
                   y1 = data.index_to_xpos[ind.y], y2 = data.index_to_xpos[ind.y + 1],
                   z1 = calc_z0(pos.x, x1, data.z_values[ind.x][ind.y    ], x2, data.z_values[ind.x + 1][ind.y    ]),
@@ -89,6 +89,17 @@ static_assert(1 >= 0
   #error "DEPENDENCY ERROR: ENABLE_LEVELING_FADE_HEIGHT requires Bed Level."
 #endif
 
+/**
+ * MESH_BICUBIC_INTERPOLATION requirements
+ */
+#if ENABLED(MESH_BICUBIC_INTERPOLATION)
+  #if !HAS_MESH
+    #error "DEPENDENCY ERROR: MESH_BICUBIC_INTERPOLATION requires MESH_BED_LEVELING, AUTO_BED_LEVELING_BILINEAR, or AUTO_BED_LEVELING_UBL."
+  #elif ENABLED(ABL_BILINEAR_SUBDIVISION)
+    #error "DEPENDENCY ERROR: MESH_BICUBIC_INTERPOLATION is not compatible with ABL_BILINEAR_SUBDIVISION."
+  #endif
+#endif
+
 #if !HAS_MESH && ENABLED(G26_MESH_VALIDATION)
   #error "DEPENDENCY ERROR: G26_MESH_VALIDATION requires MESH_BED_LEVELING, AUTO_BED_LEVELING_BILINEAR, or AUTO_BED_LEVELING_UBL."
 #endif
@@ -174,73 +174,6 @@ class unified_bed_leveling {
       return z1 + (z2 - z1) * (a0 - a1) / (a2 - a1);
     }
 
-    /**
-     * z_correction_for_x_on_horizontal_mesh_line is an optimization for
-     * the case where the printer is making a vertical line that only crosses horizontal mesh lines.
-     */
-    static inline float z_correction_for_x_on_horizontal_mesh_line(const float &rx0, const int x1_i, const int yi) {
-      if (!WITHIN(x1_i, 0, GRID_MAX_POINTS_X - 1) || !WITHIN(yi, 0, GRID_MAX_POINTS_Y - 1)) {
-
-        if (printer.debugFeature()) {
-          if (WITHIN(x1_i, 0, GRID_MAX_POINTS_X - 1)) DEBUG_MSG("yi"); else DEBUG_MSG("x1_i");
-          DEBUG_MV(" out of bounds in z_correction_for_x_on_horizontal_mesh_line(rx0=", rx0);
-          DEBUG_MV(",x1_i=", x1_i);
-          DEBUG_MV(",yi=", yi);
-          DEBUG_CHR(')');
-          DEBUG_EOL();
-        }
-
-        // The requested location is off the mesh. Return UBL_Z_RAISE_WHEN_OFF_MESH or NAN.
-        return (
-          #if ENABLED(UBL_Z_RAISE_WHEN_OFF_MESH)
-            UBL_Z_RAISE_WHEN_OFF_MESH
-          #else
-            NAN
-          #endif
-        );
-      }
-
-      const float xratio  = (rx0 - mesh_index_to_xpos(x1_i)) * RECIPROCAL(MESH_X_DIST),
-                  z1      = z_values[x1_i][yi];
-
-      return z1 + xratio * (z_values[MIN(x1_i, GRID_MAX_POINTS_X - 2) + 1][yi] - z1); // Don't allow x1_i+1 to be past the end of the array
-                                                                                      // If it is, it is clamped to the last element of the
-                                                                                      // z_values[][] array and no correction is applied.
-    }
-
-    //
-    // See comments above for z_correction_for_x_on_horizontal_mesh_line
-    //
-    static inline float z_correction_for_y_on_vertical_mesh_line(const float &ry0, const int xi, const int y1_i) {
-      if (!WITHIN(xi, 0, GRID_MAX_POINTS_X - 1) || !WITHIN(y1_i, 0, GRID_MAX_POINTS_Y - 1)) {
-
-        if (printer.debugFeature()) {
-          if (WITHIN(xi, 0, GRID_MAX_POINTS_X - 1)) DEBUG_MSG("y1_i"); else DEBUG_MSG("xi");
-          DEBUG_MV(" out of bounds in z_correction_for_y_on_vertical_mesh_line(ry0=", ry0);
-          DEBUG_MV(", xi=", xi);
-          DEBUG_MV(", y1_i=", y1_i);
-          DEBUG_CHR(')');
-          DEBUG_EOL();
-        }
-
-        // The requested location is off the mesh. Return UBL_Z_RAISE_WHEN_OFF_MESH or NAN.
-        return (
-          #if ENABLED(UBL_Z_RAISE_WHEN_OFF_MESH)
-            UBL_Z_RAISE_WHEN_OFF_MESH
-          #else
-            NAN
-          #endif
-        );
-      }
-
-      const float yratio  = (ry0 - mesh_index_to_ypos(y1_i)) * RECIPROCAL(MESH_Y_DIST),
-                  z1      = z_values[xi][y1_i];
-
-      return z1 + yratio * (z_values[xi][MIN(y1_i, GRID_MAX_POINTS_Y - 2) + 1] - z1); // Don't allow y1_i+1 to be past the end of the array
-                                                                                      // If it is, it is clamped to the last element of the
-                                                                                      // z_values[][] array and no correction is applied.
-    }
-
     /**
      * This is the generic Z-Correction. It works anywhere within a Mesh Cell. It first
      * does a linear interpolation along both of the bounding X-Mesh-Lines to find the
@@ -260,6 +193,14 @@ class unified_bed_leveling {
           return UBL_Z_RAISE_WHEN_OFF_MESH;
       #endif
 
+      #if ENABLED(MESH_BICUBIC_INTERPOLATION)
+
+        float z0 = bicubic.get_z(cx, cy,
+                                 (rx0 - mesh_index_to_xpos(cx)) * RECIPROCAL(MESH_X_DIST),
+                                 (ry0 - mesh_index_to_ypos(cy)) * RECIPROCAL(MESH_Y_DIST));
+
+      #else
+
       const float z1 = calc_z0(rx0,
                                mesh_index_to_xpos(cx), z_values[cx][cy],
                                mesh_index_to_xpos(cx + 1), z_values[MIN(cx, GRID_MAX_POINTS_X - 2) + 1][cy]);
@@ -272,6 +213,8 @@ class unified_bed_leveling {
                          mesh_index_to_ypos(cy), z1,
                          mesh_index_to_ypos(cy + 1), z2);
 
+      #endif
+
       if (printer.debugMesh()) {
         DEBUG_MV(" raw get_z_correction(", rx0);
         DEBUG_CHR(',');
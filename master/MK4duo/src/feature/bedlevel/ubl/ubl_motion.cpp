@@ -31,9 +31,13 @@
 
   void unified_bed_leveling::line_to_destination_cartesian(const feedrate_t &scaled_fr_mm_s, uint8_t extruder) {
     /**
-     * Much of the nozzle movement will be within the same cell. So we will do as little computation
-     * as possible to determine if this is the case. If this move is within the same cell, we will
-     * just do the required Z-Height correction, call the Planner's buffer_line() routine, and leave
+     * Split the move where it crosses the mesh lines and apply the
+     * correction at the ends of each sub-segment, as MBL and ABL do.
+     * The sub-segments are straight, so within a cell the bilinear
+     * correction is exact only along the axes and the bicubic one
+     * is followed by its chord. Positions before the first and past
+     * the last mesh line are a cell of their own on both axes, so
+     * the move is also split at MESH_MIN and MESH_MAX.
      */
     #if HAS_POSITION_MODIFIERS
       xyze_pos_t  start = mechanics.position,
@@ -45,264 +49,20 @@
                         &end    = mechanics.destination;
     #endif
 
-    const xy_int8_t istart = cell_indexes(start), iend = cell_indexes(end);
+    const float fade_scaling_factor = bedlevel.fade_scaling_factor_for_z(end.z);
 
-    // A move within the same cell needs no splitting
-    if (istart == iend) {
+    MeshCellWalk walk(start, end,
+                      { MESH_MIN_X - (MESH_X_DIST), MESH_MIN_Y - (MESH_Y_DIST) },
+                      { MESH_X_DIST, MESH_Y_DIST },
+                      { GRID_MAX_POINTS_X + 1, GRID_MAX_POINTS_Y + 1 });
 
-      // For a move off the bed, use a constant Z raise
-      if (!WITHIN(iend.x, 0, GRID_MAX_POINTS_X - 1) || !WITHIN(iend.y, 0, GRID_MAX_POINTS_Y - 1)) {
-
-        // Note: There is no Z Correction in this case. We are off the grid and don't know what
-        // a reasonable correction would be.  If the user has specified a UBL_Z_RAISE_WHEN_OFF_MESH
-        // value, that will be used instead of a calculated (Bi-Linear interpolation) correction.
-
-        #if ENABLED(UBL_Z_RAISE_WHEN_OFF_MESH)
-          end.z += UBL_Z_RAISE_WHEN_OFF_MESH;
-        #endif
-        planner.buffer_segment(end, scaled_fr_mm_s, extruder);
-        mechanics.position = mechanics.destination;
-        return;
-      }
-
-      FINAL_MOVE:
-
-      // The distance is always MESH_X_DIST so multiply by the constant reciprocal.
-      const float xratio = (end.x - mesh_index_to_xpos(iend.x)) * RECIPROCAL(MESH_X_DIST);
-
-      float z1, z2;
-      if (iend.x >= GRID_MAX_POINTS_X - 1)
-        z1 = z2 = 0.0;
-      else {
-        z1 = z_values[iend.x    ][iend.y    ] + xratio *
-            (z_values[iend.x + 1][iend.y    ] - z_values[iend.x][iend.y    ]),
-        z2 = z_values[iend.x    ][iend.y + 1] + xratio *
-            (z_values[iend.x + 1][iend.y + 1] - z_values[iend.x][iend.y + 1]);
-      }
-
-      // X cell-fraction done. Interpolate the two Z offsets with the Y fraction for the final Z offset.
-      const float yratio = (end.y - mesh_index_to_ypos(iend.y)) * RECIPROCAL(MESH_Y_DIST),
-                  z0 = iend.y < GRID_MAX_POINTS_Y - 1 ? (z1 + (z2 - z1) * yratio) * bedlevel.fade_scaling_factor_for_z(end.z) : 0.0;
-
-      // Undefined parts of the Mesh in z_values[][] are NAN.
-      // Replace NAN corrections with 0.0 to prevent NAN propagation.
-      if (!isnan(z0)) end.z += z0;
-      planner.buffer_segment(end, scaled_fr_mm_s, extruder);
-      mechanics.position = mechanics.destination;
-      return;
+    xyze_pos_t raw;
+    while (walk.next(raw)) {
+      // Undefined parts of the Mesh in z_values[][] are replaced with 0.0 by get_z_correction
+      raw.z += get_z_correction(raw) * fade_scaling_factor;
+      if (!planner.buffer_segment(raw, scaled_fr_mm_s, extruder)) break;
     }
 
-    /**
-     * Past this point the move is known to cross one or more mesh lines. Check for the most common
-     * case - crossing only one X or Y line - after details are worked out to reduce computation.
-     */
-
-    const xy_float_t dist = end - start;
-    const xy_bool_t neg { dist.x < 0, dist.y < 0 };
-    const xy_int8_t ineg { int8_t(neg.x), int8_t(neg.y) };
-    const xy_float_t sign { neg.x ? -1.0f : 1.0f, neg.y ? -1.0f : 1.0f };
-    const xy_int8_t iadd { int8_t(iend.x == istart.x ? 0 : sign.x), int8_t(iend.y == istart.y ? 0 : sign.y) };
-
-    /**
-     * Compute the extruder scaling factor for each partial move, checking for
-     * zero-length moves that would result in an infinite scaling factor.
-     * A float divide is required for this, but then it just multiplies.
-     * Also select a scaling factor based on the larger of the X and Y
-     * components. The larger of the two is used to preserve precision.
-     */
-
-    const xy_float_t ad = sign * dist;
-    const bool use_x_dist = ad.x > ad.y;
-
-    float on_axis_distance = use_x_dist ? dist.x : dist.y,
-          e_position = end.e - start.e,
-          z_position = end.z - start.z;
-
-    const float e_normalized_dist = e_position / on_axis_distance,
-                z_normalized_dist = z_position / on_axis_distance;
-
-    xy_int8_t icell = istart;
-
-    const float ratio = dist.y / dist.x,        // Allow divide by zero
-                c = start.y - ratio * start.x;
-
-    const bool inf_normalized_flag = isinf(e_normalized_dist),
-               inf_ratio_flag = isinf(ratio);
-
-    /**
-     * Handle vertical lines that stay within one column.
-     * These need not be perfectly vertical.
-     */
-    if (iadd.x == 0) {        // Vertical line?
-      icell.y += ineg.y;      // Line going down? Just go to the bottom.
-      while (icell.y != iend.y + ineg.y) {
-        icell.y += iadd.y;
-        const float next_mesh_line_y = mesh_index_to_ypos(icell.y);
-
-        /**
-         * Skip the calculations for an infinite slope.
-         * For others the next X is the same so this can continue.
-         * Calculate X at the next Y mesh line.
-         */
-        const float rx = inf_ratio_flag ? start.x : (next_mesh_line_y - c) / ratio;
-
-        float z0 =  z_correction_for_x_on_horizontal_mesh_line(rx, icell.x, icell.y)
-                    * bedlevel.fade_scaling_factor_for_z(end.z);
-
-        // Undefined parts of the Mesh in z_values[][] are NAN.
-        // Replace NAN corrections with 0.0 to prevent NAN propagation.
-        if (isnan(z0)) z0 = 0.0;
-
-        const float ry = mesh_index_to_ypos(icell.y);
-
-        /**
-         * Without this check, it's possible to generate a zero length move, as in the case where
-         * the line is heading down, starting exactly on a mesh line boundary. Since this is rare
-         * it might be fine to remove this check and let planner.buffer_segment() filter it out.
-         */
-        if (ry != start.y) {
-          if (!inf_normalized_flag) { // fall-through faster than branch
-            on_axis_distance = use_x_dist ? rx - start.x : ry - start.y;
-            e_position = start.e + on_axis_distance * e_normalized_dist;
-            z_position = start.z + on_axis_distance * z_normalized_dist;
-          }
-          else {
-            e_position = end.e;
-            z_position = end.z;
-          }
-
-          planner.buffer_segment(rx, ry, z_position + z0, e_position, scaled_fr_mm_s, extruder);
-        } //else printf("FIRST MOVE PRUNED  ");
-      }
-
-      // At the final destination? Usually not, but when on a Y Mesh Line it's completed.
-      if (xy_pos_t(mechanics.position) != xy_pos_t(end))
-        goto FINAL_MOVE;
-
-      mechanics.position = mechanics.destination;
-      return;
-    }
-
-    /**
-     * Handle horizontal lines that stay within one row.
-     * These need not be perfectly horizontal.
-     */
-    if (iadd.y == 0) {        // Horizontal line?
-      icell.x += ineg.x;      // Heading left? Just go to the left edge of the cell for the first move.
-      while (icell.x != iend.x + ineg.x) {
-        icell.x += iadd.x;
-        const float rx = mesh_index_to_xpos(icell.x);
-        const float ry = ratio * rx + c;  // Calculate Y at the next X mesh line
-
-        float z0 = z_correction_for_y_on_vertical_mesh_line(ry, icell.x, icell.y)
-                    * bedlevel.fade_scaling_factor_for_z(end.z);
-
-        // Undefined parts of the Mesh in z_values[][] are NAN.
-        // Replace NAN corrections with 0.0 to prevent NAN propagation.
-        if (isnan(z0)) z0 = 0.0;
-
-        /**
-         * Without this check, it's possible to generate a zero length move, as in the case where
-         * the line is heading left, starting exactly on a mesh line boundary. Since this is rare
-         * it might be fine to remove this check and let planner.buffer_segment() filter it out.
-         */
-        if (rx != start.x) {
-          if (!inf_normalized_flag) {
-            on_axis_distance = use_x_dist ? rx - start.x : ry - start.y;
-            e_position = start.e + on_axis_distance * e_normalized_dist;  // is based on X or Y because this is a horizontal move
-            z_position = start.z + on_axis_distance * z_normalized_dist;
-          }
-          else {
-            e_position = end.e;
-            z_position = end.z;
-          }
-
-          if (!planner.buffer_segment(rx, ry, z_position + z0, e_position, scaled_fr_mm_s, extruder))
-            break;
-        } //else printf("FIRST MOVE PRUNED  ");
-      }
-
-      if (xy_pos_t(mechanics.position) != xy_pos_t(end))
-        goto FINAL_MOVE;
-
-      mechanics.position = mechanics.destination;
-      return;
-    }
-
-    /**
-     *
-     * Generic case of a line crossing both X and Y Mesh lines.
-     *
-     */
-
-    xy_int8_t cnt = (istart - iend).ABS();
-
-    icell += ineg;
-
-    while (cnt) {
-
-      const float next_mesh_line_x = mesh_index_to_xpos(icell.x + iadd.x),
-                  next_mesh_line_y = mesh_index_to_ypos(icell.y + iadd.y),
-                  ry = ratio * next_mesh_line_x + c,    // Calculate Y at the next X mesh line
-                  rx = (next_mesh_line_y - c) / ratio;  // Calculate X at the next Y mesh line
-                                                        // (No need to worry about ratio == 0.
-                                                        //  In that case, it was already detected
-                                                        //  as a vertical line move above.)
-
-      if (neg.x == (rx > next_mesh_line_x)) {           // Check if we hit the Y line first
-        // Yes!  Crossing a Y Mesh Line next
-        float z0 = z_correction_for_x_on_horizontal_mesh_line(rx, icell.x - ineg.x, icell.y + iadd.y)
-                   * bedlevel.fade_scaling_factor_for_z(end.z);
-
-        // Undefined parts of the Mesh in z_values[][] are NAN.
-        // Replace NAN corrections with 0.0 to prevent NAN propagation.
-        if (isnan(z0)) z0 = 0.0;
-
-        if (!inf_normalized_flag) {
-          on_axis_distance = use_x_dist ? rx - start.x : next_mesh_line_y - start.y;
-          e_position = start.e + on_axis_distance * e_normalized_dist;
-          z_position = start.z + on_axis_distance * z_normalized_dist;
-        }
-        else {
-          e_position = end.e;
-          z_position = end.z;
-        }
-        if (!planner.buffer_segment(rx, next_mesh_line_y, z_position + z0, e_position, scaled_fr_mm_s, extruder))
-          break;
-        icell.y += iadd.y;
-        cnt.y--;
-      }
-      else {
-        // Yes!  Crossing a X Mesh Line next
-        float z0 = z_correction_for_y_on_vertical_mesh_line(ry, icell.x + iadd.x, icell.y - ineg.y)
-                   * bedlevel.fade_scaling_factor_for_z(end.z);
-
-        // Undefined parts of the Mesh in z_values[][] are NAN.
-        // Replace NAN corrections with 0.0 to prevent NAN propagation.
-        if (isnan(z0)) z0 = 0.0;
-
-        if (!inf_normalized_flag) {
-          on_axis_distance = use_x_dist ? next_mesh_line_x - start.x : ry - start.y;
-          e_position = start.e + on_axis_distance * e_normalized_dist;
-          z_position = start.z + on_axis_distance * z_normalized_dist;
-        }
-        else {
-          e_position = end.e;
-          z_position = end.z;
-        }
-
-        if (!planner.buffer_segment(next_mesh_line_x, ry, z_position + z0, e_position, scaled_fr_mm_s, extruder))
-          break;
-        icell.x += iadd.x;
-        cnt.x--;
-      }
-
-      if (cnt.x < 0 || cnt.y < 0) break; // Too far! Exit the loop and go to FINAL_MOVE
-    }
-
-    if (xy_pos_t(mechanics.position) != xy_pos_t(end))
-      goto FINAL_MOVE;
-
     mechanics.position = mechanics.destination;
   }
 
@@ -412,11 +172,16 @@
 
         if (--segments == 0) raw = mechanics.destination; // if this is last segment, use mechanics.destination for exact
 
-        const float z_cxcy = (z_cxy0 + z_cxym * cell.y) // interpolated mesh z height along cell.x at cell.y
-          #if ENABLED(ENABLE_LEVELING_FADE_HEIGHT)
-            * fade_scaling_factor                   // apply fade factor to interpolated mesh height
-          #endif
-        ;
+        #if ENABLED(MESH_BICUBIC_INTERPOLATION)
+          float z_cxcy = bicubic.get_z(icell.x, icell.y, cell.x * RECIPROCAL(MESH_X_DIST), cell.y * RECIPROCAL(MESH_Y_DIST));
+          if (isnan(z_cxcy)) z_cxcy = 0;
+        #else
+          float z_cxcy = z_cxy0 + z_cxym * cell.y;  // interpolated mesh z height along cell.x at cell.y
+        #endif
+
+        #if ENABLED(ENABLE_LEVELING_FADE_HEIGHT)
+          z_cxcy *= fade_scaling_factor;            // apply fade factor to interpolated mesh height
+        #endif
 
         planner.buffer_line(raw.x, raw.y, raw.z + z_cxcy, raw.e, scaled_fr_mm_s, toolManager.extruder.active, segment_xyz_mm);
 
@@ -31,128 +31,99 @@
 
 #if ENABLED(G5_BEZIER)
 
-  // See the meaning in the documentation of cubic_b_spline().
-  #define MIN_STEP 0.002
-  #define MAX_STEP 0.1
-  #define SIGMA 0.1
-
   /**
-   * The algorithm for computing the step is loosely based on the one in Kig
-   * (See https://sources.debian.net/src/kig/4:15.08.3-1/misc/kigpainter.cpp/#L759)
-   * However, we do not use the stack.
-   *
-   * The algorithm goes as it follows: the parameters t runs from 0.0 to
-   * 1.0 describing the curve, which is evaluated by eval_bezier(). At
-   * each iteration we have to choose a step, i.e., the increment of the
-   * t variable. By default the step of the previous iteration is taken,
-   * and then it is enlarged or reduced depending on how straight the
-   * curve locally is. The step is always clamped between MIN_STEP/2 and
-   * 2*MAX_STEP. MAX_STEP is taken at the first iteration.
-   *
-   * For some t, the step value is considered acceptable if the curve in
-   * the interval [t, t+step] is sufficiently straight, i.e.,
-   * sufficiently close to linear interpolation. In practice the
-   * following test is performed: the distance between eval_bezier(...,
-   * t+step/2) is evaluated and compared with 0.5*(eval_bezier(...,
-   * t)+eval_bezier(..., t+step)). If it is smaller than SIGMA, then the
-   * step value is considered acceptable, otherwise it is not. The code
-   * seeks to find the larger step value which is considered acceptable.
-   *
-   * At every iteration the recorded step value is considered and then
-   * iteratively halved until it becomes acceptable. If it was already
-   * acceptable in the beginning (i.e., no halving were done), then
-   * maybe it was necessary to enlarge it; then it is iteratively
-   * doubled while it remains acceptable. The last acceptable value
-   * found is taken, provided that it is between MIN_STEP and MAX_STEP
-   * and does not bring t over 1.0.
-   *
-   * Caveat: this algorithm is not perfect, since it can happen that a
-   * step is considered acceptable even when the curve is not linear at
-   * all in the interval [t, t+step] (but its mid point coincides "by
-   * chance" with the midpoint according to the parametrization). This
-   * kind of glitches can be eliminated with proper first derivative
-   * estimates; however, given the improbability of such configurations,
-   * the mitigation offered by MIN_STEP and the small computational
-   * power available on Arduino, I think it is not wise to implement it.
+   * The curve is flattened in a number of lines of equal parameter step,
+   * taken from the bound of Wang: with M the largest second difference of
+   * the control points, n lines of a cubic are never farther than
+   * 3/4 * M / n^2 from the curve. The points are walked by forward
+   * differences, three additions per axis and point, in two passes: the
+   * first measures the path so the second can spread Z and E on the length
+   * instead of on the parameter.
    */
   void Bezier::cubic_b_spline(const xyze_pos_t position, const xyze_pos_t target, const float offset[4], feedrate_t fr_mm_s, uint8_t extruder) {
 
-    // Absolute first and second control points are recovered.
-    const float first0 = position.x + offset[0],
-                first1 = position.y + offset[1],
-                second0 = target.x + offset[2],
-                second1 = target.y + offset[3];
-    float t = 0.0;
+    // Control points of the curve
+    xy_pos_t p[4];
+    p[0].set(position.x, position.y);
+    p[1].set(position.x + offset[0], position.y + offset[1]);
+    p[2].set(target.x + offset[2], target.y + offset[3]);
+    p[3].set(target.x, target.y);
+
+    const uint16_t segments = get_segments(p, fr_mm_s);
+
+    // Polynomial coefficients and forward differences for a step of 1 / segments
+    const float h = 1.0f / segments, h2 = sq(h), h3 = h2 * h;
+    const xy_pos_t  a = (p[1] - p[2]) * 3 + p[3] - p[0],
+                    b = (p[0] - p[1] * 2 + p[2]) * 3,
+                    c = (p[1] - p[0]) * 3,
+                    d1 = a * h3 + b * h2 + c * h,
+                    d2 = a * (6 * h3) + b * (2 * h2),
+                    d3 = a * (6 * h3);
+
+    // First pass, length of the path
+    float length = 0;
+    xy_pos_t f = p[0], df = d1, ddf = d2;
+    for (uint16_t i = 0; i < segments; i++) {
+      const xy_pos_t last = f;
+      f += df; df += ddf; ddf += d3;
+      length += (f - last).magnitude();
+    }
+    if (length < 0.001f) length = 0.001f;
 
-    xyze_pos_t bez_target;
-    bez_target.x = position.x;
-    bez_target.y = position.y;
-    float step = MAX_STEP;
+    xyze_pos_t bez_target = position;
+    f = p[0]; df = d1; ddf = d2;
+    float travel = 0;
 
     short_timer_t next_idle_timer(millis());
 
-    while (t < 1.0) {
+    for (uint16_t i = 1; i <= segments; i++) {
 
       if (next_idle_timer.expired(200)) printer.idle();
 
-      // First try to reduce the step in order to make it sufficiently
-      // close to a linear interpolation.
-      bool did_reduce = false;
-      float new_t = t + step;
-      NOMORE(new_t, 1.0);
-      float new_pos0 = eval_bezier(position.x, first0, second0, target.x, new_t);
-      float new_pos1 = eval_bezier(position.y, first1, second1, target.y, new_t);
-      for (;;) {
-        if (new_t - t < (MIN_STEP)) break;
-        const float candidate_t = 0.5 * (t + new_t),
-                    candidate_pos0 = eval_bezier(position.x, first0, second0, target.x, candidate_t),
-                    candidate_pos1 = eval_bezier(position.y, first1, second1, target.y, candidate_t),
-                    interp_pos0 = 0.5 * (bez_target.x + new_pos0),
-                    interp_pos1 = 0.5 * (bez_target.y + new_pos1);
-        if (dist1(candidate_pos0, candidate_pos1, interp_pos0, interp_pos1) <= (SIGMA)) break;
-        new_t = candidate_t;
-        new_pos0 = candidate_pos0;
-        new_pos1 = candidate_pos1;
-        did_reduce = true;
-      }
-
-      // If we did not reduce the step, maybe we should enlarge it.
-      if (!did_reduce) for (;;) {
-        if (new_t - t > MAX_STEP) break;
-        const float candidate_t = t + 2.0 * (new_t - t);
-        if (candidate_t >= 1.0) break;
-        const float candidate_pos0 = eval_bezier(position.x, first0, second0, target.x, candidate_t),
-                    candidate_pos1 = eval_bezier(position.y, first1, second1, target.y, candidate_t),
-                    interp_pos0 = 0.5 * (bez_target.x + candidate_pos0),
-                    interp_pos1 = 0.5 * (bez_target.y + candidate_pos1);
-        if (dist1(new_pos0, new_pos1, interp_pos0, interp_pos1) > (SIGMA)) break;
-        new_t = candidate_t;
-        new_pos0 = candidate_pos0;
-        new_pos1 = candidate_pos1;
-      }
-
-      step = new_t - t;
-      t = new_t;
-
-      // Compute and send new position
-      bez_target.x = new_pos0;
-      bez_target.y = new_pos1;
-      // FIXME. The following two are wrong, since the parameter t is
-      // not linear in the distance.
-      bez_target.z = interp(position.z, target.z, t);
-      bez_target.e = interp(position.e, target.e, t);
+      const xy_pos_t last = f;
+      f += df; df += ddf; ddf += d3;
+
+      // The last point is the target itself, whatever the rounding
+      if (i == segments) f = p[3];
+
+      const float segment_mm = (f - last).magnitude();
+      travel += segment_mm;
+      const float fraction = MIN(travel / length, 1.0f);
+
+      bez_target.x = f.x;
+      bez_target.y = f.y;
+      bez_target.z = position.z + (target.z - position.z) * fraction;
+      bez_target.e = position.e + (target.e - position.e) * fraction;
       endstops.apply_motion_limits(bez_target);
 
       #if HAS_LEVELING && !HAS_PLANNER_LEVELING
-        xyze_pos_t pos = { bez_target.x, bez_target.y, bez_target.z, bez_target.e };
-        planner.apply_leveling(pos);
+        xyze_pos_t pos = bez_target;
+        bedlevel.apply_leveling(pos);
       #else
         const xyze_pos_t &pos = bez_target;
       #endif
 
-      if (!planner.buffer_line(bez_target, fr_mm_s, extruder))
+      if (!planner.buffer_line(pos, fr_mm_s, extruder, segment_mm))
         break;
     }
   }
 
+  uint16_t Bezier::get_segments(const xy_pos_t p[4], const feedrate_t fr_mm_s) {
+
+    // Largest second difference of the control points
+    const float m = MAX((p[0] - p[1] * 2 + p[2]).magnitude(), (p[1] - p[2] * 2 + p[3]).magnitude());
+    float segments = SQRT(0.75f * m / (BEZIER_TOLERANCE));
+
+    // Not more lines than the planner runs in the minimum segment time.
+    // The control polygon is never shorter than the curve.
+    const float min_mm = fr_mm_s * mechanics.data.min_segment_time_us * 0.000001f;
+    if (min_mm > 0) {
+      const float polygon = (p[1] - p[0]).magnitude() + (p[2] - p[1]).magnitude() + (p[3] - p[2]).magnitude();
+      NOMORE(segments, polygon / min_mm);
+    }
+
+    NOMORE(segments, 0xFFFF);
+    return segments > 1 ? uint16_t(CEIL(segments)) : 1;
+  }
+
 #endif // G5_BEZIER
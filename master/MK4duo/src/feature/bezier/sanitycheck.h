@@ -26,3 +26,7 @@
  *
  * Test configuration values for errors at compile-time.
  */
+
+#if ENABLED(G5_BEZIER) && BEZIER_TOLERANCE <= 0
+  #error "DEPENDENCY ERROR: BEZIER_TOLERANCE must be greater than 0."
+#endif
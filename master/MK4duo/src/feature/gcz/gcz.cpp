@@ -0,0 +1,125 @@
+/**
+ * MK4duo Firmware for 3D Printer, Laser and CNC
+ *
+ * Based on Marlin, Sprinter and grbl
+ * Copyright (c) 2011 Camiel Gubbels / Erik van der Zalm
+ * Copyright (c) 2020 Alberto Cotronei @MagoKimbra
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program. If not, see <http://www.gnu.org/licenses/>.
+ *
+ */
+
+/**
+ * gcz.cpp - Compressed G-code decoder
+ */
+
+#include "../../../MK4duo.h"
+#include "sanitycheck.h"
+
+#if ENABLED(GCZ_SUPPORT)
+
+GCZDecoder gcz;
+
+/** Private Parameters */
+uint8_t   GCZDecoder::window[GCZ_WINDOW_SIZE];
+
+uint32_t  GCZDecoder::out_count       = 0;
+
+uint16_t  GCZDecoder::head            = 0,
+          GCZDecoder::ref_index       = 0,
+          GCZDecoder::ref_count       = 0;
+
+uint8_t   GCZDecoder::window_bits     = 0,
+          GCZDecoder::lookahead_bits  = 0,
+          GCZDecoder::bit_buffer      = 0,
+          GCZDecoder::bit_count       = 0;
+
+/** Public Function */
+
+/**
+ * Read the header at the current file position and reset the decoder.
+ * Return GCZ_NONE if the file is not compressed, GCZ_UNSUPPORTED if it
+ * has the magic but a bad header or a window bigger than GCZ_WINDOW_BITS.
+ */
+GCZHeaderEnum GCZDecoder::begin() {
+
+  uint8_t header[GCZ_HEADER_SIZE];
+  LOOP_L_N(i, GCZ_HEADER_SIZE) {
+    const int16_t c = card.get();
+    if (c < 0) return GCZ_NONE;
+    header[i] = c;
+  }
+
+  if (header[0] != 'G' || header[1] != 'C' || header[2] != 'Z') return GCZ_NONE;
+
+  window_bits     = header[3] >> 4;
+  lookahead_bits  = header[3] & 0x0F;
+
+  if (window_bits < 4 || window_bits > GCZ_WINDOW_BITS || lookahead_bits < 3 || lookahead_bits >= window_bits) {
+    SERIAL_LMV(ER, "GCZ header not supported, window bits:", int(window_bits));
+    return GCZ_UNSUPPORTED;
+  }
+
+  ZERO(window);
+  head = ref_count = 0;
+  bit_count = 0;
+  out_count = 0;
+  return GCZ_VALID;
+}
+
+/**
+ * Next decompressed character, -1 at the end of the file or on a read error
+ */
+int16_t GCZDecoder::get() {
+
+  if (!ref_count) {
+
+    const int16_t tag = get_bits(1);
+    if (tag < 0) return -1;
+
+    if (tag) {
+      const int16_t c = get_bits(8);
+      return c < 0 ? -1 : put(c);
+    }
+
+    const int16_t index = get_bits(window_bits),
+                  count = get_bits(lookahead_bits);
+    if (index < 0 || count < 0) return -1;
+
+    ref_index = index + 1;
+    ref_count = count + 1;
+  }
+
+  ref_count--;
+  return put(window[(head - ref_index) & (GCZ_WINDOW_SIZE - 1)]);
+}
+
+/** Private Function */
+int16_t GCZDecoder::get_bits(uint8_t n) {
+  uint16_t value = 0;
+  while (n--) {
+    if (!bit_count) {
+      const int16_t c = card.get();
+      if (c < 0) return -1;
+      bit_buffer = c;
+      bit_count = 8;
+    }
+    value = (value << 1) | (bit_buffer >> 7);
+    bit_buffer <<= 1;
+    bit_count--;
+  }
+  return value;
+}
+
+#endif // ENABLED(GCZ_SUPPORT)
@@ -0,0 +1,88 @@
+/**
+ * MK4duo Firmware for 3D Printer, Laser and CNC
+ *
+ * Based on Marlin, Sprinter and grbl
+ * Copyright (c) 2011 Camiel Gubbels / Erik van der Zalm
+ * Copyright (c) 2020 Alberto Cotronei @MagoKimbra
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program. If not, see <http://www.gnu.org/licenses/>.
+ *
+ */
+#pragma once
+
+/**
+ * gcz.h - Compressed G-code decoder
+ *
+ * A .gcz file is a 4 byte header, "GCZ" and (window bits << 4 | lookahead
+ * bits), followed by a heatshrink LZSS bit stream, most significant bit
+ * first:
+ *
+ *  1 + 8 bits                    literal byte
+ *  0 + window + lookahead bits   copy (count + 1) bytes from (index + 1)
+ *                                bytes back in the output
+ *
+ * The decoder pulls the bytes from the open SD file as the G-code reader
+ * asks for characters, so only the window is kept in SRAM.
+ */
+
+#if ENABLED(GCZ_SUPPORT)
+
+#define GCZ_HEADER_SIZE 4
+#define GCZ_WINDOW_SIZE (1 << GCZ_WINDOW_BITS)
+
+class GCZDecoder {
+
+  public: /** Constructor */
+
+    GCZDecoder() {}
+
+  private: /** Private Parameters */
+
+    static uint8_t  window[GCZ_WINDOW_SIZE];  // Last output bytes
+
+    static uint32_t out_count;                // Characters decompressed since begin
+
+    static uint16_t head,                     // Next window position to write
+                    ref_index,                // Back reference being copied
+                    ref_count;
+
+    static uint8_t  window_bits,              // From the file header
+                    lookahead_bits,
+                    bit_buffer,
+                    bit_count;
+
+  public: /** Public Function */
+
+    static GCZHeaderEnum begin();
+    static int16_t get();
+
+    // Decompressed offset of the last character, as sdpos for a plain file
+    static inline uint32_t position() { return out_count ? out_count - 1 : 0; }
+
+  private: /** Private Function */
+
+    static int16_t get_bits(uint8_t n);
+
+    FORCE_INLINE static int16_t put(const uint8_t c) {
+      out_count++;
+      window[head] = c;
+      head = (head + 1) & (GCZ_WINDOW_SIZE - 1);
+      return c;
+    }
+
+};
+
+extern GCZDecoder gcz;
+
+#endif // ENABLED(GCZ_SUPPORT)
@@ -0,0 +1,335 @@
+/**
+ * MK4duo Firmware for 3D Printer, Laser and CNC
+ *
+ * Based on Marlin, Sprinter and grbl
+ * Copyright (c) 2011 Camiel Gubbels / Erik van der Zalm
+ * Copyright (c) 2020 Alberto Cotronei @MagoKimbra
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program. If not, see <http://www.gnu.org/licenses/>.
+ *
+ */
+
+/**
+ * layer_index.cpp - Layer seek table of the SD print file
+ */
+
+#include "../../../MK4duo.h"
+#include "sanitycheck.h"
+
+#if ENABLED(SD_LAYER_INDEX)
+
+LayerIndex layerindex;
+
+/** Private Parameters */
+SdFile          LayerIndex::file;
+
+layer_record_t  LayerIndex::state,
+                LayerIndex::candidate;
+
+float           LayerIndex::layer_z       = 0.0f;
+
+uint32_t        LayerIndex::line_start    = 0;
+
+uint8_t         LayerIndex::seek_count    = 0;
+
+bool            LayerIndex::building      = false,
+                LayerIndex::has_candidate = false;
+
+/** Public Function */
+
+/**
+ * Called when the SD print starts or resumes. Build the index if the
+ * print starts at the beginning of a plain file with no complete index.
+ */
+void LayerIndex::start() {
+
+  if (building && seek_count == card.seek_count) return;  // Resumed after a pause
+
+  close();
+
+  if (card.getIndex() || card.isCompressed()) return;
+
+  layer_header_t header;
+
+  if (open(false)) {
+    const bool done = read_header(header) && header.complete;
+    file.close();
+    if (done) return;
+  }
+
+  make_header(header);
+  if (!open(true)) return;
+  if (file.write(&header, sizeof(header)) != sizeof(header) || !file.sync()) {
+    SERIAL_LM(ER, STR_SD_ERR_WRITE_TO_FILE);
+    file.close();
+    return;
+  }
+
+  memset(&state, 0, sizeof(state));
+  state.e         = mechanics.position.e;
+  state.feedrate  = MMS_TO_MMM(mechanics.feedrate_mm_s);
+  state.relative  = mechanics.axis_relative_modes;
+  state.tool      = toolManager.extruder.active;
+
+  // Heated before the print started, e.g. from the LCD
+  #if HAS_HOTENDS
+    LOOP_HOTEND() if (hotends[h]) state.hotend_target[h] = hotends[h]->deg_target();
+  #endif
+  #if HAS_BEDS
+    LOOP_BED() if (beds[h]) state.bed_target[h] = beds[h]->deg_target();
+  #endif
+  #if HAS_FAN
+    LOOP_FAN() if (fans[f]) state.fan_speed[f] = fans[f]->speed;
+  #endif
+
+  layer_z       = 0.0f;
+  line_start    = 0;
+  has_candidate = false;
+  seek_count    = card.seek_count;
+  building      = true;
+
+}
+
+/**
+ * Follow the parser state through each line read from the file, sdpos
+ * being the position of its end. A Z move is a layer change once the
+ * head extrudes higher than the last layer, so Z hops are not indexed.
+ */
+void LayerIndex::feed(const char * line, const uint32_t sdpos) {
+
+  if (!building) return;
+  if (seek_count != card.seek_count) return close();  // M26 or M24 S, the rest of the file is not read in order
+
+  const uint32_t start = line_start;
+  line_start = sdpos;
+
+  const char *p = line;
+  if (*p == 'N') while (*p && *p != ' ') p++;         // Skip the line number
+  while (*p == ' ') p++;
+
+  const char letter = *p++;
+  if (letter == 'T') {
+    if (NUMERIC(*p)) state.tool = atoi(p);
+    return;
+  }
+  if (letter != 'G' && letter != 'M') return;
+
+  char *end;
+  const long code = strtol(p, &end, 10);
+  if (end == p || *end == '.') return;                // No code, or a subcode like G92.9
+  p = end;
+
+  if (letter == 'M') return feed_M(code, p);
+
+  float value;
+
+  switch (code) {
+    case 90: state.relative = 0; return;
+    case 91: state.relative = _BV(X_AXIS) | _BV(Y_AXIS) | _BV(Z_AXIS) | _BV(E_AXIS); return;
+    case 92:
+      if (seen(p, 'E', value)) state.e = value;
+      if (seen(p, 'Z', value)) state.z = value;
+      return;
+    case 0: case 1: case 2: case 3: break;
+    default: return;
+  }
+
+  const layer_record_t before = state;
+  bool extrude = false;
+
+  if (seen(p, 'F', value)) state.feedrate = value;
+
+  if (seen(p, 'E', value)) {
+    if (TEST(state.relative, E_AXIS)) {
+      extrude = value > 0.0f;
+      state.e += value;
+    }
+    else {
+      extrude = value > state.e;
+      state.e = value;
+    }
+  }
+
+  if (seen(p, 'Z', value)) {
+    state.z = TEST(state.relative, Z_AXIS) ? state.z + value : value;
+    if (state.z != before.z) {
+      candidate       = before;
+      candidate.sdpos = start;
+      candidate.z     = state.z;
+      has_candidate   = true;
+    }
+  }
+
+  if (extrude && has_candidate && candidate.z >= layer_z + LAYER_INDEX_MIN_STEP) {
+    layer_z = candidate.z;
+    has_candidate = false;
+    write_record(candidate);
+  }
+
+}
+
+/**
+ * The whole file has been read, mark the index complete
+ */
+void LayerIndex::finish() {
+  if (building && seek_count == card.seek_count) {
+    layer_header_t header;
+    make_header(header);
+    header.complete = true;
+    if (!file.seekSet(0) || file.write(&header, sizeof(header)) != sizeof(header))
+      SERIAL_LM(ER, STR_SD_ERR_WRITE_TO_FILE);
+  }
+  close();
+}
+
+void LayerIndex::close() {
+  building = false;
+  if (file.isOpen()) file.close();
+}
+
+/**
+ * Look up a layer of the selected file, by number from 0 if layer >= 0,
+ * else the first layer at z or above. The index of an unfinished print
+ * is used as far as it goes.
+ */
+bool LayerIndex::find(layer_record_t &rec, const int16_t layer, const float z) {
+
+  close();
+
+  if (card.isCompressed() || !open(false)) return false;
+
+  layer_header_t header;
+  bool found = false;
+
+  if (read_header(header))
+    for (int16_t l = 0; !found && file.read(&rec, sizeof(rec)) == sizeof(rec); l++)
+      found = layer >= 0 ? l == layer : rec.z >= z - 0.001f;
+
+  file.close();
+  return found;
+}
+
+/** Private Function */
+
+/**
+ * Open the sidecar of the selected file, the same name with a leading
+ * dot, so lsNext does not list it, and ".lyr" in place of the extension.
+ */
+bool LayerIndex::open(const bool build) {
+  char name[sizeof(card.fileName) + 5];
+
+  const char * const slash = strrchr(card.fileName, '/');
+  const uint16_t dir_len = slash ? slash - card.fileName + 1 : 0;
+  memcpy(name, card.fileName, dir_len);
+  name[dir_len] = '.';
+  strcpy(name + dir_len + 1, card.fileName + dir_len);
+
+  char * dot = strrchr(name + dir_len + 1, '.');
+  if (!dot) dot = name + strlen(name);
+  strcpy_P(dot, PSTR(".lyr"));
+
+  return file.open(&card.workDir, name, build ? O_RDWR | O_CREAT | O_TRUNC : O_READ);
+}
+
+/**
+ * Read the header, false if it does not belong to this version of the file
+ */
+bool LayerIndex::read_header(layer_header_t &header) {
+  layer_header_t current;
+  make_header(current);
+  return file.read(&header, sizeof(header)) == sizeof(header)
+      && header.magic == current.magic
+      && header.size  == current.size
+      && header.date  == current.date
+      && header.time  == current.time;
+}
+
+void LayerIndex::make_header(layer_header_t &header) {
+  dir_t dir;
+  card.gcode_file.dirEntry(&dir);
+  memset(&header, 0, sizeof(header));
+  header.magic  = LAYER_INDEX_MAGIC;
+  header.size   = card.fileSize;
+  header.date   = dir.lastWriteDate;
+  header.time   = dir.lastWriteTime;
+}
+
+/**
+ * Append a layer and sync it, so the index made so far is there
+ * after a power loss
+ */
+void LayerIndex::write_record(const layer_record_t &rec) {
+  if (file.write(&rec, sizeof(rec)) != sizeof(rec) || !file.sync()) {
+    SERIAL_LM(ER, STR_SD_ERR_WRITE_TO_FILE);
+    close();
+  }
+}
+
+bool LayerIndex::seen(const char * p, const char c, float &value) {
+  p = strchr(p, c);
+  if (!p) return false;
+  value = strtod(p + 1, nullptr);
+  return true;
+}
+
+/**
+ * The M codes that change the state a layer needs to start: E mode,
+ * temperatures (the waiting codes also with R) and fan speeds
+ */
+void LayerIndex::feed_M(const long code, const char * p) {
+
+  float value, index;
+
+  switch (code) {
+
+    case 82: CBI(state.relative, E_AXIS); return;
+    case 83: SBI(state.relative, E_AXIS); return;
+
+    #if HAS_HOTENDS
+      case 104: case 109: {
+        if (!seen(p, 'S', value) && !(code == 109 && seen(p, 'R', value))) return;
+        const uint8_t tool = seen(p, 'T', index) ? uint8_t(index) : state.tool;
+        // A single hotend takes the temperature of the active tool only, as M104 does
+        if (tempManager.heater.hotends == 1) {
+          if (tool == state.tool) state.hotend_target[0] = value;
+        }
+        else if (tool < tempManager.heater.hotends)
+          state.hotend_target[tool] = value;
+      } return;
+    #endif
+
+    #if HAS_BEDS
+      case 140: case 190: {
+        if (!seen(p, 'S', value) && !(code == 190 && seen(p, 'R', value))) return;
+        const uint8_t b = seen(p, 'T', index) ? uint8_t(index) : 0;
+        if (b < tempManager.heater.beds) state.bed_target[b] = value;
+      } return;
+    #endif
+
+    #if HAS_FAN
+      case 106: case 107: {
+        const uint8_t f = seen(p, 'P', index) ? uint8_t(index) : 0;
+        if (f >= fanManager.data.fans) return;
+        if (code == 107 || !seen(p, 'S', value)) value = code == 107 ? 0 : 255;
+        LIMIT(value, 0, 255);
+        state.fan_speed[f] = value;
+      } return;
+    #endif
+
+    default: return;
+  }
+
+}
+
+#endif // ENABLED(SD_LAYER_INDEX)
@@ -0,0 +1,111 @@
+/**
+ * MK4duo Firmware for 3D Printer, Laser and CNC
+ *
+ * Based on Marlin, Sprinter and grbl
+ * Copyright (c) 2011 Camiel Gubbels / Erik van der Zalm
+ * Copyright (c) 2020 Alberto Cotronei @MagoKimbra
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program. If not, see <http://www.gnu.org/licenses/>.
+ *
+ */
+#pragma once
+
+/**
+ * layer_index.h - Layer seek table of the SD print file
+ *
+ * The first print of a file from its start builds a sidecar file, the
+ * file name with a leading dot (so it is not listed) and the ".lyr"
+ * extension, holding one record per layer: the file position of the line
+ * that moves to the layer, the parser state, temperatures and fan speeds
+ * before it. M24 L or Z look the layer up and start the print there at
+ * once, instead of reading the file up to it.
+ */
+
+#if ENABLED(SD_LAYER_INDEX)
+
+#define LAYER_INDEX_MAGIC     0x3352594CUL  // "LYR3"
+#define LAYER_INDEX_MIN_STEP  0.05f         // Smaller Z steps are not new layers (vase mode)
+#define LAYER_INDEX_ZRAISE    2.0f          // Clearance over the layer before moving to it
+
+typedef struct {
+  uint32_t  magic,
+            size;           // Size, date and time of the print file
+  uint16_t  date,
+            time;
+  bool      complete;       // All the file has been read
+} layer_header_t;
+
+typedef struct {
+  uint32_t  sdpos;          // Start of the line moving to the layer
+  float     z,              // Layer height
+            e,              // Parser state before the line
+            feedrate;       // mm/min
+  uint8_t   relative,       // axis_relative_modes
+            tool;           // Active extruder
+  #if HAS_HOTENDS
+    int16_t hotend_target[MAX_HOTEND];  // Set by the file, 0 = not set
+  #endif
+  #if HAS_BEDS
+    int16_t bed_target[MAX_BED];
+  #endif
+  #if HAS_FAN
+    uint8_t fan_speed[MAX_FAN];
+  #endif
+} layer_record_t;
+
+class LayerIndex {
+
+  public: /** Constructor */
+
+    LayerIndex() {}
+
+  private: /** Private Parameters */
+
+    static SdFile         file;
+
+    static layer_record_t state,        // Shadow of the parser state
+                          candidate;    // Last Z move, a layer once it extrudes
+
+    static float          layer_z;      // Height of the last layer written
+
+    static uint32_t       line_start;
+
+    static uint8_t        seek_count;
+
+    static bool           building,
+                          has_candidate;
+
+  public: /** Public Function */
+
+    static void start();
+    static void feed(const char * line, const uint32_t sdpos);
+    static void finish();
+    static void close();
+
+    static bool find(layer_record_t &rec, const int16_t layer, const float z);
+
+  private: /** Private Function */
+
+    static bool open(const bool build);
+    static bool read_header(layer_header_t &header);
+    static void make_header(layer_header_t &header);
+    static void write_record(const layer_record_t &rec);
+    static bool seen(const char * p, const char c, float &value);
+    static void feed_M(const long code, const char * p);
+
+};
+
+extern LayerIndex layerindex;
+
+#endif // ENABLED(SD_LAYER_INDEX)
@@ -37,6 +37,29 @@ bool  Restart::enabled;
 uint32_t  Restart::cmd_sdpos      = 0,
           Restart::sdpos[BUFSIZE] = { 0 };  
 
+/** Private Parameters */
+uint32_t  Restart::journal_block    = 0,
+          Restart::journal_pos      = 0,
+          Restart::journal_session  = 0,
+          Restart::journal_seq      = 0,
+          Restart::checkpoint_seq   = 0;
+
+uint8_t   Restart::journal_deltas   = 0;
+
+#define RESTART_MAGIC             0x4A52  // "RJ"
+#define RESTART_SECTOR            512
+
+constexpr uint16_t  checkpoint_length = sizeof(restart_record_t) + sizeof(restart_job_t) + 2,
+                    delta_length      = sizeof(restart_record_t) + sizeof(restart_delta_t) + 2;
+
+// The first checkpoint of a journal is never overwritten, records wrap after it
+constexpr uint32_t  journal_start     = ((checkpoint_length + RESTART_SECTOR - 1) / RESTART_SECTOR) * RESTART_SECTOR;
+
+static_assert(delta_length <= RESTART_SECTOR, "restart_delta_t must fit in a card sector.");
+static_assert(journal_start + 2 * checkpoint_length + RESTART_SECTOR <= SD_RESTART_FILE_SIZE, "SD_RESTART_FILE_SIZE is too small for restart_job_t.");
+
+#define NEXT_SECTOR(P)            (((P) | (RESTART_SECTOR - 1)) + 1)
+
 /** Public Function */
 void Restart::enable(const bool onoff) {
   enabled = onoff;
@@ -59,20 +82,23 @@ void Restart::check() {
 }
 
 void Restart::start_job() {
+  close();                      // A new journal is started by the next save
   card.getAbsFilename(job_info.fileName);
   cmd_sdpos = 0;
   ZERO(sdpos);
 }
 
 void Restart::purge_job() {
+  close();
   clear_job();
   card.delete_restart_file();
 }
 
 void Restart::load_job() {
+  clear_job();
   if (exists()) {
     open(true);
-    (void)job_file.read(&job_info, sizeof(job_info));
+    read_journal();
     close();
   }
   debug_info(PSTR("Load"));
@@ -147,7 +173,7 @@ void Restart::save_job(const bool force_save/*=true*/) {
     // Elapsed print job time
     job_info.print_job_counter_elapsed = print_job_counter.duration();
 
-    write_job();
+    write_job(force_save || journal_deltas >= SD_RESTART_FILE_CHECKPOINT);
   }
 }
 
@@ -316,18 +342,178 @@ void Restart::resume_job() {
 /** Private Function */
 void Restart::clear_job() { memset(&job_info, 0, sizeof(job_info)); }
 
-void Restart::write_job() {
-  bool failed = false;
+/**
+ * Append a record to the journal, starting a new journal if there is none.
+ * Records go straight to the preallocated card blocks, so a delta costs one
+ * read and one write of the sector holding it.
+ */
+void Restart::write_job(bool checkpoint) {
 
   debug_info(PSTR("Write"));
 
-  open(false);
-  if (!job_file.seekSet(0)) failed = true;
-  if (!failed && !job_file.write(&job_info, sizeof(job_info)) == sizeof(job_info))
-    failed = true;
-  close();
-  if (failed) DEBUG_LM(DEB, " Restart file write failed.");
+  uint32_t pos = journal_pos;
+
+  if (!journal_block) {
+    journal_block = card.create_restart_file();
+    if (!journal_block) return;
+    journal_session = micros() | 1;
+    journal_seq = 0;
+    pos = 0;
+    checkpoint = true;
+  }
+  else if (!checkpoint) {
+    if ((pos % RESTART_SECTOR) + delta_length > RESTART_SECTOR) pos = NEXT_SECTOR(pos);
+    if (pos + delta_length > SD_RESTART_FILE_SIZE) checkpoint = true;  // Wrap with a checkpoint
+  }
+
+  if (checkpoint) {
+    if (pos % RESTART_SECTOR) pos = NEXT_SECTOR(pos);
+    if (pos + checkpoint_length > SD_RESTART_FILE_SIZE) pos = journal_start;
+  }
+
+  restart_record_t head;
+  head.magic    = RESTART_MAGIC;
+  head.type     = checkpoint ? RESTART_CHECKPOINT : RESTART_DELTA;
+  head.reserved = 0;
+  head.session  = journal_session;
+  head.seq      = ++journal_seq;
+
+  uint16_t crc = 0;
+  crc16(&crc, &head, sizeof(head));
+
+  bool failed;
+
+  if (checkpoint) {
+    checkpoint_seq  = head.seq;
+    journal_deltas  = 0;
+    crc16(&crc, &job_info, sizeof(job_info));
+    failed = !card.write_contiguous(journal_block, pos, &head, sizeof(head))
+          || !card.write_contiguous(journal_block, pos + sizeof(head), &job_info, sizeof(job_info))
+          || !card.write_contiguous(journal_block, pos + sizeof(head) + sizeof(job_info), &crc, sizeof(crc));
+  }
+  else {
+    restart_delta_t delta;
+    delta.checkpoint                = checkpoint_seq;
+    delta.sdpos                     = job_info.sdpos;
+    delta.axis_position_mm          = job_info.axis_position_mm;
+    delta.feedrate                  = job_info.feedrate;
+    #if HAS_HOTENDS
+      COPY_ARRAY(delta.target_temperature, job_info.target_temperature);
+    #endif
+    #if HAS_BEDS
+      COPY_ARRAY(delta.bed_target_temperature, job_info.bed_target_temperature);
+    #endif
+    #if HAS_FAN
+      COPY_ARRAY(delta.fan_speed, job_info.fan_speed);
+    #endif
+    #if MAX_EXTRUDER > 1
+      delta.active_extruder         = job_info.active_extruder;
+    #endif
+    delta.axis_relative_modes       = job_info.axis_relative_modes;
+    delta.print_job_counter_elapsed = job_info.print_job_counter_elapsed;
+    journal_deltas++;
+    crc16(&crc, &delta, sizeof(delta));
+
+    // Whole record in one write, it never crosses a sector
+    uint8_t record[delta_length];
+    memcpy(record, &head, sizeof(head));
+    memcpy(record + sizeof(head), &delta, sizeof(delta));
+    memcpy(record + sizeof(head) + sizeof(delta), &crc, sizeof(crc));
+    failed = !card.write_contiguous(journal_block, pos, record, delta_length);
+  }
+
+  if (failed) {
+    DEBUG_LM(DEB, " Restart file write failed.");
+    close();                    // Start over with a new journal
+  }
+  else
+    journal_pos = pos + (checkpoint ? checkpoint_length : delta_length);
+
+}
+
+/**
+ * Rebuild job_info from the newest checkpoint of the journal and the newest
+ * delta written after it. Records of other sessions are left over from old
+ * journals in the same clusters and are skipped.
+ */
+void Restart::read_journal() {
+
+  restart_record_t head;
+
+  if (!check_record(0, head) || head.type != RESTART_CHECKPOINT) return;
+
+  const uint32_t session = head.session,
+                 size    = job_file.fileSize();
+
+  uint32_t checkpoint_pos = 0, delta_pos = 0,
+           last_checkpoint = head.seq, last_delta = 0;
+
+  for (uint32_t pos = 0; pos + sizeof(head) <= size;) {
+    if (check_record(pos, head) && head.session == session) {
+      if (head.type == RESTART_CHECKPOINT) {
+        if (head.seq > last_checkpoint) { last_checkpoint = head.seq; checkpoint_pos = pos; }
+        pos += checkpoint_length;
+      }
+      else {
+        if (head.seq > last_delta) { last_delta = head.seq; delta_pos = pos; }
+        pos += delta_length;
+      }
+    }
+    else
+      pos = NEXT_SECTOR(pos);
+  }
+
+  job_file.seekSet(checkpoint_pos + sizeof(head));
+  if (job_file.read(&job_info, sizeof(job_info)) != int(sizeof(job_info))) return clear_job();
+
+  restart_delta_t delta;
+  if (last_delta < last_checkpoint || !job_file.seekSet(delta_pos + sizeof(head))
+    || job_file.read(&delta, sizeof(delta)) != int(sizeof(delta))
+    || delta.checkpoint != last_checkpoint
+  ) return;
+
+  job_info.sdpos            = delta.sdpos;
+  job_info.axis_position_mm = delta.axis_position_mm;
+  job_info.feedrate         = delta.feedrate;
+  #if HAS_HOTENDS
+    COPY_ARRAY(job_info.target_temperature, delta.target_temperature);
+  #endif
+  #if HAS_BEDS
+    COPY_ARRAY(job_info.bed_target_temperature, delta.bed_target_temperature);
+  #endif
+  #if HAS_FAN
+    COPY_ARRAY(job_info.fan_speed, delta.fan_speed);
+  #endif
+  #if MAX_EXTRUDER > 1
+    job_info.active_extruder  = delta.active_extruder;
+  #endif
+  job_info.axis_relative_modes        = delta.axis_relative_modes;
+  job_info.print_job_counter_elapsed  = delta.print_job_counter_elapsed;
+
+}
+
+// Read a record at pos and check magic, length and CRC
+bool Restart::check_record(const uint32_t pos, restart_record_t &head) {
+
+  if (!job_file.seekSet(pos) || job_file.read(&head, sizeof(head)) != int(sizeof(head))) return false;
+  if (head.magic != RESTART_MAGIC) return false;
+  if (head.type != RESTART_CHECKPOINT && head.type != RESTART_DELTA) return false;
+
+  const uint16_t length = head.type == RESTART_CHECKPOINT ? checkpoint_length : delta_length;
+  if (pos + length > job_file.fileSize()) return false;
+
+  uint16_t crc = 0, stored;
+  crc16(&crc, &head, sizeof(head));
+
+  uint8_t buf[32];
+  for (uint16_t left = length - sizeof(head) - 2; left;) {
+    const uint16_t n = MIN(left, uint16_t(sizeof(buf)));
+    if (job_file.read(buf, n) != int(n)) return false;
+    crc16(&crc, buf, n);
+    left -= n;
+  }
 
+  return job_file.read(&stored, sizeof(stored)) == int(sizeof(stored)) && stored == crc;
 }
 
 #if ENABLED(DEBUG_RESTART)
@@ -94,6 +94,55 @@ typedef struct {
 
 } restart_job_t;
 
+/**
+ * Restart journal
+ *
+ * Every record is a restart_record_t header, the payload and a CRC-16 of both.
+ * A checkpoint carries the whole restart_job_t, a delta only the data that
+ * changes while printing. Deltas never cross a card sector and checkpoints
+ * start on one, so a write cut by power loss spoils its own record only.
+ */
+enum RestartRecordEnum : uint8_t { RESTART_CHECKPOINT = 1, RESTART_DELTA = 2 };
+
+typedef struct {
+  uint16_t  magic;
+  uint8_t   type,             // RestartRecordEnum
+            reserved;
+  uint32_t  session,          // Taken from the checkpoint at offset 0
+            seq;              // The highest is the newest
+} restart_record_t;
+
+typedef struct {
+
+  uint32_t checkpoint;        // seq of the checkpoint this delta applies to
+
+  uint32_t sdpos;
+
+  xyze_pos_t axis_position_mm;
+
+  uint16_t feedrate;
+
+  #if HAS_HOTENDS
+    int16_t target_temperature[MAX_HOTEND];
+  #endif
+  #if HAS_BEDS
+    int16_t bed_target_temperature[MAX_BED];
+  #endif
+
+  #if HAS_FAN
+    uint8_t fan_speed[MAX_FAN];
+  #endif
+
+  #if MAX_EXTRUDER > 1
+    uint8_t active_extruder;
+  #endif
+
+  uint8_t axis_relative_modes;
+
+  millis_l print_job_counter_elapsed;
+
+} restart_delta_t;
+
 class Restart {
 
   public: /** Constructor */
@@ -111,6 +160,16 @@ class Restart {
     static uint32_t cmd_sdpos,
                     sdpos[BUFSIZE];
 
+  private: /** Private Parameters */
+
+    static uint32_t journal_block,      // First card block of the journal, 0 = none
+                    journal_pos,        // Offset of the next record
+                    journal_session,
+                    journal_seq,
+                    checkpoint_seq;     // seq of the last checkpoint written
+
+    static uint8_t  journal_deltas;     // Deltas since the last checkpoint
+
   public: /** Public Function */
 
     static void enable(const bool onoff);
@@ -125,7 +184,7 @@ class Restart {
 
     static inline bool exists()               { return card.exist_restart_file(); }
     static inline void open(const bool read)  { card.open_restart_file(read); }
-    static inline void close()                { job_file.close(); }
+    static inline void close()                { job_file.close(); journal_block = 0; }
 
     static inline void factory_parameters()   { enable(true); }
     static inline bool valid()                { return job_info.valid_head && job_info.valid_head == job_info.valid_foot; }
@@ -137,7 +196,10 @@ class Restart {
 
     static void clear_job();
 
-    static void write_job();
+    static void write_job(bool checkpoint);
+
+    static void read_journal();
+    static bool check_record(const uint32_t pos, restart_record_t &head);
 
     #if ENABLED(DEBUG_RESTART)
       static void debug_info(PGM_P const prefix);
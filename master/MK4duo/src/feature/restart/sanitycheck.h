@@ -26,3 +26,16 @@
  *
  * Test configuration values for errors at compile-time.
  */
+
+#if HAS_SD_RESTART
+  #if DISABLED(SD_RESTART_FILE_SIZE)
+    #error "DEPENDENCY ERROR: Missing setting SD_RESTART_FILE_SIZE."
+  #elif SD_RESTART_FILE_SIZE < 8192 || (SD_RESTART_FILE_SIZE % 512)
+    #error "DEPENDENCY ERROR: SD_RESTART_FILE_SIZE must be a multiple of 512 and at least 8192."
+  #endif
+  #if DISABLED(SD_RESTART_FILE_CHECKPOINT)
+    #error "DEPENDENCY ERROR: Missing setting SD_RESTART_FILE_CHECKPOINT."
+  #elif SD_RESTART_FILE_CHECKPOINT < 1 || SD_RESTART_FILE_CHECKPOINT > 255
+    #error "DEPENDENCY ERROR: SD_RESTART_FILE_CHECKPOINT must be between 1 and 255."
+  #endif
+#endif
@@ -0,0 +1,40 @@
+/**
+ * MK4duo Firmware for 3D Printer, Laser and CNC
+ *
+ * Based on Marlin, Sprinter and grbl
+ * Copyright (c) 2011 Camiel Gubbels / Erik van der Zalm
+ * Copyright (c) 2020 Alberto Cotronei @MagoKimbra
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program. If not, see <http://www.gnu.org/licenses/>.
+ *
+ */
+#pragma once
+
+/**
+ * sanitycheck.h
+ *
+ * Test configuration values for errors at compile-time.
+ */
+
+#if ENABLED(TEMP_TELEMETRY)
+  #if ENABLED(TEMP_TELEMETRY_SAMPLES)
+    #error "DEPENDENCY ERROR: TEMP_TELEMETRY_SAMPLES is now TEMP_TELEMETRY_SIZE, in bytes. Please update your configuration."
+  #elif DISABLED(TEMP_TELEMETRY_SIZE)
+    #error "DEPENDENCY ERROR: Missing setting TEMP_TELEMETRY_SIZE."
+  #elif TEMP_TELEMETRY_SIZE < 1 + MAX_HEATER * (TELEMETRY_KEY_SIZE + TELEMETRY_CHUNK_RECORDS * TELEMETRY_DELTA_SIZE) || TEMP_TELEMETRY_SIZE > 65535
+    #error "DEPENDENCY ERROR: TEMP_TELEMETRY_SIZE must hold a chunk for every heater and be 65535 or less."
+  #elif ENABLED(__AVR__) && TEMP_TELEMETRY_SIZE > 2048
+    #error "DEPENDENCY ERROR: TEMP_TELEMETRY_SIZE must be 2048 or less on AVR."
+  #endif
+#endif
@@ -0,0 +1,217 @@
+/**
+ * MK4duo Firmware for 3D Printer, Laser and CNC
+ *
+ * Based on Marlin, Sprinter and grbl
+ * Copyright (c) 2011 Camiel Gubbels / Erik van der Zalm
+ * Copyright (c) 2020 Alberto Cotronei @MagoKimbra
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program. If not, see <http://www.gnu.org/licenses/>.
+ *
+ */
+
+/**
+ * telemetry.cpp - Temperature telemetry ring buffer
+ */
+
+#include "../../../MK4duo.h"
+#include "sanitycheck.h"
+
+#if ENABLED(TEMP_TELEMETRY)
+
+TempTelemetry telemetry;
+
+/** Private Parameters */
+uint8_t   TempTelemetry::buffer[TEMP_TELEMETRY_SIZE];
+
+uint8_t   TempTelemetry::heater_count = 0;
+
+uint16_t  TempTelemetry::chunk_size   = 0,
+          TempTelemetry::chunks       = 0,
+          TempTelemetry::head         = 0,
+          TempTelemetry::used         = 0;
+
+int16_t   TempTelemetry::last_temperature[MAX_HEATER] = { 0 };
+
+volatile bool TempTelemetry::paused   = false;
+
+/** Public Function */
+void TempTelemetry::reset() {
+  heater_count  = tempManager.heater_count;
+  chunk_size    = 1 + heater_count * (TELEMETRY_KEY_SIZE + TELEMETRY_CHUNK_RECORDS * TELEMETRY_DELTA_SIZE);
+  chunks        = heater_count ? TEMP_TELEMETRY_SIZE / chunk_size : 0;
+  head = used   = 0;
+}
+
+/**
+ * Called from tempManager.spin every TELEMETRY_INTERVAL_MS.
+ * A record is one sample for every heater in use,
+ * the buffer restart if the number of heaters change.
+ */
+void TempTelemetry::sample() {
+
+  if (paused) return;
+
+  if (heater_count != tempManager.heater_count) reset();
+  if (!chunks) return;
+
+  telemetry_sample_t record[MAX_HEATER];
+
+  LOOP_HEATER() {
+    const float temp10 = heaters[h].current_temperature * 10.0f;
+    record[h].temperature = constrain(LROUND(temp10), -32767, 32767);
+    record[h].target      = heaters[h].target_temperature;
+    record[h].pwm         = heaters[h].pwm_value;
+    record[h].flag        = heaters[h].data.flag.all;
+  }
+
+  // A new chunk when this one is full or the record does not fit a delta
+  uint8_t *c = chunk(head);
+  bool fits = used && c[0] < TELEMETRY_CHUNK_RECORDS;
+  for (uint8_t h = 0; fits && h < heater_count; h++) {
+    const uint8_t *key = &c[1 + h * TELEMETRY_KEY_SIZE];
+    const int16_t delta = record[h].temperature - last_temperature[h];
+    fits = int16_t(key[2] | (key[3] << 8)) == record[h].target
+        && key[4] == record[h].flag
+        && WITHIN(delta, -127, 127);
+  }
+  if (!fits) {
+    start_chunk(record);
+    c = chunk(head);
+  }
+
+  uint8_t *delta = &c[1 + heater_count * (TELEMETRY_KEY_SIZE + c[0] * TELEMETRY_DELTA_SIZE)];
+  LOOP_HEATER() {
+    *delta++ = uint8_t(int8_t(record[h].temperature - last_temperature[h]));
+    *delta++ = record[h].pwm;
+    last_temperature[h] = record[h].temperature;
+  }
+  c[0]++;
+
+}
+
+/**
+ * Dump the buffer from the oldest record.
+ *
+ *  Binary: header line with the byte count, then records as raw
+ *          telemetry_sample_t (little endian) for every heater.
+ *  CSV:    header line, then one line for every record,
+ *          time in ms relative to the newest record.
+ */
+void TempTelemetry::dump(const bool binary) {
+
+  // Stop sampling while the buffer is sent
+  paused = true;
+
+  const uint16_t first = used < chunks ? 0 : (head + 1) % chunks;
+
+  uint32_t records = 0;
+  for (uint16_t i = 0; i < used; i++) records += chunk((first + i) % chunks)[0];
+
+  SERIAL_MV("TELEMETRY heaters:", heater_count);
+  SERIAL_MV(" records:", records);
+  SERIAL_MV(" interval:", TELEMETRY_INTERVAL_MS);
+  if (binary) SERIAL_MV(" bytes:", records * heater_count * sizeof(telemetry_sample_t));
+  SERIAL_MSG(" heaters:");
+  LOOP_L_N(h, heater_count) {
+    if (h) SERIAL_CHR(',');
+    print_heater_label(h);
+  }
+  SERIAL_EOL();
+
+  if (!binary) {
+    SERIAL_MSG("ms");
+    LOOP_L_N(h, heater_count) {
+      SERIAL_CHR(','); print_heater_label(h); SERIAL_MSG(" temp");
+      SERIAL_CHR(','); print_heater_label(h); SERIAL_MSG(" target");
+      SERIAL_CHR(','); print_heater_label(h); SERIAL_MSG(" pwm");
+    }
+    SERIAL_EOL();
+  }
+
+  telemetry_sample_t record[MAX_HEATER];
+  uint32_t r = 0;
+
+  for (uint16_t i = 0; i < used; i++) {
+    const uint8_t *c = chunk((first + i) % chunks);
+    const uint8_t *delta = &c[1 + heater_count * TELEMETRY_KEY_SIZE];
+
+    // The first delta of a chunk is 0, the key holds the temperature
+    LOOP_L_N(h, heater_count) {
+      const uint8_t *key = &c[1 + h * TELEMETRY_KEY_SIZE];
+      record[h].temperature = int16_t(key[0] | (key[1] << 8));
+      record[h].target      = int16_t(key[2] | (key[3] << 8));
+      record[h].flag        = key[4];
+    }
+
+    LOOP_L_N(n, c[0]) {
+      LOOP_L_N(h, heater_count) {
+        record[h].temperature += int8_t(*delta++);
+        record[h].pwm = *delta++;
+      }
+      if (binary) {
+        const uint8_t* data = (const uint8_t*)record;
+        LOOP_L_N(b, heater_count * sizeof(telemetry_sample_t)) SERIAL_CHR(data[b]);
+      }
+      else {
+        SERIAL_VAL(-(int32_t)(records - 1 - r) * TELEMETRY_INTERVAL_MS);
+        LOOP_L_N(h, heater_count) {
+          SERIAL_CHR(','); SERIAL_VAL(record[h].temperature * 0.1f, 1);
+          SERIAL_CHR(','); SERIAL_VAL(record[h].target);
+          SERIAL_CHR(','); SERIAL_VAL(record[h].pwm);
+        }
+        SERIAL_EOL();
+      }
+      r++;
+      printer.idle_no_sleep();
+    }
+  }
+
+  if (binary) SERIAL_EOL();
+
+  paused = false;
+
+}
+
+/** Private Function */
+
+/**
+ * Move to the next chunk, dropping the oldest one if the buffer is
+ * full, and write the key of every heater from the sample
+ */
+void TempTelemetry::start_chunk(const telemetry_sample_t * const sample) {
+
+  if (used) head = (head + 1) % chunks;
+  if (used < chunks) used++;
+
+  uint8_t *c = chunk(head);
+  c[0] = 0;
+  LOOP_L_N(h, heater_count) {
+    uint8_t *key = &c[1 + h * TELEMETRY_KEY_SIZE];
+    key[0] = sample[h].temperature & 0xFF;
+    key[1] = sample[h].temperature >> 8;
+    key[2] = sample[h].target & 0xFF;
+    key[3] = sample[h].target >> 8;
+    key[4] = sample[h].flag;
+    last_temperature[h] = sample[h].temperature;
+  }
+
+}
+
+void TempTelemetry::print_heater_label(const uint8_t h) {
+  static const char heater_char[] = { 'T', 'B', 'C', 'W' };
+  SERIAL_CHR(heater_char[heaters[h].type]);
+  SERIAL_VAL(heaters[h].data.ID);
+}
+
+#endif // ENABLED(TEMP_TELEMETRY)
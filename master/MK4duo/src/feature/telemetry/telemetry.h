@@ -0,0 +1,92 @@
+/**
+ * MK4duo Firmware for 3D Printer, Laser and CNC
+ *
+ * Based on Marlin, Sprinter and grbl
+ * Copyright (c) 2011 Camiel Gubbels / Erik van der Zalm
+ * Copyright (c) 2020 Alberto Cotronei @MagoKimbra
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program. If not, see <http://www.gnu.org/licenses/>.
+ *
+ */
+#pragma once
+
+/**
+ * telemetry.h - Temperature telemetry ring buffer
+ *
+ * Every heater is sampled at the control rate (tempManager.spin)
+ * into a RAM ring buffer, dumped with M156.
+ *
+ * The buffer is a ring of chunks of up to TELEMETRY_CHUNK_RECORDS
+ * records. A chunk starts with its record count and a key for every
+ * heater (temperature, target and flag of the first record), then
+ * every record takes 2 bytes for each heater: the temperature change
+ * from the record before (0.1 °C) and the PWM. A target or flag change,
+ * or a temperature step over 12.7 °C, starts a new chunk, so the
+ * samples are kept exact. The oldest chunk is dropped when full.
+ */
+
+#if ENABLED(TEMP_TELEMETRY)
+
+#define TELEMETRY_INTERVAL_MS   100
+#define TELEMETRY_CHUNK_RECORDS  32
+#define TELEMETRY_KEY_SIZE        5   // Bytes of the key of one heater
+#define TELEMETRY_DELTA_SIZE      2   // Bytes of a record of one heater
+
+// Struct Telemetry sample of one heater
+struct telemetry_sample_t {
+  int16_t temperature;  // 0.1 °C
+  int16_t target;       // °C
+  uint8_t pwm;
+  uint8_t flag;         // heater_flag_t
+};
+
+class TempTelemetry {
+
+  public: /** Constructor */
+
+    TempTelemetry() {}
+
+  private: /** Private Parameters */
+
+    static uint8_t  buffer[TEMP_TELEMETRY_SIZE];
+
+    static uint8_t  heater_count;   // Heaters in each record
+
+    static uint16_t chunk_size,     // Bytes of a chunk
+                    chunks,         // Chunks in buffer
+                    head,           // Chunk being written
+                    used;           // Chunks stored
+
+    static int16_t  last_temperature[MAX_HEATER];
+
+    static volatile bool paused;
+
+  public: /** Public Function */
+
+    static void reset();
+    static void sample();
+    static void dump(const bool binary);
+
+  private: /** Private Function */
+
+    static void start_chunk(const telemetry_sample_t * const sample);
+    static void print_heater_label(const uint8_t h);
+
+    FORCE_INLINE static uint8_t* chunk(const uint16_t c) { return &buffer[c * chunk_size]; }
+
+};
+
+extern TempTelemetry telemetry;
+
+#endif // ENABLED(TEMP_TELEMETRY)
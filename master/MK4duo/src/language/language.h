@@ -224,6 +224,12 @@
 #define STR_SD_PRINTING_BYTE              "SD printing byte "
 #define STR_SD_NOT_PRINTING               "Not SD printing"
 #define STR_SD_ERR_WRITE_TO_FILE          "error writing to file"
+#define STR_SD_UPLOAD_ABORTED             "upload aborted"
+#define STR_SD_LAYER_NOT_FOUND            "layer not in the index"
+#define STR_SD_LAYER_START                "Start from layer Z:"
+#define STR_SD_LAYER_PRINTING             "can't start from a layer while printing"
+#define STR_SD_LAYER_NO_FILE              "no file selected to start from a layer"
+#define STR_SD_LAYER_NO_TEMP              "no hotend temperature for the layer"
 #define STR_SD_ERR_READ                   "SD read error"
 #define STR_SD_CANT_ENTER_SUBDIR          "Cannot enter subdir:"
 #define STR_SD_FILE_DELETED               "File deleted"
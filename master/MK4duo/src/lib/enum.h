@@ -138,13 +138,17 @@ enum BlockFlagBitEnum : uint8_t {
   BLOCK_BIT_NOMINAL_LENGTH,
 
   // Sync the stepper counts from the block
-  BLOCK_BIT_SYNC_POSITION
+  BLOCK_BIT_SYNC_POSITION,
+
+  // Step X and Y along the arc of the block
+  BLOCK_BIT_ARC
 };
 
 enum BlockFlagEnum : uint8_t {
   BLOCK_FLAG_RECALCULATE    = _BV(BLOCK_BIT_RECALCULATE),
   BLOCK_FLAG_NOMINAL_LENGTH = _BV(BLOCK_BIT_NOMINAL_LENGTH),
-  BLOCK_FLAG_SYNC_POSITION  = _BV(BLOCK_BIT_SYNC_POSITION)
+  BLOCK_FLAG_SYNC_POSITION  = _BV(BLOCK_BIT_SYNC_POSITION),
+  BLOCK_FLAG_ARC            = _BV(BLOCK_BIT_ARC)
 };
 
 /**
@@ -257,6 +261,15 @@ enum LsActionEnum : uint8_t {
   LS_GetFilename
 };
 
+/**
+ * GCZ header of the print file
+ */
+enum GCZHeaderEnum : uint8_t {
+  GCZ_NONE,         // Plain G-code
+  GCZ_VALID,        // Compressed, decoded by this build
+  GCZ_UNSUPPORTED   // Compressed, but the header is bad or needs a bigger window
+};
+
 /**
  * Sound
  */
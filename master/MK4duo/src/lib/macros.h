@@ -257,6 +257,7 @@
 #define LOOP_BED()                LOOP_L_N(h, tempManager.heater.beds)
 #define LOOP_CHAMBER()            LOOP_L_N(h, tempManager.heater.chambers)
 #define LOOP_COOLER()             LOOP_L_N(h, tempManager.heater.coolers)
+#define LOOP_HEATER()             LOOP_L_N(h, tempManager.heater_count)
 #define LOOP_FAN()                LOOP_L_N(f, fanManager.data.fans)
 #define LOOP_SERVO()              LOOP_L_N(s, NUM_SERVOS)
 
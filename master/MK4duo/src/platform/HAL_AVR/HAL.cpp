@@ -400,18 +400,7 @@ pin_t HAL::analog_value_pin() { return NoPin; }
 /** Private Function */
 void HAL::set_current_temp_raw() {
 
-  #if HAS_HOTENDS
-    LOOP_HOTEND() hotends[h]->data.sensor.adc_raw = AnalogInputValues[hotends[h]->data.sensor.pin];
-  #endif
-  #if HAS_BEDS
-    LOOP_BED() beds[h]->data.sensor.adc_raw = AnalogInputValues[beds[h]->data.sensor.pin];
-  #endif
-  #if HAS_CHAMBERS
-    LOOP_CHAMBER() chambers[h]->data.sensor.adc_raw = AnalogInputValues[chambers[h]->data.sensor.pin];
-  #endif
-  #if HAS_COOLERS
-    LOOP_COOLER() coolers[h]->data.sensor.adc_raw = AnalogInputValues[coolers[h]->data.sensor.pin];
-  #endif
+  LOOP_HEATER() heaters[h].data.sensor.adc_raw = AnalogInputValues[heaters[h].data.sensor.pin];
 
   #if HAS_POWER_CONSUMPTION_SENSOR
     powerManager.current_raw_powconsumption = AnalogInputValues[POWER_CONSUMPTION_PIN];
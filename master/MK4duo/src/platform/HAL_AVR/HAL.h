@@ -475,6 +475,8 @@ class HAL {
 
   public: /** Public Function */
 
+    static inline void analogSetupHeaters() {}
+
     #if ANALOG_INPUTS > 0
       static void analogStart();
       static void AdcChangePin(const pin_t, const pin_t);
@@ -63,18 +63,8 @@
 uint8_t MCUSR;
 
 /** Private Parameters */
-#if HAS_HOTENDS
-  ADCAveragingFilter HAL::HOTENDsensorFilters[MAX_HOTEND];
-#endif
-#if HAS_BEDS
-  ADCAveragingFilter HAL::BEDsensorFilters[MAX_BED];
-#endif
-#if HAS_CHAMBERS
-  ADCAveragingFilter HAL::CHAMBERsensorFilters[MAX_CHAMBER];
-#endif
-#if HAS_COOLERS
-  ADCAveragingFilter HAL::COOLERsensorFilters[MAX_COOLER];
-#endif
+ADCAveragingFilter  HAL::sensorFilters[MAX_HEATER];
+adc_channel_num_t   HAL::sensorChannels[MAX_HEATER];
 
 #if ENABLED(FILAMENT_WIDTH_SENSOR)
   ADCAveragingFilter  HAL::filamentFilter;
@@ -88,6 +78,10 @@ uint8_t MCUSR;
   ADCAveragingFilter  HAL::mcuFilter;
 #endif
 
+#if ENABLED(SOFT_PWM_TIMER)
+  soft_pwm_t          HAL::soft_pwm[SOFT_PWM_CHANNELS];
+#endif
+
 __attribute__ ((aligned(256)))
 static DeviceVectors ram_tab = { NULL };
 
@@ -177,6 +171,10 @@ void HAL::hwSetup() {
   TimeTick_Configure(F_CPU);
   NVIC_SetPriority(SysTick_IRQn, NvicPrioritySystick);
   NVIC_SetPriority(UART_IRQn, NvicPriorityUart);
+  #if ENABLED(SOFT_PWM_TIMER)
+    LOOP_L_N(ch, SOFT_PWM_CHANNELS) soft_pwm[ch].pin = NoPin;
+    HAL_timer_start(SOFT_PWM_TIMER_NUM, SOFT_PWM_TIMER_FREQUENCY);
+  #endif
 }
 
 // Print apparent cause of start/restart
@@ -258,34 +256,7 @@ void HAL::analogStart() {
   ADC->ADC_WPMR = 0x41444300u;    // ADC_WPMR_WPKEY(0);
   pmc_enable_periph_clk(ID_ADC);  // enable adc clock
 
-  #if HAS_HOTENDS
-    LOOP_HOTEND() {
-      if (WITHIN(hotends[h]->data.sensor.pin, 0, 15)) {
-        AnalogInEnablePin(hotends[h]->data.sensor.pin, true);
-      }
-    }
-  #endif
-  #if HAS_BEDS
-    LOOP_BED() {
-      if (WITHIN(beds[h]->data.sensor.pin, 0, 15)) {
-        AnalogInEnablePin(beds[h]->data.sensor.pin, true);
-      }
-    }
-  #endif
-  #if HAS_CHAMBERS
-    LOOP_CHAMBER() {
-      if (WITHIN(chambers[h]->data.sensor.pin, 0, 15)) {
-        AnalogInEnablePin(chambers[h]->data.sensor.pin, true);
-      }
-    }
-  #endif
-  #if HAS_COOLERS
-    LOOP_COOLER() {
-      if (WITHIN(coolers[h]->data.sensor.pin, 0, 15)) {
-        AnalogInEnablePin(coolers[h]->data.sensor.pin, true);
-      }
-    }
-  #endif
+  analogSetupHeaters();
 
   #if ENABLED(FILAMENT_WIDTH_SENSOR)
     if (WITHIN(FILWIDTH_PIN, 0, 15) {
@@ -326,9 +297,24 @@ void HAL::analogStart() {
   AnalogInStartConversion();
 }
 
+// Enable heaters sensor channels and precompute their ADC channel number
+void HAL::analogSetupHeaters() {
+  LOOP_HEATER() {
+    const pin_t sensor_pin = heaters[h].data.sensor.pin;
+    if (WITHIN(sensor_pin, 0, 15)) {
+      AnalogInEnablePin(sensor_pin, true);
+      sensorChannels[h] = PinToAdcChannel(sensor_pin);
+    }
+    else
+      sensorChannels[h] = (adc_channel_num_t)NUM_ANALOG_INPUTS;
+    sensorFilters[h].init(0);
+  }
+}
+
 void HAL::AdcChangePin(const pin_t old_pin, const pin_t new_pin) {
   AnalogInEnablePin(old_pin, false);
   AnalogInEnablePin(new_pin, true);
+  analogSetupHeaters();
 }
 
 // Reset peripherals and cpu
@@ -351,6 +337,74 @@ bool HAL::tc_status(const pin_t pin) {
   else return false;
 }
 
+#if ENABLED(SOFT_PWM_TIMER)
+
+  static Pio* const soft_pwm_port[] = { PIOA, PIOB, PIOC, PIOD };
+
+  /**
+   * Set duty of a soft PWM channel.
+   * Port and mask are computed only when the pin changes,
+   * NoPin or a not valid pin detach the channel.
+   */
+  void HAL::soft_pwm_set(const uint8_t ch, const pin_t pin, const uint8_t duty) {
+    soft_pwm_t &spwm = soft_pwm[ch];
+    if (spwm.pin != pin) {
+      uint8_t   port = 0;
+      uint32_t  mask = 0;
+      if (WITHIN(pin, 0, NUM_DIGITAL_PINS - 1) && g_APinDescription[pin].ulPinType != PIO_NOT_A_PIN) {
+        LOOP_L_N(p, COUNT(soft_pwm_port)) {
+          if (g_APinDescription[pin].pPort == soft_pwm_port[p]) {
+            port = p;
+            mask = g_APinDescription[pin].ulPin;
+            break;
+          }
+        }
+      }
+      CRITICAL_SECTION_START();
+        spwm.pin  = pin;
+        spwm.port = port;
+        spwm.mask = mask;
+        spwm.accu = 0;
+      CRITICAL_SECTION_END();
+    }
+    spwm.duty = duty;
+  }
+
+  /**
+   * First order sigma-delta for all soft PWM channels.
+   * The output is HIGH when the accumulator overflows, the pins are
+   * written with one SODR and one CODR for each port.
+   */
+  void HAL::soft_pwm_isr() {
+
+    if (printer.isStopped()) return;
+
+    uint32_t  set_mask[COUNT(soft_pwm_port)] = { 0 },
+              clr_mask[COUNT(soft_pwm_port)] = { 0 };
+
+    auto sigma_delta = [&](soft_pwm_t &spwm) {
+      if (spwm.mask) {
+        const uint8_t carry = spwm.accu + spwm.duty;
+        if (carry < spwm.accu)
+          set_mask[spwm.port] |= spwm.mask;
+        else
+          clr_mask[spwm.port] |= spwm.mask;
+        spwm.accu = carry;
+      }
+    };
+
+    LOOP_HEATER() sigma_delta(soft_pwm[h]);
+    LOOP_FAN()    sigma_delta(soft_pwm[MAX_HEATER + f]);
+
+    LOOP_L_N(p, COUNT(soft_pwm_port)) {
+      if (set_mask[p]) soft_pwm_port[p]->PIO_SODR = set_mask[p];
+      if (clr_mask[p]) soft_pwm_port[p]->PIO_CODR = clr_mask[p];
+    }
+
+  }
+
+#endif // ENABLED(SOFT_PWM_TIMER)
+
 /**
  * PWM output only work on the pins with hardware support.
  *  For the rest of the pins, we default to digital output
@@ -490,6 +544,11 @@ void HAL::analogWrite(const pin_t pin, uint32_t ulValue, const uint16_t freq/*=1
     Tc *chTC = channelToTC[channel];
     uint32_t interfaceID = channelToId[channel];
 
+    #if ENABLED(SOFT_PWM_TIMER)
+      // TC8 is used by soft PWM timer
+      if (interfaceID == SOFT_PWM_TIMER_NUM) return;
+    #endif
+
     if (!TCChanEnabled[interfaceID]) {
       pmc_enable_periph_clk(TC_INTERFACE_ID + interfaceID);
       TC_Configure(chTC, chNo,
@@ -569,46 +628,15 @@ void HAL::Tick() {
   // Read analog or SPI values
   if (adc_get_status(ADC)) { // conversion finished?
 
-    #if HAS_HOTENDS
-      LOOP_HOTEND() {
-        if (WITHIN(hotends[h]->data.sensor.pin, 0, 15)) {
-          ADCAveragingFilter& currentFilter = const_cast<ADCAveragingFilter&>(HOTENDsensorFilters[h]);
-          currentFilter.process_reading(AnalogInReadPin(hotends[h]->data.sensor.pin));
-          if (currentFilter.IsValid())
-            hotends[h]->data.sensor.adc_raw = currentFilter.GetSum();
-        }
+    LOOP_HEATER() {
+      const adc_channel_num_t adc_ch = sensorChannels[h];
+      if ((unsigned int)adc_ch < NUM_ANALOG_INPUTS) {
+        ADCAveragingFilter& currentFilter = const_cast<ADCAveragingFilter&>(sensorFilters[h]);
+        currentFilter.process_reading(adc_get_channel_value(ADC, adc_ch));
+        if (currentFilter.IsValid())
+          heaters[h].data.sensor.adc_raw = currentFilter.GetSum();
       }
-    #endif
-    #if HAS_BEDS
-      LOOP_BED() {
-        if (WITHIN(beds[h]->data.sensor.pin, 0, 15)) {
-          ADCAveragingFilter& currentFilter = const_cast<ADCAveragingFilter&>(BEDsensorFilters[h]);
-          currentFilter.process_reading(AnalogInReadPin(beds[h]->data.sensor.pin));
-          if (currentFilter.IsValid())
-            beds[h]->data.sensor.adc_raw = currentFilter.GetSum();
-        }
-      }
-    #endif
-    #if HAS_CHAMBERS
-      LOOP_CHAMBER() {
-        if (WITHIN(chambers[h]->data.sensor.pin, 0, 15)) {
-          ADCAveragingFilter& currentFilter = const_cast<ADCAveragingFilter&>(CHAMBERsensorFilters[h]);
-          currentFilter.process_reading(AnalogInReadPin(chambers[h]->data.sensor.pin));
-          if (currentFilter.IsValid())
-            chambers[h]->data.sensor.adc_raw = currentFilter.GetSum();
-        }
-      }
-    #endif
-    #if HAS_COOLERS
-      LOOP_COOLER() {
-        if (WITHIN(coolers[h]->data.sensor.pin, 0, 15)) {
-          ADCAveragingFilter& currentFilter = const_cast<ADCAveragingFilter&>(COOLERsensorFilters[h]);
-          currentFilter.process_reading(AnalogInReadPin(coolers[h]->data.sensor.pin));
-          if (currentFilter.IsValid())
-            coolers[h]->data.sensor.adc_raw = currentFilter.GetSum();
-        }
-      }
-    #endif
+    }
 
     #if ENABLED(FILAMENT_WIDTH_SENSOR)
       const_cast<ADCAveragingFilter&>(filamentFilter).process_reading(AnalogInReadPin(FILWIDTH_PIN));
@@ -679,4 +707,11 @@ HAL_STEPPER_TIMER_ISR() {
   stepper.Step();
 }
 
+#if ENABLED(SOFT_PWM_TIMER)
+  HAL_SOFT_PWM_TIMER_ISR() {
+    HAL_timer_isr_prologue(SOFT_PWM_TIMER_NUM);
+    HAL::soft_pwm_isr();
+  }
+#endif
+
 #endif // ARDUINO_ARCH_SAM
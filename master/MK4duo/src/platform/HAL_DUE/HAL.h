@@ -217,6 +217,18 @@ extern "C" char *dtostrf (double __val, signed char __width, unsigned char __pre
 
 typedef AveragingFilter<NUM_ADC_SAMPLES> ADCAveragingFilter;
 
+#if ENABLED(SOFT_PWM_TIMER)
+  // Soft PWM channel, heaters first then fans
+  #define SOFT_PWM_CHANNELS (MAX_HEATER + MAX_FAN)
+  struct soft_pwm_t {
+    pin_t     pin;
+    uint8_t   port,
+              duty,
+              accu;
+    uint32_t  mask;
+  };
+#endif
+
 // ISR handler type
 using pfnISR_Handler = void(*)(void);
 
@@ -233,18 +245,8 @@ class HAL {
 
   private: /** Private Parameters */
 
-    #if HAS_HOTENDS
-      static ADCAveragingFilter HOTENDsensorFilters[MAX_HOTEND];
-    #endif
-    #if HAS_BEDS
-      static ADCAveragingFilter BEDsensorFilters[MAX_BED];
-    #endif
-    #if HAS_CHAMBERS
-      static ADCAveragingFilter CHAMBERsensorFilters[MAX_CHAMBER];
-    #endif
-    #if HAS_COOLERS
-      static ADCAveragingFilter COOLERsensorFilters[MAX_COOLER];
-    #endif
+    static ADCAveragingFilter sensorFilters[MAX_HEATER];
+    static adc_channel_num_t  sensorChannels[MAX_HEATER];
 
     #if ENABLED(FILAMENT_WIDTH_SENSOR)
       static ADCAveragingFilter filamentFilter;
@@ -258,9 +260,14 @@ class HAL {
       static ADCAveragingFilter mcuFilter;
     #endif
 
+    #if ENABLED(SOFT_PWM_TIMER)
+      static soft_pwm_t soft_pwm[SOFT_PWM_CHANNELS];
+    #endif
+
   public: /** Public Function */
 
     static void analogStart();
+    static void analogSetupHeaters();
     static void AdcChangePin(const pin_t old_pin, const pin_t new_pin);
 
     static void hwSetup(void);
@@ -270,6 +277,11 @@ class HAL {
 
     static void analogWrite(const pin_t pin, uint32_t ulValue, const uint16_t freq=1000U);
 
+    #if ENABLED(SOFT_PWM_TIMER)
+      static void soft_pwm_set(const uint8_t ch, const pin_t pin, const uint8_t duty);
+      static void soft_pwm_isr();
+    #endif
+
     static void Tick();
 
     static int32_t analog2tempMCU(const int16_t adc_raw);
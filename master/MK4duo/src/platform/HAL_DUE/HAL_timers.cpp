@@ -83,7 +83,11 @@ const tTimerConfig TimerConfig [NUM_HARDWARE_TIMERS] = {
   { TC1, 2, TC5_IRQn, 3 },  // 5 - [servo timer5]
   { TC2, 0, TC6_IRQn, 0 },  // 6 - Pin TC 4 - 5
   { TC2, 1, TC7_IRQn, 0 },  // 7 - Pin TC 3 - 10
-  { TC2, 2, TC8_IRQn, 0 },  // 8 - Pin TC 11 - 12
+  #if ENABLED(SOFT_PWM_TIMER)
+    { TC2, 2, TC8_IRQn, 14},  // 8 - [SOFT PWM]
+  #else
+    { TC2, 2, TC8_IRQn, 0 },  // 8 - Pin TC 11 - 12
+  #endif
 };
 
 uint32_t  HAL_min_pulse_cycle     = 0,
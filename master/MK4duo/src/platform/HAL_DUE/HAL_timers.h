@@ -81,6 +81,10 @@
 #define STEPPER_CLOCK_RATE          ((F_CPU) / 128)                                           // frequency of the clock used for stepper pulse timing
 #define HAL_STEPPER_TIMER_ISR()     void TC4_Handler()
 
+// Soft PWM Timer
+#define SOFT_PWM_TIMER_NUM          8
+#define HAL_SOFT_PWM_TIMER_ISR()    void TC8_Handler()
+
 #define AD_PRESCALE_FACTOR          84  // 500 kHz ADC clock 
 #define AD_TRACKING_CYCLES          4   // 0 - 15     + 1 adc clock cycles
 #define AD_TRANSFER_CYCLES          1   // 0 - 3      * 2 + 3 adc clock cycles
@@ -261,5 +261,10 @@ FORCE_INLINE static void OUT_WRITE(const pin_t pin, const uint8_t flag) {
 
 FORCE_INLINE static bool USEABLE_HARDWARE_PWM(const pin_t pin) {
   const uint32_t attr = g_APinDescription[pin].ulPinAttribute;
+  #if ENABLED(SOFT_PWM_TIMER)
+    // TC8 is used by soft PWM timer
+    if ((attr & PIN_ATTR_PWM) == 0 && (g_APinDescription[pin].ulTCChannel == TC2_CHA8 || g_APinDescription[pin].ulTCChannel == TC2_CHB8))
+      return false;
+  #endif
   return (attr & PIN_ATTR_PWM) != 0 || (attr & PIN_ATTR_TIMER) != 0;
 }
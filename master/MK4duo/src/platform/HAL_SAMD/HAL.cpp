@@ -342,7 +342,7 @@ void HAL::Tick() {
 
   // read analog values
   #if ANALOG_INPUTS > 0
-    LOOP_HOTEND() AnalogInputValues[hotends[h]->sensor.pin] = (analogRead(hotends[h]->sensor.pin) * 16);
+    LOOP_HEATER() AnalogInputValues[heaters[h].data.sensor.pin] = (analogRead(heaters[h].data.sensor.pin) * 16);
     Analog_is_ready = true;
     // Update the raw values if they've been read. Else we could be updating them during reading.
     tempManager.set_current_temp_raw();
@@ -197,6 +197,7 @@ class HAL {
   public: /** Public Function */
 
     static void analogStart();
+    static inline void analogSetupHeaters() {}
     static void AdcChangePin(const pin_t old_pin, const pin_t new_pin);
 
     static bool pwm_status(const pin_t pin);
@@ -31,18 +31,7 @@ int32_t HAL_VREF = 0;
 uint8_t MCUSR;
 
 /** Private Parameters */
-#if HAS_HOTENDS
-  ADCAveragingFilter  HAL::HOTENDsensorFilters[MAX_HOTEND];
-#endif
-#if HAS_BEDS
-  ADCAveragingFilter  HAL::BEDsensorFilters[MAX_BED];
-#endif
-#if HAS_CHAMBERS
-  ADCAveragingFilter  HAL::CHAMBERsensorFilters[MAX_CHAMBER];
-#endif
-#if HAS_COOLERS
-  ADCAveragingFilter  HAL::COOLERsensorFilters[MAX_COOLER];
-#endif
+ADCAveragingFilter    HAL::sensorFilters[MAX_HEATER];
 
 #if ENABLED(FILAMENT_WIDTH_SENSOR)
   ADCAveragingFilter  HAL::filamentFilter;
@@ -96,26 +85,7 @@ void HAL::analogStart() {
 
   analogReadResolution(ANALOG_INPUT_BITS);
 
-  #if HAS_HOTENDS
-    LOOP_HOTEND() {
-      SET_INPUT_ANALOG(hotends[h]->data.sensor.pin);
-    }
-  #endif
-  #if HAS_BEDS
-    LOOP_BED() {
-      SET_INPUT_ANALOG(beds[h]->data.sensor.pin);
-    }
-  #endif
-  #if HAS_CHAMBERS
-    LOOP_CHAMBER() {
-      SET_INPUT_ANALOG(chambers[h]->data.sensor.pin);
-    }
-  #endif
-  #if HAS_COOLERS
-    LOOP_COOLER() {
-      SET_INPUT_ANALOG(coolers[h]->data.sensor.pin);
-    }
-  #endif
+  analogSetupHeaters();
 
   #if ENABLED(FILAMENT_WIDTH_SENSOR)
     SET_INPUT_ANALOG(FILWIDTH_PIN);
@@ -127,8 +97,16 @@ void HAL::analogStart() {
 
 }
 
-void HAL::AdcChangePin(const pin_t, const pin_t new_pin) {
-  SET_INPUT_ANALOG(new_pin);
+// Set heaters sensor pins as analog input
+void HAL::analogSetupHeaters() {
+  LOOP_HEATER() {
+    SET_INPUT_ANALOG(heaters[h].data.sensor.pin);
+    sensorFilters[h].init(3000);
+  }
+}
+
+void HAL::AdcChangePin(const pin_t, const pin_t) {
+  analogSetupHeaters();
 }
 
 // Reset peripherals and cpu
@@ -200,38 +178,12 @@ void HAL::Tick() {
   // Event every second
   if (cycle_1s_timer.expired(SECOND_TO_MILLIS(1))) printer.check_periodical_actions();
 
-  #if HAS_HOTENDS
-    LOOP_HOTEND() {
-      ADCAveragingFilter& currentFilter = const_cast<ADCAveragingFilter&>(HOTENDsensorFilters[h]);
-      currentFilter.process_reading(analogRead(hotends[h]->data.sensor.pin));
-      if (currentFilter.IsValid())
-        hotends[h]->data.sensor.adc_raw = currentFilter.GetSum();
-    }
-  #endif
-  #if HAS_BEDS
-    LOOP_BED() {
-      ADCAveragingFilter& currentFilter = const_cast<ADCAveragingFilter&>(BEDsensorFilters[h]);
-      currentFilter.process_reading(analogRead(beds[h]->data.sensor.pin));
-      if (currentFilter.IsValid())
-        beds[h]->data.sensor.adc_raw = currentFilter.GetSum();
-    }
-  #endif
-  #if HAS_CHAMBERS
-    LOOP_CHAMBER() {
-      ADCAveragingFilter& currentFilter = const_cast<ADCAveragingFilter&>(CHAMBERsensorFilters[h]);
-      currentFilter.process_reading(analogRead(chambers[h]->data.sensor.pin));
-      if (currentFilter.IsValid())
-        chambers[h]->data.sensor.adc_raw = currentFilter.GetSum();
-    }
-  #endif
-  #if HAS_COOLERS
-    LOOP_COOLER() {
-      ADCAveragingFilter& currentFilter = const_cast<ADCAveragingFilter&>(COOLERsensorFilters[h]);
-      currentFilter.process_reading(analogRead(coolers[h]->data.sensor.pin));
-      if (currentFilter.IsValid())
-        coolers[h]->data.sensor.adc_raw = currentFilter.GetSum();
-    }
-  #endif
+  LOOP_HEATER() {
+    ADCAveragingFilter& currentFilter = const_cast<ADCAveragingFilter&>(sensorFilters[h]);
+    currentFilter.process_reading(analogRead(heaters[h].data.sensor.pin));
+    if (currentFilter.IsValid())
+      heaters[h].data.sensor.adc_raw = currentFilter.GetSum();
+  }
 
   #if ENABLED(FILAMENT_WIDTH_SENSOR)
     const_cast<ADCAveragingFilter&>(filamentFilter).process_reading(analogRead(FILWIDTH_PIN));
@@ -173,18 +173,7 @@ class HAL {
 
   private: /** Private Parameters */
 
-    #if HAS_HOTENDS
-      static ADCAveragingFilter HOTENDsensorFilters[MAX_HOTEND];
-    #endif
-    #if HAS_BEDS
-      static ADCAveragingFilter BEDsensorFilters[MAX_BED];
-    #endif
-    #if HAS_CHAMBERS
-      static ADCAveragingFilter CHAMBERsensorFilters[MAX_CHAMBER];
-    #endif
-    #if HAS_COOLERS
-      static ADCAveragingFilter COOLERsensorFilters[MAX_COOLER];
-    #endif
+    static ADCAveragingFilter sensorFilters[MAX_HEATER];
 
     #if ENABLED(FILAMENT_WIDTH_SENSOR)
       static ADCAveragingFilter filamentFilter;
@@ -205,6 +194,7 @@ class HAL {
   public: /** Public Function */
 
     static void analogStart();
+    static void analogSetupHeaters();
     static void AdcChangePin(const pin_t, const pin_t new_pin);
 
     static void hwSetup(void);
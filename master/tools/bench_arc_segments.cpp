@@ -0,0 +1,230 @@
+/**
+ * bench_arc_segments.cpp - Benchmark of the G2/G3 arc segmentation
+ *
+ *   g++ -O2 -o bench_arc_segments bench_arc_segments.cpp && ./bench_arc_segments
+ *
+ * The arcs of an ArcWelder style print (small holes as full circles, rounded
+ * corners and curved perimeters of large radius, as ArcWelder writes them
+ * from a sliced STL) are split by copies of plan_arc() in float:
+ *
+ *   fixed      MM_PER_ARC_SEGMENT 1, as before ARC_SEGMENT_TOLERANCE
+ *   tolerance  ARC_SEGMENT_TOLERANCE 0.002, MAX_MM_PER_ARC_SEGMENT 10
+ *
+ * both with MIN_ARC_SEGMENTS 24, N_ARC_CORRECTION 25 and min_segment_time_us
+ * 20000. For every group it reports the blocks queued, the largest distance
+ * of the segments from the true arc (chord and float drift, in um), the
+ * blocks per second the planner gets at the arc feedrate and the host time
+ * to split an arc.
+ *
+ * The program fails if a tolerance arc is off by more than the tolerance
+ * where the min segment time does not set the length. The G-code targets
+ * are rounded to 0.001mm, the distance of the target from the circle and
+ * the float rounding are allowed on top.
+ */
+
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+#include <cstdio>
+#include <cstdint>
+#include <random>
+#include <vector>
+
+#define MM_PER_ARC_SEGMENT      1
+#define ARC_SEGMENT_TOLERANCE   0.002f
+#define MAX_MM_PER_ARC_SEGMENT  10
+#define MIN_ARC_SEGMENTS        24
+#define N_ARC_CORRECTION        25
+#define MIN_SEGMENT_TIME_US     20000
+
+struct Arc {
+  float x, y, cx, cy, tx, ty;   // Start, center, target
+  bool clockwise;
+  float fr_mm_s;
+};
+
+struct Result {
+  uint32_t blocks = 0;
+  double error = 0.0, seconds = 0.0, min_segment_s = 1e9;
+  bool length_from_time = false;
+};
+
+// plan_arc() in the XY plane, the segment ends go to out
+template <bool TOLERANCE>
+static uint16_t plan_arc(const Arc &a, std::vector<float> &out) {
+
+  float rvec_a = a.x - a.cx, rvec_b = a.y - a.cy;
+  const float offset0 = -rvec_a, offset1 = -rvec_b,
+              radius = hypotf(rvec_a, rvec_b),
+              rt_X = a.tx - a.cx, rt_Y = a.ty - a.cy;
+
+  float angular_travel = atan2f(rvec_a * rt_Y - rvec_b * rt_X, rvec_a * rt_X + rvec_b * rt_Y);
+  if (angular_travel < 0) angular_travel += 2.0f * float(M_PI);
+  if (a.clockwise) angular_travel -= 2.0f * float(M_PI);
+
+  if (angular_travel == 0 && a.x == a.tx && a.y == a.ty)
+    angular_travel = 2.0f * float(M_PI);
+
+  uint16_t min_segments = ceilf(MIN_ARC_SEGMENTS * (fabsf(angular_travel) / (2.0f * float(M_PI))));
+  if (min_segments < 1) min_segments = 1;
+
+  const float mm_of_travel = fabsf(radius * angular_travel);
+  uint16_t segments;
+  if (TOLERANCE) {
+    const float tolerance = std::min(ARC_SEGMENT_TOLERANCE, radius);
+    float chord_mm = 2.0f * sqrtf(tolerance * (2.0f * radius - tolerance));
+    chord_mm = std::max(chord_mm, a.fr_mm_s * MIN_SEGMENT_TIME_US * 0.000001f);
+    chord_mm = std::min(chord_mm, float(MAX_MM_PER_ARC_SEGMENT));
+    segments = ceilf(mm_of_travel / chord_mm);
+  }
+  else
+    segments = floorf(mm_of_travel / (MM_PER_ARC_SEGMENT));
+  segments = std::max(segments, min_segments);
+
+  const float theta_per_segment = angular_travel / segments,
+              sin_T = TOLERANCE ? sinf(theta_per_segment) : theta_per_segment,
+              cos_T = TOLERANCE ? cosf(theta_per_segment) : 1 - 0.5f * theta_per_segment * theta_per_segment;
+
+  int8_t arc_recalc_count = N_ARC_CORRECTION;
+  for (uint16_t i = 1; i < segments; i++) {
+    if (--arc_recalc_count) {
+      const float r_new_Y = rvec_a * sin_T + rvec_b * cos_T;
+      rvec_a = rvec_a * cos_T - rvec_b * sin_T;
+      rvec_b = r_new_Y;
+    }
+    else {
+      arc_recalc_count = N_ARC_CORRECTION;
+      const float cos_Ti = cosf(i * theta_per_segment),
+                  sin_Ti = sinf(i * theta_per_segment);
+      rvec_a = -offset0 * cos_Ti + offset1 * sin_Ti;
+      rvec_b = -offset0 * sin_Ti - offset1 * cos_Ti;
+    }
+    out.push_back(a.cx + rvec_a);
+    out.push_back(a.cy + rvec_b);
+  }
+  out.push_back(a.tx);
+  out.push_back(a.ty);
+  return segments;
+}
+
+// Largest distance of the segments from the arc, sampled along every segment
+static double arc_error(const Arc &a, const std::vector<float> &pts) {
+  const double r = std::hypot(double(a.x) - a.cx, double(a.y) - a.cy);
+  double px = a.x, py = a.y, worst = 0.0;
+  for (size_t i = 0; i < pts.size(); i += 2) {
+    const double qx = pts[i], qy = pts[i + 1];
+    for (int k = 0; k <= 8; k++) {
+      const double f = k / 8.0,
+                   x = px + (qx - px) * f - a.cx,
+                   y = py + (qy - py) * f - a.cy;
+      worst = std::max(worst, std::fabs(std::hypot(x, y) - r));
+    }
+    px = qx; py = qy;
+  }
+  return worst;
+}
+
+struct Group {
+  const char *name;
+  std::vector<Arc> arcs;
+};
+
+// ArcWelder style arcs: the end is on the circle, rounded to 3 decimals as in G-code
+static Arc make_arc(std::mt19937 &rnd, const float r, const float sweep, const float fr, const bool full) {
+  std::uniform_real_distribution<float> pos(20.0f, 180.0f), angle(0.0f, 2.0f * float(M_PI)), dir(0.0f, 1.0f);
+  Arc a;
+  const float a0 = angle(rnd);
+  a.cx = pos(rnd); a.cy = pos(rnd);
+  a.x = roundf((a.cx + r * cosf(a0)) * 1000.0f) / 1000.0f;
+  a.y = roundf((a.cy + r * sinf(a0)) * 1000.0f) / 1000.0f;
+  a.clockwise = dir(rnd) < 0.5f;
+  const float a1 = a.clockwise ? a0 - sweep : a0 + sweep;
+  if (full) { a.tx = a.x; a.ty = a.y; }
+  else {
+    a.tx = roundf((a.cx + r * cosf(a1)) * 1000.0f) / 1000.0f;
+    a.ty = roundf((a.cy + r * sinf(a1)) * 1000.0f) / 1000.0f;
+  }
+  a.fr_mm_s = fr;
+  return a;
+}
+
+static std::vector<Group> print_arcs() {
+  std::mt19937 rnd(1);
+  std::uniform_real_distribution<float> u(0.0f, 1.0f);
+  std::vector<Group> groups = { { "holes r0.5-4", {} }, { "corners r0.5-3", {} }, { "curves r5-50", {} }, { "curves r50-500", {} } };
+  for (int n = 0; n < 2000; n++) {
+    groups[0].arcs.push_back(make_arc(rnd, 0.5f + 3.5f * u(rnd), 0.0f, 25.0f, true));
+    groups[1].arcs.push_back(make_arc(rnd, 0.5f + 2.5f * u(rnd), float(M_PI) / 2.0f, 60.0f, false));
+    const float r1 = 5.0f + 45.0f * u(rnd);
+    groups[2].arcs.push_back(make_arc(rnd, r1, (2.0f + 38.0f * u(rnd)) / r1, 50.0f, false));
+    const float r2 = 50.0f + 450.0f * u(rnd);
+    groups[3].arcs.push_back(make_arc(rnd, r2, (5.0f + 55.0f * u(rnd)) / r2, 50.0f, false));
+  }
+  return groups;
+}
+
+template <bool TOLERANCE>
+static Result run(const Group &g, double &ns_per_arc) {
+  Result res;
+  std::vector<float> pts;
+  for (const Arc &a : g.arcs) {
+    pts.clear();
+    const uint16_t segments = plan_arc<TOLERANCE>(a, pts);
+    const float r = hypotf(a.x - a.cx, a.y - a.cy);
+    double travel = 0.0, px = a.x, py = a.y;
+    for (size_t i = 0; i < pts.size(); i += 2) {
+      travel += std::hypot(pts[i] - px, pts[i + 1] - py);
+      px = pts[i]; py = pts[i + 1];
+    }
+    res.blocks += segments;
+    res.seconds += travel / a.fr_mm_s;
+    res.min_segment_s = std::min(res.min_segment_s, travel / segments / a.fr_mm_s);
+    const double err = arc_error(a, pts);
+    // The tolerance holds unless the min segment time sets the length, the
+    // target rounded in the G-code is off the circle by itself and the float
+    // rotation drifts up to 0.5um on a 500mm radius
+    const double end_off = std::fabs(std::hypot(double(a.tx) - a.cx, double(a.ty) - a.cy) - std::hypot(double(a.x) - a.cx, double(a.y) - a.cy));
+    if (TOLERANCE && err > ARC_SEGMENT_TOLERANCE + end_off + 0.0005) {
+      const float tolerance = std::min(ARC_SEGMENT_TOLERANCE, r),
+                  chord_mm = 2.0f * sqrtf(tolerance * (2.0f * r - tolerance));
+      if (a.fr_mm_s * MIN_SEGMENT_TIME_US * 0.000001f > chord_mm)
+        res.length_from_time = true;
+      else
+        res.error = 1e9;
+    }
+    res.error = std::max(res.error, err);
+  }
+  volatile float sink = 0.0f;
+  const int repeat = 20;
+  auto t0 = std::chrono::steady_clock::now();
+  for (int r = 0; r < repeat; r++)
+    for (const Arc &a : g.arcs) {
+      pts.clear();
+      plan_arc<TOLERANCE>(a, pts);
+      sink = sink + pts.back();
+    }
+  auto t1 = std::chrono::steady_clock::now();
+  ns_per_arc = std::chrono::duration<double, std::nano>(t1 - t0).count() / (double(g.arcs.size()) * repeat);
+  return res;
+}
+
+int main() {
+
+  bool ok = true;
+
+  printf("2000 arcs per group, errors in um, blocks/s at the arc feedrate, host ns per arc\n\n");
+  printf("%-16s %-10s %8s %10s %10s %12s %9s\n", "arcs", "mode", "blocks", "max err", "blocks/s", "min seg ms", "ns/arc");
+
+  for (const Group &g : print_arcs()) {
+    double ns;
+    const Result f = run<false>(g, ns);
+    printf("%-16s %-10s %8u %10.2f %10.1f %12.2f %9.0f\n", g.name, "fixed", f.blocks, f.error * 1000.0, f.blocks / f.seconds, f.min_segment_s * 1000.0, ns);
+    const Result t = run<true>(g, ns);
+    printf("%-16s %-10s %8u %10.2f %10.1f %12.2f %9.0f%s\n", g.name, "tolerance", t.blocks, t.error * 1000.0, t.blocks / t.seconds, t.min_segment_s * 1000.0, ns,
+           t.length_from_time ? "  (min segment time)" : "");
+    if (t.error > 1e8) ok = false;
+  }
+
+  printf(ok ? "OK\n" : "FAILED: tolerance arc off by more than the tolerance\n");
+  return ok ? 0 : 1;
+}
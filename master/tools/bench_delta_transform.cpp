@@ -0,0 +1,269 @@
+/**
+ * bench_delta_transform.cpp - Benchmark of DELTA_INCREMENTAL_TRANSFORM
+ *
+ *   g++ -O2 -o bench_delta_transform bench_delta_transform.cpp && ./bench_delta_transform
+ *
+ * Random straight moves are split in lines of constant length, each line
+ * is transformed by Delta_Mechanics::Transform() (a float square root per
+ * tower) and by walk_start() / walk_next() (forward differencing and
+ * Newton steps on the reciprocal square root), both in float as on the
+ * printer. Heights are compared with a double reference and the error is
+ * given in microsteps. The program fails if any line is off by more than
+ * the quarter microstep guard plus float rounding (0.3 microsteps).
+ *
+ * Speed is measured on the host FPU, where a square root costs about as
+ * much as a multiply. The Due has no FPU and every float operation is a
+ * library call, so the float operations per line are counted too (a
+ * second run with a counting number type).
+ */
+
+#include <chrono>
+#include <cmath>
+#include <cstdio>
+#include <cstdint>
+#include <random>
+#include <vector>
+
+#define DELTA_INCREMENTAL_RESYNC 16
+
+struct Geometry {
+  const char *name;
+  float diagonal_rod, radius, print_radius, steps_per_mm;
+};
+
+static float towerX[3], towerY[3], D2[3];
+
+// Float that counts its operations
+struct Counted {
+  float v;
+  static uint64_t add, mul, sqrt, div;
+  Counted(const float f=0.0f) : v(f) {}
+  Counted operator+(const Counted o) const { add++; return v + o.v; }
+  Counted operator-(const Counted o) const { add++; return v - o.v; }
+  Counted operator*(const Counted o) const { mul++; return v * o.v; }
+  Counted operator/(const Counted o) const { div++; return v / o.v; }
+  Counted& operator+=(const Counted o) { add++; v += o.v; return *this; }
+  Counted& operator*=(const Counted o) { mul++; v *= o.v; return *this; }
+  bool operator>(const Counted o) const { add++; return v > o.v; }
+  bool operator<(const Counted o) const { add++; return v < o.v; }
+};
+uint64_t Counted::add = 0, Counted::mul = 0, Counted::sqrt = 0, Counted::div = 0;
+
+static inline float root(const float f) { return sqrtf(f); }
+static inline float absval(const float f) { return fabsf(f); }
+static inline Counted root(const Counted f) { Counted::sqrt++; return sqrtf(f.v); }
+static inline Counted absval(const Counted f) { return fabsf(f.v); }
+
+static void recalc(const Geometry &g) {
+  static const float angle[3] = { 210, 330, 90 };
+  for (int t = 0; t < 3; t++) {
+    towerX[t] = cosf(angle[t] * float(M_PI) / 180.0f) * g.radius;
+    towerY[t] = sinf(angle[t] * float(M_PI) / 180.0f) * g.radius;
+    D2[t] = g.diagonal_rod * g.diagonal_rod;
+  }
+}
+
+// Delta_Mechanics::Transform() without Z
+template <typename T>
+static inline void transform(const T x, const T y, T h[3]) {
+  for (int t = 0; t < 3; t++)
+    h[t] = root(T(D2[t]) - (T(towerX[t]) - x) * (T(towerX[t]) - x) - (T(towerY[t]) - y) * (T(towerY[t]) - y));
+}
+
+// Delta_Mechanics walk_* with the same float operations
+template <typename T>
+struct Walk {
+
+  T pos[2], step[2], q[3], dq[3], rsqrt[3], height[3], ddq, limit, limit2;
+  uint8_t count;
+
+  void sync() {
+    const T d2 = step[0] * step[0] + step[1] * step[1];
+    for (int t = 0; t < 3; t++) {
+      const T rx = pos[0] - T(towerX[t]), ry = pos[1] - T(towerY[t]);
+      q[t]  = T(D2[t]) - rx * rx - ry * ry;
+      dq[t] = T(-2.0f) * (rx * step[0] + ry * step[1]) - d2;
+    }
+    count = 0;
+  }
+
+  void start(const T x, const T y, const T sx, const T sy, const float steps_per_mm) {
+    pos[0] = x; pos[1] = y;
+    step[0] = sx; step[1] = sy;
+    ddq = T(-2.0f) * (sx * sx + sy * sy);
+    limit  = 0.6f / steps_per_mm;
+    limit2 = 1.0f / steps_per_mm;
+    sync();
+    for (int t = 0; t < 3; t++) rsqrt[t] = q[t] > T(0.0f) ? T(1.0f) / root(q[t]) : T(0.0f);
+  }
+
+  inline const T* next() {
+    pos[0] += step[0];
+    pos[1] += step[1];
+    if (++count >= DELTA_INCREMENTAL_RESYNC)
+      sync();
+    else {
+      for (int t = 0; t < 3; t++) {
+        q[t] += dq[t];
+        dq[t] += ddq;
+      }
+    }
+    for (int t = 0; t < 3; t++) {
+      const T qt = q[t];
+      T &y = rsqrt[t];
+      if (qt > T(0.0f) && y > T(0.0f)) {
+        const T h   = qt * y,
+                e   = T(1.0f) - h * y,
+                he2 = h * (e * e),
+                f   = T(1.0f) + T(0.5f) * e;
+        if (he2 < limit) {
+          y *= f;
+          height[t] = h * f;
+          continue;
+        }
+        if (he2 * (e * e) < limit2) {
+          const T h1 = h * f;
+          y *= f;
+          const T f1 = T(1.5f) - T(0.5f) * h1 * y;
+          y *= f1;
+          height[t] = h1 * f1;
+          continue;
+        }
+      }
+      height[t] = root(qt);
+      y = qt > T(0.0f) ? T(1.0f) / height[t] : T(0.0f);
+    }
+    return height;
+  }
+
+};
+
+struct Move { float x, y, sx, sy; int lines; };
+
+static std::vector<Move> moves(const Geometry &g, const float line_mm, const int count) {
+  std::mt19937 rnd(1);
+  std::uniform_real_distribution<float> u(-g.print_radius, g.print_radius);
+  std::vector<Move> out;
+  while ((int)out.size() < count) {
+    const float x0 = u(rnd), y0 = u(rnd), x1 = u(rnd), y1 = u(rnd);
+    if (x0 * x0 + y0 * y0 > g.print_radius * g.print_radius || x1 * x1 + y1 * y1 > g.print_radius * g.print_radius) continue;
+    const float mm = hypotf(x1 - x0, y1 - y0);
+    const int lines = std::max(1, int(ceilf(mm / line_mm)));
+    out.push_back({ x0, y0, (x1 - x0) / lines, (y1 - y0) / lines, lines });
+  }
+  return out;
+}
+
+// Float operations per line of both methods
+static void count_ops(const Geometry &g, const std::vector<Move> &list, const uint32_t lines, double full[4], double walk[4]) {
+  Counted::add = Counted::mul = Counted::sqrt = Counted::div = 0;
+  for (const Move &m : list) {
+    Counted x = m.x, y = m.y, h[3];
+    for (int n = 0; n < m.lines; n++) {
+      x += Counted(m.sx); y += Counted(m.sy);
+      transform(x, y, h);
+    }
+  }
+  full[0] = double(Counted::add) / lines; full[1] = double(Counted::mul) / lines;
+  full[2] = double(Counted::div) / lines; full[3] = double(Counted::sqrt) / lines;
+  Counted::add = Counted::mul = Counted::sqrt = Counted::div = 0;
+  Walk<Counted> w;
+  for (const Move &m : list) {
+    Counted x = m.x, y = m.y;
+    w.start(m.x, m.y, m.sx, m.sy, g.steps_per_mm);
+    for (int n = 0; n < m.lines; n++) {
+      x += Counted(m.sx); y += Counted(m.sy);
+      w.next();
+    }
+  }
+  walk[0] = double(Counted::add) / lines; walk[1] = double(Counted::mul) / lines;
+  walk[2] = double(Counted::div) / lines; walk[3] = double(Counted::sqrt) / lines;
+}
+
+static double exact(const int t, const double x, const double y) {
+  const double dx = towerX[t] - x, dy = towerY[t] - y;
+  return std::sqrt(double(D2[t]) - dx * dx - dy * dy);
+}
+
+int main() {
+
+  static const Geometry geometries[] = {
+    { "default 220/110", 220.0f, 110.0f,  90.0f,  80.0f },
+    { "large 440/200",   440.0f, 200.0f, 180.0f, 160.0f },
+  };
+  static const float line_lengths[] = { 0.5f, 2.0f, 6.0f };
+
+  bool ok = true;
+  volatile float sink = 0.0f;
+
+  printf("Errors in microsteps against the exact height at the same position,\n"
+         "operations per line as add/mul/div/sqrt (the add count includes compares)\n\n");
+  printf("%-16s %7s %8s %9s %9s %10s %10s %16s %16s\n", "geometry", "line mm", "lines", "full ns", "walk ns", "full err", "walk err", "full ops", "walk ops");
+
+  for (const Geometry &g : geometries) {
+    recalc(g);
+    for (const float line_mm : line_lengths) {
+      const std::vector<Move> list = moves(g, line_mm, 2000);
+      uint32_t lines = 0;
+      for (const Move &m : list) lines += m.lines;
+
+      // Accuracy against double at the position sent to the planner, in microsteps
+      double full_err = 0, walk_err = 0;
+      Walk<float> walk;
+      for (const Move &m : list) {
+        walk.start(m.x, m.y, m.sx, m.sy, g.steps_per_mm);
+        float x = m.x, y = m.y;
+        for (int n = 1; n <= m.lines; n++) {
+          x += m.sx; y += m.sy;
+          float h[3];
+          transform(x, y, h);
+          const float *w = walk.next();
+          for (int t = 0; t < 3; t++) {
+            const double e = exact(t, x, y);
+            full_err = std::max(full_err, std::fabs(h[t] - e) * g.steps_per_mm);
+            walk_err = std::max(walk_err, std::fabs(w[t] - e) * g.steps_per_mm);
+          }
+        }
+      }
+      if (walk_err > 0.3) ok = false;
+
+      double full_ops[4], walk_ops[4];
+      count_ops(g, list, lines, full_ops, walk_ops);
+
+      // Speed
+      const int repeat = 20;
+      auto t0 = std::chrono::steady_clock::now();
+      for (int r = 0; r < repeat; r++)
+        for (const Move &m : list) {
+          float x = m.x, y = m.y, h[3];
+          for (int n = 0; n < m.lines; n++) {
+            x += m.sx; y += m.sy;
+            transform(x, y, h);
+            sink = sink + h[0] + h[1] + h[2];
+          }
+        }
+      auto t1 = std::chrono::steady_clock::now();
+      for (int r = 0; r < repeat; r++)
+        for (const Move &m : list) {
+          walk.start(m.x, m.y, m.sx, m.sy, g.steps_per_mm);
+          for (int n = 0; n < m.lines; n++) {
+            const float *w = walk.next();
+            sink = sink + w[0] + w[1] + w[2];
+          }
+        }
+      auto t2 = std::chrono::steady_clock::now();
+
+      const double total = double(lines) * repeat,
+                   full_ns = std::chrono::duration<double, std::nano>(t1 - t0).count() / total,
+                   walk_ns = std::chrono::duration<double, std::nano>(t2 - t1).count() / total;
+
+      char full_text[32], walk_text[32];
+      snprintf(full_text, sizeof(full_text), "%.0f/%.0f/%.2f/%.2f", full_ops[0], full_ops[1], full_ops[2], full_ops[3]);
+      snprintf(walk_text, sizeof(walk_text), "%.0f/%.0f/%.2f/%.2f", walk_ops[0], walk_ops[1], walk_ops[2], walk_ops[3]);
+      printf("%-16s %7.1f %8u %9.1f %9.1f %10.4f %10.4f %16s %16s\n", g.name, line_mm, lines, full_ns, walk_ns, full_err, walk_err, full_text, walk_text);
+    }
+  }
+
+  printf(ok ? "OK\n" : "FAILED: error over 0.3 microsteps\n");
+  return ok ? 0 : 1;
+}
@@ -0,0 +1,226 @@
+/**
+ * bench_scara_ik.cpp - Test and benchmark of SCARA_IK_TABLE
+ *
+ *   g++ -O2 -o bench_scara_ik bench_scara_ik.cpp && ./bench_scara_ik
+ *
+ * The arm angles of Scara_Mechanics::Transform() are computed in float
+ * exactly (three atan2f and a sqrtf) and from the IK table built by
+ * recalc_scara_settings() with Catmull-Rom interpolation, and compared with
+ * a double reference. Errors are given in microsteps of the default
+ * Configuration_Scara.h arm (STEPS_PER_DEGREE 444.4, 100:1 harmonic drive).
+ * The program fails if the default table is off by more than half a
+ * microstep inside SCARA_IK_TABLE_LIMIT.
+ *
+ * The path part splits straight moves in segments of 0.5mm (the limit
+ * without the table) and of SCARA_IK_SEGMENT_MM. Between the ends of a
+ * segment the arms turn linearly; the effector position is found by
+ * forward kinematics and compared with the straight move.
+ */
+
+#include <chrono>
+#include <cmath>
+#include <cstdio>
+#include <cstdint>
+#include <random>
+#include <vector>
+
+#define SCARA_LINKAGE_1       200.0f
+#define SCARA_LINKAGE_2       200.0f
+#define STEPS_PER_DEGREE      (1.0 * 200 * 8 * 100 / 360.0)
+#define SCARA_IK_TABLE_SIZE   128
+#define SCARA_IK_TABLE_LIMIT  0.9f
+#define SCARA_IK_SEGMENT_MM   0.1f
+
+static const float L1 = SCARA_LINKAGE_1, L2 = SCARA_LINKAGE_2,
+                   L1_2 = L1 * L1, L2_2 = L2 * L2, L1_2_2 = 2.0f * L1_2;
+
+static inline float sq(const float f) { return f * f; }
+
+// Scara_Mechanics::Transform() without the table, radians
+static void transform_exact(const float sx, const float sy, float &theta, float &psi) {
+  const float C2 = L1 == L2 ? (sq(sx) + sq(sy)) / L1_2_2 - 1 : (sq(sx) + sq(sy) - (L1_2 + L2_2)) / (2.0f * L1 * L2),
+              S2 = sqrtf(1 - sq(C2));
+  theta = atan2f(L1 + L2 * C2, L2 * S2) - atan2f(sx, sy);
+  psi   = atan2f(S2, C2);
+}
+
+// The IK table of recalc_scara_settings()
+struct Table {
+
+  std::vector<float> theta, psi;
+  float c2_start, inv_step, limit;
+  int size;
+
+  Table(const int n, const float lim) : theta(n), psi(n), limit(lim), size(n) {
+    const float step = 2.0f * lim / float(n - 3);
+    c2_start = -lim - step;
+    inv_step = 1.0f / step;
+    for (int i = 0; i < n; i++) {
+      const float C2 = c2_start + i * step,
+                  S2 = sqrtf(1 - sq(C2));
+      theta[i] = atan2f(L1 + L2 * C2, L2 * S2);
+      psi[i]   = atan2f(S2, C2);
+    }
+  }
+
+  static inline float interpolate(const float table[], const int i, const float f) {
+    const float p0 = table[i - 1], p1 = table[i], p2 = table[i + 1], p3 = table[i + 2];
+    return p1 + 0.5f * f * (p2 - p0 + f * (2.0f * p0 - 5.0f * p1 + 4.0f * p2 - p3 + f * (3.0f * (p1 - p2) + p3 - p0)));
+  }
+
+  // Transform() with SCARA_IK_TABLE, false when outside the table
+  inline bool transform(const float sx, const float sy, float &th, float &ps) const {
+    const float C2 = (sq(sx) + sq(sy)) / L1_2_2 - 1,
+                t  = (C2 - c2_start) * inv_step;
+    if (t < 1.0f || t > size - 2.0f) { transform_exact(sx, sy, th, ps); return false; }
+    const int   i = std::min(int(t), size - 3);
+    const float f = t - i;
+    th = interpolate(theta.data(), i, f) - atan2f(sx, sy);
+    ps = interpolate(psi.data(), i, f);
+    return true;
+  }
+
+};
+
+static void reference(const double sx, const double sy, double &theta, double &psi) {
+  const double C2 = (sx * sx + sy * sy - (double(L1_2) + double(L2_2))) / (2.0 * L1 * L2),
+               S2 = std::sqrt(1 - C2 * C2);
+  theta = std::atan2(L1 + L2 * C2, L2 * S2) - std::atan2(sx, sy);
+  psi   = std::atan2(S2, C2);
+}
+
+// Scara_Mechanics::InverseTransform() in radians, A is theta and B theta + psi
+static void forward(const double theta, const double psi, double &x, double &y) {
+  x = L1 * std::cos(theta) + L2 * std::cos(theta + psi);
+  y = L1 * std::sin(theta) + L2 * std::sin(theta + psi);
+}
+
+static inline double wrap(double a) {
+  while (a >  M_PI) a -= 2.0 * M_PI;
+  while (a < -M_PI) a += 2.0 * M_PI;
+  return a;
+}
+
+static const double usteps_per_rad = STEPS_PER_DEGREE * 180.0 / M_PI;
+
+// A point with the elbow cosine within the limit
+static void random_point(std::mt19937 &rnd, const float limit, float &x, float &y) {
+  std::uniform_real_distribution<float> angle(0.0f, 2.0f * float(M_PI)), c2(-limit, limit);
+  const float r = sqrtf((c2(rnd) + 1.0f) * L1_2_2), a = angle(rnd);
+  x = r * sinf(a); y = r * cosf(a);
+}
+
+// Max error of both arms in microsteps
+static void angle_error(const Table *table, const int count, double &err_exact, double &err_table) {
+  std::mt19937 rnd(1);
+  err_exact = err_table = 0.0;
+  for (int n = 0; n < count; n++) {
+    float x, y, th, ps;
+    random_point(rnd, table->limit, x, y);
+    double rt, rp;
+    reference(x, y, rt, rp);
+    transform_exact(x, y, th, ps);
+    err_exact = std::max(err_exact, std::max(std::fabs(wrap(th - rt)), std::fabs(wrap(th + ps - rt - rp))) * usteps_per_rad);
+    table->transform(x, y, th, ps);
+    err_table = std::max(err_table, std::max(std::fabs(wrap(th - rt)), std::fabs(wrap(th + ps - rt - rp))) * usteps_per_rad);
+  }
+}
+
+// Max distance of the effector from straight moves split in segments of seg_mm
+static double path_error(const float seg_mm, const int count) {
+  std::mt19937 rnd(2);
+  std::uniform_real_distribution<float> len(5.0f, 60.0f), dir(0.0f, 2.0f * float(M_PI));
+  double worst = 0.0;
+  for (int n = 0; n < count; n++) {
+    float x0, y0;
+    random_point(rnd, 0.8f, x0, y0);
+    const float l = len(rnd), d = dir(rnd),
+                x1 = x0 + l * cosf(d), y1 = y0 + l * sinf(d),
+                c2 = (sq(x1) + sq(y1)) / L1_2_2 - 1;
+    if (std::fabs(c2) > 0.8f) { n--; continue; }
+    const int segments = std::max(1, int(l / seg_mm));
+    double pt = 0, pp = 0;
+    reference(x0, y0, pt, pp);
+    for (int s = 1; s <= segments; s++) {
+      const double f = double(s) / segments;
+      double ct, cp;
+      reference(x0 + (x1 - x0) * f, y0 + (y1 - y0) * f, ct, cp);
+      for (int k = 1; k < 4; k++) {
+        const double g = k / 4.0;
+        double ex, ey;
+        forward(pt + wrap(ct - pt) * g, pp + (cp - pp) * g, ex, ey);
+        // Distance from the line
+        const double vx = ex - x0, vy = ey - y0,
+                     dist = std::fabs(vx * (y1 - y0) - vy * (x1 - x0)) / l;
+        worst = std::max(worst, dist);
+      }
+      pt = ct; pp = cp;
+    }
+  }
+  return worst;
+}
+
+int main() {
+
+  bool ok = true;
+  volatile float sink = 0.0f;
+
+  printf("Arm angle error in microsteps against double, %d random points in the table range\n\n", 200000);
+  printf("%6s %6s %12s %12s\n", "size", "limit", "exact err", "table err");
+  static const int sizes[] = { 32, 64, 128, 256 };
+  static const float limits[] = { 0.8f, 0.9f, 0.95f };
+  for (const float limit : limits)
+    for (const int size : sizes) {
+      const Table table(size, limit);
+      double err_exact, err_table;
+      angle_error(&table, 200000, err_exact, err_table);
+      printf("%6d %6.2f %12.4f %12.4f\n", size, limit, err_exact, err_table);
+      if (size == SCARA_IK_TABLE_SIZE && limit == SCARA_IK_TABLE_LIMIT && err_table > 0.5) ok = false;
+    }
+
+  // Speed on the host FPU
+  const Table table(SCARA_IK_TABLE_SIZE, SCARA_IK_TABLE_LIMIT);
+  std::mt19937 rnd(3);
+  std::vector<float> px, py;
+  for (int n = 0; n < 100000; n++) {
+    float x, y;
+    random_point(rnd, SCARA_IK_TABLE_LIMIT, x, y);
+    px.push_back(x); py.push_back(y);
+  }
+  const int repeat = 20;
+  auto t0 = std::chrono::steady_clock::now();
+  for (int r = 0; r < repeat; r++)
+    for (size_t n = 0; n < px.size(); n++) {
+      float th, ps;
+      transform_exact(px[n], py[n], th, ps);
+      sink = sink + th + ps;
+    }
+  auto t1 = std::chrono::steady_clock::now();
+  for (int r = 0; r < repeat; r++)
+    for (size_t n = 0; n < px.size(); n++) {
+      float th, ps;
+      table.transform(px[n], py[n], th, ps);
+      sink = sink + th + ps;
+    }
+  auto t2 = std::chrono::steady_clock::now();
+  const double total = double(px.size()) * repeat;
+  printf("\nTransform on the host: exact %.1f ns, table %.1f ns\n",
+         std::chrono::duration<double, std::nano>(t1 - t0).count() / total,
+         std::chrono::duration<double, std::nano>(t2 - t1).count() / total);
+  printf("Per segment: exact 3 atan2 + 1 sqrt, table 1 atan2\n");
+
+  printf("\nPath error of straight moves in mm, 300 random moves of 5 to 60mm\n\n");
+  printf("%10s %12s\n", "segment mm", "max error");
+  static const float seg_lengths[] = { 0.5f, 0.25f, SCARA_IK_SEGMENT_MM };
+  double coarse = 0.0, fine = 0.0;
+  for (const float seg_mm : seg_lengths) {
+    const double e = path_error(seg_mm, 300);
+    printf("%10.2f %12.6f\n", seg_mm, e);
+    if (seg_mm == 0.5f) coarse = e;
+    if (seg_mm == SCARA_IK_SEGMENT_MM) fine = e;
+  }
+  if (!(fine < coarse)) ok = false;
+
+  printf(ok ? "OK\n" : "FAILED\n");
+  return ok ? 0 : 1;
+}
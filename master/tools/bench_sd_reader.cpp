@@ -0,0 +1,336 @@
+/**
+ * bench_sd_reader.cpp - Benchmark of the SD print reader
+ *
+ *   g++ -O2 -o bench_sd_reader bench_sd_reader.cpp && ./bench_sd_reader
+ *
+ * A FAT32 volume is built in memory (32KB clusters, the file in fragments)
+ * and holds a large G-code file of short segments, as a slicer writes for
+ * a complex model. The file is read through a copy of the SdFat read path
+ * (SdBaseFile::read(), cacheFetch(), fatGet() with its own FAT cache) by:
+ *
+ *   byte     SDCard::get() without SD_DOUBLE_BUFFER, curPosition() and a
+ *            one byte read() for every character
+ *   buffer   SDCard::get() with SD_DOUBLE_BUFFER 512 and 1024, read_ahead()
+ *            called once per line as Printer::idle() does
+ *
+ * The loop of Commands::get_sdcard() takes the lines. For every mode it
+ * reports the host time per byte, the read() calls and the card blocks
+ * read (each block is 512 bytes over SPI, the same for both modes).
+ *
+ * The program fails if a mode gives other bytes or another sdpos at the
+ * start of a line than the byte reader, also after random setIndex().
+ */
+
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+#include <cstdio>
+#include <cstdint>
+#include <cstring>
+#include <random>
+#include <string>
+#include <vector>
+
+#define BLOCKS_PER_CLUSTER  64
+#define FAT32MASK           0x0FFFFFFF
+
+// The card: blocks in RAM, counts the reads
+struct Card {
+  std::vector<uint8_t> data;
+  uint32_t reads = 0;
+  bool readBlock(const uint32_t block, uint8_t *dst) {
+    if ((block + 1) * 512ULL > data.size()) return false;
+    memcpy(dst, &data[block * 512ULL], 512);
+    reads++;
+    return true;
+  }
+};
+
+// SdVolume, data and FAT caches
+struct Volume {
+  Card *card;
+  uint32_t fatStartBlock, dataStartBlock, clusterCount;
+  uint32_t cacheBlockNumber = 0xFFFFFFFF, cacheFatBlockNumber = 0xFFFFFFFF;
+  union { uint8_t data[512]; uint32_t fat32[128]; } cache, fatCache;
+
+  uint8_t blockOfCluster(const uint32_t position) const { return (position >> 9) & (BLOCKS_PER_CLUSTER - 1); }
+  uint32_t clusterStartBlock(const uint32_t cluster) const { return dataStartBlock + (cluster - 2) * BLOCKS_PER_CLUSTER; }
+
+  uint8_t* cacheFetch(const uint32_t block) {
+    if (cacheBlockNumber != block) {
+      if (!card->readBlock(block, cache.data)) return nullptr;
+      cacheBlockNumber = block;
+    }
+    return cache.data;
+  }
+
+  bool fatGet(const uint32_t cluster, uint32_t *value) {
+    if (cluster < 2 || cluster > clusterCount + 1) return false;
+    const uint32_t lba = fatStartBlock + (cluster >> 7);
+    if (cacheFatBlockNumber != lba) {
+      if (!card->readBlock(lba, fatCache.data)) return false;
+      cacheFatBlockNumber = lba;
+    }
+    *value = fatCache.fat32[cluster & 0x7F] & FAT32MASK;
+    return true;
+  }
+};
+
+// SdBaseFile read path
+struct File {
+  Volume *vol;
+  uint32_t firstCluster, curCluster = 0, curPosition_ = 0, fileSize;
+  uint32_t calls = 0;
+
+  uint32_t curPosition() const { return curPosition_; }
+
+  bool seekSet(const uint32_t pos) {
+    if (pos > fileSize) return false;
+    if (pos == 0) { curCluster = 0; curPosition_ = 0; return true; }
+    // Follow the chain from the start, as SdBaseFile::seekSet() does on a backward seek
+    const uint32_t nNew = (pos - 1) >> 15, nCur = (curPosition_ - 1) >> 15;
+    uint32_t n = nNew;
+    if (nNew < nCur || curPosition_ == 0) curCluster = firstCluster;
+    else n -= nCur;
+    while (n--) if (!vol->fatGet(curCluster, &curCluster)) return false;
+    curPosition_ = pos;
+    return true;
+  }
+
+  int read(void *buf, size_t nbyte) {
+    calls++;
+    uint8_t *dst = reinterpret_cast<uint8_t*>(buf);
+    if (nbyte >= fileSize - curPosition_) nbyte = fileSize - curPosition_;
+    size_t toRead = nbyte;
+    while (toRead > 0) {
+      size_t n;
+      const uint16_t offset = curPosition_ & 0x1FF;
+      const uint8_t blockOfCluster = vol->blockOfCluster(curPosition_);
+      if (offset == 0 && blockOfCluster == 0) {
+        if (curPosition_ == 0) curCluster = firstCluster;
+        else if (!vol->fatGet(curCluster, &curCluster)) return -1;
+      }
+      const uint32_t block = vol->clusterStartBlock(curCluster) + blockOfCluster;
+      if (offset != 0 || toRead < 512 || block == vol->cacheBlockNumber) {
+        n = std::min<size_t>(512 - offset, toRead);
+        const uint8_t *pc = vol->cacheFetch(block);
+        if (!pc) return -1;
+        memcpy(dst, pc + offset, n);
+      }
+      else {
+        n = 512;
+        if (!vol->card->readBlock(block, dst)) return -1;
+      }
+      dst += n;
+      curPosition_ += n;
+      toRead -= n;
+    }
+    return nbyte;
+  }
+
+  int read() { uint8_t b; return read(&b, 1) == 1 ? b : -1; }
+};
+
+// SDCard::get() and setIndex() without SD_DOUBLE_BUFFER
+struct ByteReader {
+  File &file;
+  uint32_t sdpos = 0;
+  explicit ByteReader(File &f) : file(f) {}
+  void setIndex(const uint32_t p) { sdpos = p; file.seekSet(p); }
+  inline int16_t get() { sdpos = file.curPosition(); return (int16_t)file.read(); }
+  void read_ahead() {}
+};
+
+// SDCard::get(), setIndex(), read_ahead() with SD_DOUBLE_BUFFER
+template <uint16_t SD_READ_BUFFER_SIZE>
+struct BufferReader {
+  File &file;
+  uint32_t sdpos = 0, read_base = 0;
+  uint8_t read_buffer[2][SD_READ_BUFFER_SIZE];
+  uint16_t read_count[2] = { 0 }, read_index = 0;
+  uint8_t read_active = 0;
+
+  explicit BufferReader(File &f) : file(f) {}
+
+  void flush_read_buffer() { read_count[0] = read_count[1] = read_index = read_active = 0; read_base = sdpos; }
+  void setIndex(const uint32_t p) { sdpos = p; file.seekSet(p); flush_read_buffer(); }
+
+  void fill_read_buffer(const uint8_t b) {
+    const uint16_t len = SD_READ_BUFFER_SIZE - (file.curPosition() % SD_READ_BUFFER_SIZE);
+    const int16_t n = file.read(read_buffer[b], len);
+    read_count[b] = n > 0 ? n : 0;
+  }
+
+  bool next_read_buffer() {
+    const uint8_t next = read_active ^ 1;
+    if (!read_count[next]) fill_read_buffer(next);
+    if (!read_count[next]) return false;
+    read_base += read_count[read_active];
+    read_count[read_active] = 0;
+    read_active = next;
+    read_index = 0;
+    return true;
+  }
+
+  void read_ahead() {
+    const uint8_t next = read_active ^ 1;
+    if (!read_count[next] && read_base + read_count[read_active] < file.fileSize)
+      fill_read_buffer(next);
+  }
+
+  inline int16_t get() {
+    const bool ok = read_index < read_count[read_active] || next_read_buffer();
+    sdpos = read_base + read_index;
+    return ok ? read_buffer[read_active][read_index++] : -1;
+  }
+};
+
+// Short segments of a curved model with some comments, as a slicer writes them
+static std::string make_gcode(const size_t size) {
+  std::mt19937 rnd(1);
+  std::uniform_real_distribution<float> u(0.0f, 1.0f);
+  std::string s = ";FLAVOR:RepRap\n;Generated for the SD reader benchmark\nG21\nG90\nM82\nG28\n";
+  char line[96];
+  float x = 100.0f, y = 100.0f, e = 0.0f, z = 0.2f;
+  while (s.size() < size) {
+    const float a = u(rnd) * 6.2832f, l = 0.05f + 0.25f * u(rnd);
+    x += l * cosf(a); y += l * sinf(a); e += l * 0.033f;
+    snprintf(line, sizeof(line), "G1 X%.3f Y%.3f E%.5f\n", x, y, e);
+    s += line;
+    if (u(rnd) < 0.0005f) { z += 0.2f; snprintf(line, sizeof(line), ";LAYER_CHANGE\n;Z:%.2f\nG1 Z%.2f F7800\n", z, z); s += line; }
+  }
+  return s;
+}
+
+// FAT32 volume with the file in fragments of 1 to 8 clusters
+static void make_volume(const std::string &content, Card &card, Volume &vol, File &file) {
+  const uint32_t clusters = (content.size() + BLOCKS_PER_CLUSTER * 512 - 1) / (BLOCKS_PER_CLUSTER * 512);
+  vol.card = &card;
+  vol.clusterCount = clusters * 2 + 16;
+  vol.fatStartBlock = 32;
+  const uint32_t fatBlocks = (vol.clusterCount + 2 + 127) / 128;
+  vol.dataStartBlock = vol.fatStartBlock + fatBlocks;
+  card.data.assign((vol.dataStartBlock + uint64_t(vol.clusterCount) * BLOCKS_PER_CLUSTER) * 512, 0);
+  uint32_t *fat = reinterpret_cast<uint32_t*>(&card.data[vol.fatStartBlock * 512]);
+
+  std::mt19937 rnd(2);
+  std::uniform_int_distribution<int> frag(1, 8), gap(0, 1);
+  uint32_t cluster = 3, prev = 0, done = 0, left = 0;
+  file.firstCluster = cluster;
+  while (done < clusters) {
+    if (!left) { left = frag(rnd); if (prev) cluster += gap(rnd); }
+    if (prev) fat[prev] = cluster;
+    const size_t from = size_t(done) * BLOCKS_PER_CLUSTER * 512;
+    memcpy(&card.data[vol.clusterStartBlock(cluster) * 512ULL], content.data() + from,
+           std::min<size_t>(BLOCKS_PER_CLUSTER * 512, content.size() - from));
+    prev = cluster++;
+    done++; left--;
+  }
+  fat[prev] = FAT32MASK;
+  file.vol = &vol;
+  file.fileSize = content.size();
+}
+
+struct Run {
+  std::string bytes;
+  std::vector<uint32_t> line_pos;
+  uint32_t lines = 0;
+  double ns = 0.0;
+};
+
+// The loop of Commands::get_sdcard(): a line at a time, idle after each
+template <class R>
+static void get_lines(R &reader, const uint32_t max_bytes, Run &run, const bool keep) {
+  char command[96];
+  uint8_t count = 0;
+  uint32_t taken = 0;
+  bool start = true;
+  while (taken < max_bytes) {
+    const int16_t n = reader.get();
+    if (start && keep) run.line_pos.push_back(reader.sdpos);
+    start = false;
+    if (n < 0) break;
+    taken++;
+    const char c = n;
+    if (keep) run.bytes += c;
+    if (c == '\n' || c == '\r') {
+      command[count] = '\0';
+      count = 0;
+      run.lines++;
+      start = true;
+      reader.read_ahead();
+    }
+    else if (count < sizeof(command) - 1)
+      command[count++] = c;
+  }
+}
+
+template <class R>
+static Run read_all(Card &card, File &file, const bool keep) {
+  Run run;
+  R *reader = new R(file);
+  file.calls = 0;
+  card.reads = 0;
+  reader->setIndex(0);
+  const auto t0 = std::chrono::steady_clock::now();
+  get_lines(*reader, 0xFFFFFFFF, run, keep);
+  const auto t1 = std::chrono::steady_clock::now();
+  run.ns = std::chrono::duration<double, std::nano>(t1 - t0).count();
+  delete reader;
+  return run;
+}
+
+// Random setIndex() and a few KB after it
+template <class R>
+static std::vector<Run> seeks(File &file) {
+  std::vector<Run> out;
+  std::mt19937 rnd(3);
+  std::uniform_int_distribution<uint32_t> pos(0, file.fileSize - 1);
+  R *reader = new R(file);
+  for (int n = 0; n < 200; n++) {
+    Run run;
+    reader->setIndex(pos(rnd));
+    get_lines(*reader, 4096, run, true);
+    out.push_back(run);
+  }
+  delete reader;
+  return out;
+}
+
+template <class R>
+static bool check(const char *name, Card &card, File &file, const Run &ref, const std::vector<Run> &ref_seeks, const double bytes) {
+  const Run r = read_all<R>(card, file, true);
+  bool ok = r.bytes == ref.bytes && r.line_pos == ref.line_pos;
+  const std::vector<Run> s = seeks<R>(file);
+  for (size_t i = 0; i < s.size(); i++)
+    ok = ok && s[i].bytes == ref_seeks[i].bytes && s[i].line_pos == ref_seeks[i].line_pos;
+  const Run t = read_all<R>(card, file, false);
+  printf("%-12s %10.2f %12.1f %12u %12u %10.3f %s\n", name, t.ns / bytes, bytes / t.ns * 1000.0,
+         file.calls, card.reads, double(file.calls) / t.lines, ok ? "" : "  MISMATCH");
+  return ok;
+}
+
+int main() {
+
+  const std::string gcode = make_gcode(64UL << 20);
+  Card card;
+  Volume vol;
+  File file;
+  make_volume(gcode, card, vol, file);
+
+  const Run ref = read_all<ByteReader>(card, file, true);
+  const std::vector<Run> ref_seeks = seeks<ByteReader>(file);
+  bool ok = ref.bytes == gcode;
+  const double bytes = gcode.size();
+
+  printf("G-code file of %.1f MB, %u lines, FAT32 clusters of %u KB in fragments\n\n", bytes / 1048576.0, ref.lines, BLOCKS_PER_CLUSTER / 2);
+  printf("%-12s %10s %12s %12s %12s %10s\n", "reader", "ns/byte", "MB/s (host)", "read calls", "card blocks", "calls/line");
+
+  const Run t = read_all<ByteReader>(card, file, false);
+  printf("%-12s %10.2f %12.1f %12u %12u %10.3f\n", "byte", t.ns / bytes, bytes / t.ns * 1000.0, file.calls, card.reads, double(file.calls) / t.lines);
+  ok = check<BufferReader<512>>("buffer 512", card, file, ref, ref_seeks, bytes) && ok;
+  ok = check<BufferReader<1024>>("buffer 1024", card, file, ref, ref_seeks, bytes) && ok;
+
+  printf(ok ? "OK\n" : "FAILED: the buffered reader differs from the byte reader\n");
+  return ok ? 0 : 1;
+}
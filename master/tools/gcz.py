@@ -0,0 +1,151 @@
+#!/usr/bin/env python3
+"""
+gcz.py - Compress G-code for MK4duo GCZ_SUPPORT
+
+  gcz.py [-w BITS] [-l BITS] file.gcode [file.gcz]   compress
+  gcz.py -d file.gcz [file.gcode]                    decompress
+
+The output is the 4 byte header "GCZ" + (window bits << 4 | lookahead bits)
+and a heatshrink LZSS bit stream. The window must not be bigger than the
+GCZ_WINDOW_BITS of the firmware: 8 on AVR, 11 on 32 bit boards by default.
+"""
+
+import argparse
+import sys
+
+MAGIC = b"GCZ"
+
+
+class BitWriter:
+
+    def __init__(self):
+        self.out = bytearray()
+        self.byte = 0
+        self.count = 0
+
+    def put(self, value, bits):
+        for i in range(bits - 1, -1, -1):
+            self.byte = (self.byte << 1) | ((value >> i) & 1)
+            self.count += 1
+            if self.count == 8:
+                self.out.append(self.byte)
+                self.byte = self.count = 0
+
+    def flush(self):
+        if self.count:
+            self.out.append(self.byte << (8 - self.count))
+            self.byte = self.count = 0
+        return bytes(self.out)
+
+
+def compress(data, window_bits, lookahead_bits):
+    window = 1 << window_bits
+    max_len = 1 << lookahead_bits
+    # A back reference must be shorter than the literals it replaces
+    min_len = (1 + window_bits + lookahead_bits) // 9 + 1
+    chains = {}
+    bits = BitWriter()
+    pos = 0
+
+    def add(p):
+        if p + 3 <= len(data):
+            chains.setdefault(data[p:p + 3], []).append(p)
+
+    while pos < len(data):
+        best_len = best_dist = 0
+        for cand in reversed(chains.get(data[pos:pos + 3], [])[-64:]):
+            dist = pos - cand
+            if dist > window:
+                break
+            n = 0
+            while n < max_len and pos + n < len(data) and data[cand + n] == data[pos + n]:
+                n += 1
+            if n > best_len:
+                best_len, best_dist = n, dist
+                if n == max_len:
+                    break
+        if best_len >= min_len:
+            bits.put(0, 1)
+            bits.put(best_dist - 1, window_bits)
+            bits.put(best_len - 1, lookahead_bits)
+            for p in range(pos, pos + best_len):
+                add(p)
+            pos += best_len
+        else:
+            bits.put(1, 1)
+            bits.put(data[pos], 8)
+            add(pos)
+            pos += 1
+
+    return MAGIC + bytes([window_bits << 4 | lookahead_bits]) + bits.flush()
+
+
+def decompress(data):
+    if data[:3] != MAGIC or len(data) < 4:
+        raise ValueError("not a GCZ file")
+    window_bits, lookahead_bits = data[3] >> 4, data[3] & 0x0F
+    stream = data[4:]
+    total = len(stream) * 8
+    pos = 0
+    out = bytearray()
+
+    def get(n):
+        nonlocal pos
+        if pos + n > total:
+            return None
+        value = 0
+        for _ in range(n):
+            value = (value << 1) | ((stream[pos >> 3] >> (7 - (pos & 7))) & 1)
+            pos += 1
+        return value
+
+    while True:
+        tag = get(1)
+        if tag is None:
+            break
+        if tag:
+            c = get(8)
+            if c is None:
+                break
+            out.append(c)
+        else:
+            index, count = get(window_bits), get(lookahead_bits)
+            if index is None or count is None:
+                break
+            for _ in range(count + 1):
+                out.append(out[-(index + 1)])
+    return bytes(out)
+
+
+def main():
+    ap = argparse.ArgumentParser(description="Compress G-code for MK4duo GCZ_SUPPORT")
+    ap.add_argument("-d", action="store_true", help="decompress")
+    ap.add_argument("-w", type=int, default=8, help="window bits, 4-14 (default 8, AVR safe)")
+    ap.add_argument("-l", type=int, default=4, help="lookahead bits (default 4)")
+    ap.add_argument("input")
+    ap.add_argument("output", nargs="?")
+    args = ap.parse_args()
+
+    if not 4 <= args.w <= 14 or not 3 <= args.l < args.w:
+        sys.exit("window bits must be 4-14, lookahead bits 3 to window bits - 1")
+
+    with open(args.input, "rb") as f:
+        data = f.read()
+
+    if args.d:
+        result = decompress(data)
+        output = args.output or args.input.rsplit(".", 1)[0] + ".gcode"
+    else:
+        result = compress(data, args.w, args.l)
+        if decompress(result) != data:
+            sys.exit("round trip check failed")
+        output = args.output or args.input.rsplit(".", 1)[0] + ".gcz"
+
+    with open(output, "wb") as f:
+        f.write(result)
+
+    print("%s: %d -> %d bytes" % (output, len(data), len(result)))
+
+
+if __name__ == "__main__":
+    main()
@@ -0,0 +1,129 @@
+#!/usr/bin/env python3
+"""
+sdupload.py - Upload a file to the SD card of MK4duo with M28 B
+
+  sdupload.py [-b BAUD] PORT file.gcode [NAME]
+
+The firmware needs SD_BINARY_UPLOAD. The file is sent as "M28 B<size> NAME",
+then in frames of 512 bytes (the last one may be shorter), each followed by
+its CRC-16/XMODEM, high byte first. After each frame the host waits for the
+answer: "ok" sends the next frame, "Resend:<frame>" sends that frame again.
+Once all frames are in, M29 puts the file in place of NAME.
+
+Needs pyserial.
+"""
+
+import argparse
+import os
+import sys
+import time
+
+FRAME_SIZE = 512
+REPLY_TIMEOUT = 15.0    # Seconds without an answer, the firmware gives up after 10
+
+
+def crc16(data, crc=0):
+    """ CRC-16/XMODEM of crc16() in utility.cpp """
+    for b in data:
+        crc ^= b << 8
+        for _ in range(8):
+            crc = ((crc << 1) ^ 0x1021) & 0xFFFF if crc & 0x8000 else (crc << 1) & 0xFFFF
+    return crc
+
+
+def frames(data):
+    """ The frames of data, each with its CRC high byte first """
+    out = []
+    for pos in range(0, len(data), FRAME_SIZE):
+        chunk = data[pos:pos + FRAME_SIZE]
+        crc = crc16(chunk)
+        out.append(chunk + bytes([crc >> 8, crc & 0xFF]))
+    return out
+
+
+class UploadError(Exception):
+    pass
+
+
+def wait_reply(link, accept, timeout=REPLY_TIMEOUT):
+    """
+    Read lines until one starts with an entry of accept, return it.
+    Errors from the firmware raise, other lines (echo, temperatures) are skipped.
+    """
+    start = time.monotonic()
+    while time.monotonic() - start < timeout:
+        line = link.readline()
+        if isinstance(line, bytes):
+            line = line.decode("ascii", "replace")
+        line = line.strip()
+        if not line:
+            continue
+        if line.startswith("Error:") or line.startswith("open failed"):
+            raise UploadError(line)
+        for a in accept:
+            if line.startswith(a):
+                return line
+    raise UploadError("no answer from the printer")
+
+
+def upload(link, data, name, progress=None):
+    """
+    Send data as name over link, an object with write(bytes) and readline().
+    Return the number of frames sent again.
+    """
+    if not data:
+        raise UploadError("empty file")
+
+    link.write(("M28 B%d %s\n" % (len(data), name)).encode("ascii"))
+    wait_reply(link, ("ok",))
+
+    frame_list = frames(data)
+    frame = resends = 0
+    while frame < len(frame_list):
+        link.write(frame_list[frame])
+        reply = wait_reply(link, ("ok", "Resend:"))
+        if reply.startswith("Resend:"):
+            frame = int(reply[7:])
+            resends += 1
+        else:
+            frame += 1
+            if progress:
+                progress(frame, len(frame_list))
+
+    link.write(b"M29\n")
+    wait_reply(link, ("Done saving file.",))
+    wait_reply(link, ("ok",))
+    return resends
+
+
+def main():
+    ap = argparse.ArgumentParser(description="Upload a file to the SD card of MK4duo with M28 B")
+    ap.add_argument("-b", type=int, default=250000, help="baud rate (default 250000)")
+    ap.add_argument("port")
+    ap.add_argument("input")
+    ap.add_argument("name", nargs="?", help="name on the card (default the file name)")
+    args = ap.parse_args()
+
+    import serial
+
+    with open(args.input, "rb") as f:
+        data = f.read()
+    name = args.name or os.path.basename(args.input)
+
+    link = serial.Serial(args.port, args.b, timeout=1)
+    time.sleep(2)               # Boards that reset on open
+    link.reset_input_buffer()
+
+    start = time.monotonic()
+    try:
+        resends = upload(link, data, name,
+                         lambda n, total: print("\r%d/%d frames" % (n, total), end="", flush=True))
+    except UploadError as e:
+        sys.exit("\nupload failed: %s" % e)
+    seconds = time.monotonic() - start
+    print("\n%s: %d bytes in %.1f s, %.1f KB/s, %d frames sent again"
+          % (name, len(data), seconds, len(data) / seconds / 1024, resends))
+
+
+if __name__ == "__main__":
+    main()
@@ -0,0 +1,234 @@
+#!/usr/bin/env python3
+"""
+test_bezier.py - Tests of the G5 flattening against the old step search
+
+  python3 test_bezier.py        run the tests
+  python3 test_bezier.py -b     print the benchmark
+
+Copies of Bezier::cubic_b_spline() split the same curves:
+
+  old   the step search of the Kig painter (MIN_STEP, MAX_STEP, SIGMA with
+        a norm 1 distance), E spread on the curve parameter
+  new   Bezier::get_segments() from the bound of Wang and BEZIER_TOLERANCE,
+        capped by the min segment time, forward differences, E spread on
+        the length
+
+The curves are sized as slicer curve fitting writes them: perimeters with
+turns up to 90 degrees, S bends and tight curves of a few mm. Every line
+ends on the curve, its distance from the curve is measured between its
+ends; the E error is the largest difference of the extrusion per mm from
+the mean of the curve.
+"""
+
+import math
+import random
+import sys
+import unittest
+
+BEZIER_TOLERANCE = 0.05
+MIN_SEGMENT_TIME_US = 20000
+MIN_STEP, MAX_STEP, SIGMA = 0.002, 0.1, 0.1
+
+
+def bezier(p, t):
+    u = 1.0 - t
+    return tuple(u * u * u * p[0][k] + 3 * u * u * t * p[1][k] + 3 * u * t * t * p[2][k] + t * t * t * p[3][k] for k in range(2))
+
+
+def old_flatten(p):
+    """ The old cubic_b_spline(), returns the parameters of the line ends """
+    interp = lambda a, b, t: (1.0 - t) * a + t * b
+
+    def eval_bezier(a, b, c, d, t):
+        iab, ibc, icd = interp(a, b, t), interp(b, c, t), interp(c, d, t)
+        return interp(interp(iab, ibc, t), interp(ibc, icd, t), t)
+
+    dist1 = lambda x1, y1, x2, y2: abs(x1 - x2) + abs(y1 - y2)
+    ev = lambda t: (eval_bezier(p[0][0], p[1][0], p[2][0], p[3][0], t), eval_bezier(p[0][1], p[1][1], p[2][1], p[3][1], t))
+
+    t, step = 0.0, MAX_STEP
+    pos = p[0]
+    out = []
+    while t < 1.0:
+        did_reduce = False
+        new_t = min(t + step, 1.0)
+        new_pos = ev(new_t)
+        while True:
+            if new_t - t < MIN_STEP:
+                break
+            candidate_t = 0.5 * (t + new_t)
+            candidate = ev(candidate_t)
+            mid = (0.5 * (pos[0] + new_pos[0]), 0.5 * (pos[1] + new_pos[1]))
+            if dist1(candidate[0], candidate[1], mid[0], mid[1]) <= SIGMA:
+                break
+            new_t, new_pos, did_reduce = candidate_t, candidate, True
+        if not did_reduce:
+            while True:
+                if new_t - t > MAX_STEP:
+                    break
+                candidate_t = t + 2.0 * (new_t - t)
+                if candidate_t >= 1.0:
+                    break
+                candidate = ev(candidate_t)
+                mid = (0.5 * (pos[0] + candidate[0]), 0.5 * (pos[1] + candidate[1]))
+                if dist1(new_pos[0], new_pos[1], mid[0], mid[1]) > SIGMA:
+                    break
+                new_t, new_pos = candidate_t, candidate
+        step = new_t - t
+        t = new_t
+        pos = new_pos
+        out.append(t)
+    return out
+
+
+def get_segments(p, fr_mm_s, tolerance=BEZIER_TOLERANCE):
+    """ Bezier::get_segments() """
+    sub = lambda a, b: (a[0] - b[0], a[1] - b[1])
+    mag = lambda v: math.hypot(v[0], v[1])
+    m = max(mag((p[0][0] - 2 * p[1][0] + p[2][0], p[0][1] - 2 * p[1][1] + p[2][1])),
+            mag((p[1][0] - 2 * p[2][0] + p[3][0], p[1][1] - 2 * p[2][1] + p[3][1])))
+    segments = math.sqrt(0.75 * m / tolerance)
+    min_mm = fr_mm_s * MIN_SEGMENT_TIME_US * 0.000001
+    capped = False
+    if min_mm > 0:
+        polygon = mag(sub(p[1], p[0])) + mag(sub(p[2], p[1])) + mag(sub(p[3], p[2]))
+        if segments > polygon / min_mm:
+            segments, capped = polygon / min_mm, True
+    segments = min(segments, 0xFFFF)
+    return (math.ceil(segments) if segments > 1 else 1), capped
+
+
+def new_flatten(p, fr_mm_s, tolerance=BEZIER_TOLERANCE):
+    """ The forward difference walk of cubic_b_spline(), returns the parameters """
+    n, capped = get_segments(p, fr_mm_s, tolerance)
+    return [i / n for i in range(1, n + 1)], capped
+
+
+def deviation(p, params, samples=16):
+    """ Largest distance of the lines from the curve between their ends """
+    worst, t0 = 0.0, 0.0
+    a = p[0]
+    for t1 in params:
+        b = bezier(p, t1)
+        dx, dy = b[0] - a[0], b[1] - a[1]
+        length = math.hypot(dx, dy)
+        for k in range(1, samples):
+            q = bezier(p, t0 + (t1 - t0) * k / samples)
+            if length > 1e-12:
+                s = max(0.0, min(1.0, ((q[0] - a[0]) * dx + (q[1] - a[1]) * dy) / (length * length)))
+                d = math.hypot(q[0] - a[0] - dx * s, q[1] - a[1] - dy * s)
+            else:
+                d = math.hypot(q[0] - a[0], q[1] - a[1])
+            worst = max(worst, d)
+        a, t0 = b, t1
+    return worst
+
+
+def e_error(p, params, by_length):
+    """ Largest relative difference of the extrusion per mm from the mean """
+    points = [p[0]] + [bezier(p, t) for t in params]
+    lengths = [math.hypot(b[0] - a[0], b[1] - a[1]) for a, b in zip(points, points[1:])]
+    total = sum(lengths)
+    worst, last = 0.0, 0.0
+    for t, mm, travel in zip(params, lengths, [sum(lengths[:i + 1]) for i in range(len(lengths))]):
+        fraction = travel / total if by_length else t
+        if mm > 1e-3:
+            worst = max(worst, abs((fraction - last) * total / mm - 1.0))
+        last = fraction
+    return worst
+
+
+def curves(seed=1):
+    """ Groups of slicer sized curves and their feedrate """
+    rnd = random.Random(seed)
+    out = {"perimeter": [], "s bend": [], "tight": []}
+    for _ in range(300):
+        # A turn of up to 90 degrees over 5 to 40 mm
+        chord = rnd.uniform(5.0, 40.0)
+        a0, turn = rnd.uniform(0, 2 * math.pi), rnd.uniform(-math.pi / 2, math.pi / 2)
+        p0 = (rnd.uniform(20, 180), rnd.uniform(20, 180))
+        p3 = (p0[0] + chord * math.cos(a0 + turn / 2), p0[1] + chord * math.sin(a0 + turn / 2))
+        k = chord / 3.0
+        out["perimeter"].append(((p0, (p0[0] + k * math.cos(a0), p0[1] + k * math.sin(a0)),
+                                  (p3[0] - k * math.cos(a0 + turn), p3[1] - k * math.sin(a0 + turn)), p3), 60.0))
+        # S bend over 10 to 30 mm
+        chord = rnd.uniform(10.0, 30.0)
+        k, side = chord * rnd.uniform(0.3, 0.6), rnd.uniform(0.3, 0.8)
+        p3 = (p0[0] + chord, p0[1])
+        out["s bend"].append(((p0, (p0[0] + k, p0[1] + k * side), (p3[0] - k, p3[1] - k * side), p3), 50.0))
+        # Tight curve of 1 to 4 mm with long handles, slow
+        chord = rnd.uniform(1.0, 4.0)
+        k = chord * rnd.uniform(0.5, 1.2)
+        p3 = (p0[0] + chord, p0[1])
+        out["tight"].append(((p0, (p0[0] + k * 0.3, p0[1] + k), (p3[0] - k * 0.3, p3[1] + k), p3), 25.0))
+    return out
+
+
+def benchmark(tolerance=BEZIER_TOLERANCE):
+    result = {}
+    for group, items in curves().items():
+        old_lines = new_lines = 0
+        old_dev = new_dev = new_uncapped_dev = old_e = new_e = 0.0
+        for p, fr in items:
+            old = old_flatten(p)
+            new, capped = new_flatten(p, fr, tolerance)
+            old_lines += len(old)
+            new_lines += len(new)
+            old_dev = max(old_dev, deviation(p, old))
+            d = deviation(p, new)
+            new_dev = max(new_dev, d)
+            if not capped:
+                new_uncapped_dev = max(new_uncapped_dev, d)
+            old_e = max(old_e, e_error(p, old, False))
+            new_e = max(new_e, e_error(p, new, True))
+        result[group] = (len(items), old_lines, old_dev, old_e, new_lines, new_dev, new_uncapped_dev, new_e)
+    return result
+
+
+class Flatten(unittest.TestCase):
+
+    def test_within_tolerance(self):
+        # Where the min segment time does not cap the count, the bound holds
+        for tolerance in (0.01, BEZIER_TOLERANCE, 0.1):
+            for group, r in benchmark(tolerance).items():
+                with self.subTest(group=group, tolerance=tolerance):
+                    self.assertLessEqual(r[6], tolerance)
+
+    def test_straight_line(self):
+        # Control points on the line: one line
+        p = ((0.0, 0.0), (10.0, 0.0), (20.0, 0.0), (30.0, 0.0))
+        self.assertEqual(new_flatten(p, 50.0)[0], [1.0])
+
+    def test_extrusion_by_length(self):
+        # E follows the length: the same per mm on every line of the curve
+        for group, r in benchmark().items():
+            with self.subTest(group=group):
+                self.assertLess(r[7], 1e-9)
+                self.assertGreater(r[3], 0.05)
+
+    def test_old_norm_one(self):
+        # The old check used a norm 1 distance with SIGMA 0.1: the lines could be
+        # up to 0.1 mm off the curve, the new ones stay within BEZIER_TOLERANCE
+        result = benchmark()
+        self.assertGreater(max(r[2] for r in result.values()), BEZIER_TOLERANCE)
+
+
+def report():
+    print("Lines and max deviation (mm), E per mm error; new with BEZIER_TOLERANCE %.3f, min segment time %d us"
+          % (BEZIER_TOLERANCE, MIN_SEGMENT_TIME_US))
+    print("%-10s %6s %10s %9s %8s %10s %9s %9s %8s" % ("curves", "count", "old lines", "old dev", "old E",
+                                                      "new lines", "new dev", "uncapped", "new E"))
+    for tolerance in (0.01, BEZIER_TOLERANCE):
+        if tolerance != BEZIER_TOLERANCE:
+            print("tolerance %.3f" % tolerance)
+        else:
+            print("tolerance %.3f (default)" % tolerance)
+        for group, (n, ol, od, oe, nl, nd, nu, ne) in benchmark(tolerance).items():
+            print("%-10s %6d %10.1f %9.4f %8.3f %10.1f %9.4f %9.4f %8.3f" % (group, n, ol / n, od, oe, nl / n, nd, nu, ne))
+
+
+if __name__ == "__main__":
+    if "-b" in sys.argv:
+        report()
+    else:
+        unittest.main()
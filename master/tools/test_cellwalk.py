@@ -0,0 +1,438 @@
+#!/usr/bin/env python3
+"""
+test_cellwalk.py - Tests of the mesh cell walk against the old splitting
+
+  python3 test_cellwalk.py        run the tests
+  python3 test_cellwalk.py -b     print the benchmark
+
+MeshCellWalk (feature/bedlevel/cellwalk) replaced three ways of splitting
+a move where it crosses the mesh lines:
+
+  MBL   mesh_bed_leveling::line_to_destination(), recursive with x_splits/y_splits
+  ABL   AutoBedLevel::line_to_destination(), the same on the bilinear grid
+  UBL   unified_bed_leveling::line_to_destination_cartesian(), vertical,
+        horizontal and generic stepping with the Z correction on the mesh lines
+
+Copies of the old code and of the walk split the same random moves. The
+cell indexes are computed in float as on the printer, the rest in double.
+
+  UBL       the sub-segment ends (XYZE, with the correction) are the same
+  MBL, ABL  the walk ends exactly where the move crosses the grid lines,
+            the old ends are a subset: when a split lands on a grid line it
+            is in the next cell, and the x_splits/y_splits flag of that line
+            stops the split of the lines before it
+
+Zero length sub-segments, dropped by the planner, are ignored.
+"""
+
+import math
+import random
+import struct
+import sys
+import unittest
+
+
+def div(a, b):
+    """ Float division as on the printer, x/0 is inf or nan """
+    if b:
+        return a / b
+    if a == 0 or math.isnan(a):
+        return math.nan
+    return math.copysign(math.inf, a) * math.copysign(1.0, b)
+
+
+def f32(v):
+    """ Round to float """
+    return struct.unpack("f", struct.pack("f", v))[0]
+
+
+def cell_index(v, origin, dist, last):
+    """ int8_t((v - origin) * RECIPROCAL(dist)) in float, constrained """
+    return min(max(int(f32(f32(v - origin) * f32(1.0 / dist))), 0), last)
+
+
+class Grid:
+
+    def __init__(self, min_x, min_y, dist_x, dist_y, points_x, points_y, seed=1):
+        self.min_x, self.min_y = min_x, min_y
+        self.dist_x, self.dist_y = dist_x, dist_y
+        self.points_x, self.points_y = points_x, points_y
+        self.max_x = min_x + dist_x * (points_x - 1)
+        self.max_y = min_y + dist_y * (points_y - 1)
+        rnd = random.Random(seed)
+        self.z = [[rnd.uniform(-0.3, 0.3) for _ in range(points_y)] for _ in range(points_x)]
+
+    def xpos(self, i):
+        return self.min_x + i * self.dist_x
+
+    def ypos(self, i):
+        return self.min_y + i * self.dist_y
+
+
+MBL = Grid(10.0, 10.0, 45.0, 45.0, 5, 5)
+ABL = Grid(15.0, 20.0, 56.666666, 40.0, 4, 5, seed=2)
+UBL = Grid(10.0, 10.0, 20.0, 20.0, 10, 10, seed=3)
+
+
+def cell_walk(start, end, origin, spacing, cells):
+    """ MeshCellWalk::next() until done """
+    dist = [e - s for s, e in zip(start, end)]
+    inv, cross, direction, line = [0, 0], [0, 0], [0, 0], [0, 0]
+    for i in range(2):
+        c1 = min(max(math.floor(f32(f32(start[i] - origin[i]) / spacing[i])), 0), cells[i] - 1)
+        c2 = min(max(math.floor(f32(f32(end[i] - origin[i]) / spacing[i])), 0), cells[i] - 1)
+        inv[i] = 1.0 / dist[i] if dist[i] else 0.0
+        cross[i] = abs(c2 - c1)
+        direction[i] = -1 if c2 < c1 else 1
+        line[i] = c1 if c2 < c1 else c1 + 1
+    out = []
+    while cross[0] or cross[1]:
+        g = [origin[i] + line[i] * spacing[i] for i in range(2)]
+        tx = (g[0] - start[0]) * inv[0] if cross[0] else 2.0
+        ty = (g[1] - start[1]) * inv[1] if cross[1] else 2.0
+        t = min(tx, ty)
+        on = (tx <= t, ty <= t)
+        for i in range(2):
+            if on[i]:
+                line[i] += direction[i]
+                cross[i] -= 1
+        if t <= 0.0 or t >= 1.0:
+            continue
+        point = [s + d * t for s, d in zip(start, dist)]
+        for i in range(2):
+            if on[i]:
+                point[i] = g[i]
+        out.append(tuple(point))
+    out.append(tuple(end))
+    return out
+
+
+def old_split(grid, start, end, stats=None):
+    """ The old recursive MBL and ABL line_to_destination() """
+    out = []
+    position = list(start)
+
+    def cells(p):
+        return (cell_index(p[0], grid.min_x, grid.dist_x, grid.points_x - 2),
+                cell_index(p[1], grid.min_y, grid.dist_y, grid.points_y - 2))
+
+    def line_to(destination, x_splits, y_splits, depth):
+        nonlocal position
+        if stats is not None:
+            stats["depth"] = max(stats["depth"], depth)
+        scel, ecel = cells(position), cells(destination)
+        if scel == ecel:
+            out.append(tuple(destination))
+            position = list(destination)
+            return
+        gcx, gcy = max(scel[0], ecel[0]), max(scel[1], ecel[1])
+        end = list(destination)
+        if ecel[0] != scel[0] and x_splits >> gcx & 1:
+            x_splits &= ~(1 << gcx)
+            split = list(destination)
+            split[0] = grid.xpos(gcx)
+            normalized = (split[0] - position[0]) / (end[0] - position[0])
+            split[1] = position[1] + (end[1] - position[1]) * normalized
+        elif ecel[1] != scel[1] and y_splits >> gcy & 1:
+            y_splits &= ~(1 << gcy)
+            split = list(destination)
+            split[1] = grid.ypos(gcy)
+            normalized = (split[1] - position[1]) / (end[1] - position[1])
+            split[0] = position[0] + (end[0] - position[0]) * normalized
+        else:
+            out.append(tuple(destination))
+            position = list(destination)
+            return
+        split[2] = position[2] + (end[2] - position[2]) * normalized
+        split[3] = position[3] + (end[3] - position[3]) * normalized
+        line_to(split, x_splits, y_splits, depth + 1)
+        line_to(end, x_splits, y_splits, depth + 1)
+
+    line_to(list(end), 0xFFFF, 0xFFFF, 1)
+    return out
+
+
+def new_split(grid, start, end):
+    """ MBL and ABL line_to_destination() with the walk """
+    return cell_walk(start, end, (grid.min_x, grid.min_y), (grid.dist_x, grid.dist_y),
+                     (grid.points_x - 1, grid.points_y - 1))
+
+
+def ubl_cell(grid, x, y):
+    """ unified_bed_leveling::cell_index_x/y() """
+    return (cell_index(x, grid.min_x, grid.dist_x, grid.points_x - 1),
+            cell_index(y, grid.min_y, grid.dist_y, grid.points_y - 1))
+
+
+def ubl_z_correction(grid, x, y):
+    """ unified_bed_leveling::get_z_correction() """
+    cx, cy = ubl_cell(grid, x, y)
+    cx1, cy1 = min(cx, grid.points_x - 2) + 1, min(cy, grid.points_y - 2) + 1
+    z = grid.z
+    calc = lambda a0, a1, z1, a2, z2: z1 + (z2 - z1) * (a0 - a1) / (a2 - a1)
+    z1 = calc(x, grid.xpos(cx), z[cx][cy], grid.xpos(cx + 1), z[cx1][cy])
+    z2 = calc(x, grid.xpos(cx), z[cx][cy1], grid.xpos(cx + 1), z[cx1][cy1])
+    return calc(y, grid.ypos(cy), z1, grid.ypos(cy + 1), z2)
+
+
+def old_ubl(grid, start, end):
+    """ The old line_to_destination_cartesian(), without fade """
+    out = []
+    z = grid.z
+
+    def on_horizontal(rx0, x1_i, yi):
+        if not (0 <= x1_i <= grid.points_x - 1 and 0 <= yi <= grid.points_y - 1):
+            return math.nan
+        xratio = (rx0 - grid.xpos(x1_i)) / grid.dist_x
+        return z[x1_i][yi] + xratio * (z[min(x1_i, grid.points_x - 2) + 1][yi] - z[x1_i][yi])
+
+    def on_vertical(ry0, xi, y1_i):
+        if not (0 <= xi <= grid.points_x - 1 and 0 <= y1_i <= grid.points_y - 1):
+            return math.nan
+        yratio = (ry0 - grid.ypos(y1_i)) / grid.dist_y
+        return z[xi][y1_i] + yratio * (z[xi][min(y1_i, grid.points_y - 2) + 1] - z[xi][y1_i])
+
+    def segment(x, y, zp, z0, e):
+        out.append((x, y, zp + (0.0 if math.isnan(z0) else z0), e))
+
+    istart, iend = ubl_cell(grid, *start[:2]), ubl_cell(grid, *end[:2])
+
+    def final_move():
+        xratio = (end[0] - grid.xpos(iend[0])) / grid.dist_x
+        if iend[0] >= grid.points_x - 1:
+            z1 = z2 = 0.0
+        else:
+            z1 = z[iend[0]][iend[1]] + xratio * (z[iend[0] + 1][iend[1]] - z[iend[0]][iend[1]])
+            z2 = z[iend[0]][min(iend[1] + 1, grid.points_y - 1)] + xratio * \
+                (z[iend[0] + 1][min(iend[1] + 1, grid.points_y - 1)] - z[iend[0]][min(iend[1] + 1, grid.points_y - 1)])
+        yratio = (end[1] - grid.ypos(iend[1])) / grid.dist_y
+        z0 = z1 + (z2 - z1) * yratio if iend[1] < grid.points_y - 1 else 0.0
+        segment(end[0], end[1], end[2], z0, end[3])
+        return out
+
+    if istart == iend:
+        return final_move()
+
+    dist = (end[0] - start[0], end[1] - start[1])
+    neg = (dist[0] < 0, dist[1] < 0)
+    ineg = (int(neg[0]), int(neg[1]))
+    sign = (-1.0 if neg[0] else 1.0, -1.0 if neg[1] else 1.0)
+    iadd = (0 if iend[0] == istart[0] else int(sign[0]), 0 if iend[1] == istart[1] else int(sign[1]))
+    use_x_dist = sign[0] * dist[0] > sign[1] * dist[1]
+    on_axis_distance = dist[0] if use_x_dist else dist[1]
+    e_normalized_dist = div(end[3] - start[3], on_axis_distance)
+    z_normalized_dist = div(end[2] - start[2], on_axis_distance)
+    icell = list(istart)
+    ratio = div(dist[1], dist[0])
+    c = start[1] - ratio * start[0] if not math.isinf(ratio) else math.nan
+    inf_normalized_flag = math.isinf(e_normalized_dist)
+    inf_ratio_flag = math.isinf(ratio)
+
+    def ze(rx, ry):
+        if inf_normalized_flag:
+            return end[2], end[3]
+        on_axis = rx - start[0] if use_x_dist else ry - start[1]
+        return start[2] + on_axis * z_normalized_dist, start[3] + on_axis * e_normalized_dist
+
+    if iadd[0] == 0:
+        icell[1] += ineg[1]
+        while icell[1] != iend[1] + ineg[1]:
+            icell[1] += iadd[1]
+            next_y = grid.ypos(icell[1])
+            rx = start[0] if inf_ratio_flag else (next_y - c) / ratio
+            z0 = on_horizontal(rx, icell[0], icell[1])
+            if next_y != start[1]:
+                zp, e = ze(rx, next_y)
+                segment(rx, next_y, zp, z0, e)
+        return final_move()
+
+    if iadd[1] == 0:
+        icell[0] += ineg[0]
+        while icell[0] != iend[0] + ineg[0]:
+            icell[0] += iadd[0]
+            rx = grid.xpos(icell[0])
+            ry = ratio * rx + c
+            z0 = on_vertical(ry, icell[0], icell[1])
+            if rx != start[0]:
+                zp, e = ze(rx, ry)
+                segment(rx, ry, zp, z0, e)
+        return final_move()
+
+    cnt = [abs(istart[0] - iend[0]), abs(istart[1] - iend[1])]
+    icell = [icell[0] + ineg[0], icell[1] + ineg[1]]
+    while cnt[0] or cnt[1]:
+        next_x = grid.xpos(icell[0] + iadd[0])
+        next_y = grid.ypos(icell[1] + iadd[1])
+        ry = ratio * next_x + c
+        rx = (next_y - c) / ratio
+        if neg[0] == (rx > next_x):
+            z0 = on_horizontal(rx, icell[0] - ineg[0], icell[1] + iadd[1])
+            zp, e = ze(rx, next_y)
+            segment(rx, next_y, zp, z0, e)
+            icell[1] += iadd[1]
+            cnt[1] -= 1
+        else:
+            z0 = on_vertical(ry, icell[0] + iadd[0], icell[1] - ineg[1])
+            zp, e = ze(next_x, ry)
+            segment(next_x, ry, zp, z0, e)
+            icell[0] += iadd[0]
+            cnt[0] -= 1
+        if cnt[0] < 0 or cnt[1] < 0:
+            break
+    return final_move()
+
+
+def new_ubl(grid, start, end):
+    """ line_to_destination_cartesian() with the walk, without fade """
+    out = []
+    for p in cell_walk(start, end, (grid.min_x - grid.dist_x, grid.min_y - grid.dist_y),
+                       (grid.dist_x, grid.dist_y), (grid.points_x + 1, grid.points_y + 1)):
+        out.append((p[0], p[1], p[2] + ubl_z_correction(grid, p[0], p[1]), p[3]))
+    return out
+
+
+def crossings(grid, start, end):
+    """ Brute force: where the move crosses the grid lines between the cells """
+    t = set()
+    for axis, lines in ((0, [grid.xpos(i) for i in range(1, grid.points_x - 1)]),
+                        (1, [grid.ypos(i) for i in range(1, grid.points_y - 1)])):
+        d = end[axis] - start[axis]
+        for g in lines:
+            if d and 0.0 < (g - start[axis]) / d < 1.0:
+                t.add(round((g - start[axis]) / d, 9))
+    return [tuple(s + (e - s) * k for s, e in zip(start, end)) for k in sorted(t)] + [tuple(end)]
+
+
+def drop_zero(points, start):
+    """ Sub-segments with no XY length are dropped by the planner """
+    out, last = [], start
+    for p in points:
+        if math.hypot(p[0] - last[0], p[1] - last[1]) > 1e-6:
+            out.append(p)
+            last = p
+    return out
+
+
+def random_moves(grid, count, seed=1, margin=0.0):
+    """
+    Moves over the grid with a share of axis aligned moves, moves on the
+    mesh lines and through the nodes. margin > 0 goes that far off the mesh.
+    """
+    rnd = random.Random(seed)
+    lo_x, hi_x = grid.min_x - margin, grid.max_x + margin
+    lo_y, hi_y = grid.min_y - margin, grid.max_y + margin
+    # Inside the mesh the ends stay off MESH_MAX, where the old UBL dropped the correction
+    inner = 1e-3 if margin == 0 else 0.0
+    point = lambda: [rnd.uniform(lo_x, hi_x - inner), rnd.uniform(lo_y, hi_y - inner), rnd.uniform(0.2, 1.0), rnd.uniform(0, 10)]
+    moves = []
+    for n in range(count):
+        a, b = point(), point()
+        kind = n % 5
+        if kind == 1:
+            b[1] = a[1]
+        elif kind == 2:
+            b[0] = a[0]
+        elif kind == 3:
+            a[0] = b[0] = grid.xpos(rnd.randrange(grid.points_x - 1))
+        elif kind == 4:
+            i, j = rnd.randrange(1, grid.points_x - 1), rnd.randrange(1, grid.points_y - 1)
+            k = rnd.uniform(0.2, 1.0)
+            a[0], a[1] = grid.xpos(i) - grid.dist_x * k, grid.ypos(j) - grid.dist_y * k
+            b[0], b[1] = grid.xpos(i) + grid.dist_x * k, grid.ypos(j) + grid.dist_y * k
+            if grid.dist_x != grid.dist_y:
+                b[1] = a[1] + (b[0] - a[0]) * (grid.dist_y / grid.dist_x)
+        moves.append((tuple(a), tuple(b)))
+    return moves
+
+
+class CellWalk(unittest.TestCase):
+
+    def assertSamePoints(self, a, b, places=5):
+        self.assertEqual(len(a), len(b))
+        for p, q in zip(a, b):
+            for k in range(4):
+                self.assertAlmostEqual(p[k], q[k], places=places)
+
+    def test_mbl_abl(self):
+        # The walk splits at every grid line crossed, the old code at some of them
+        for name, grid in (("MBL", MBL), ("ABL", ABL)):
+            for margin in (0.0, 25.0):
+                for start, end in random_moves(grid, 2000, margin=margin):
+                    with self.subTest(grid=name, start=start, end=end):
+                        expected = crossings(grid, start, end)
+                        self.assertSamePoints(drop_zero(new_split(grid, start, end), start), expected)
+                        for p in drop_zero(old_split(grid, start, end), start):
+                            self.assertTrue(any(max(abs(p[k] - q[k]) for k in range(4)) < 1e-5 for q in expected))
+
+    def test_old_missed_split(self):
+        # Three X lines crossed, the old code split at the last one only
+        start, end = (MBL.xpos(0) + 5.0, 20.0, 0.3, 0.0), (MBL.xpos(3) + 5.0, 20.0, 0.3, 1.0)
+        self.assertEqual([p[0] for p in old_split(MBL, start, end)], [MBL.xpos(3), end[0]])
+        self.assertEqual([p[0] for p in new_split(MBL, start, end)], [MBL.xpos(1), MBL.xpos(2), MBL.xpos(3), end[0]])
+
+    def test_ubl(self):
+        # Inside the mesh, split points and corrections match
+        for start, end in random_moves(UBL, 2000):
+            with self.subTest(start=start, end=end):
+                self.assertSamePoints(drop_zero(old_ubl(UBL, start, end), start), drop_zero(new_ubl(UBL, start, end), start))
+
+    def test_ubl_edges(self):
+        # Off the mesh the old code split at MESH_MAX but not at MESH_MIN,
+        # the walk splits at both
+        start, end = (UBL.min_x - 15.0, 50.0, 0.3, 0.0), (UBL.min_x + 5.0, 50.0, 0.3, 1.0)
+        self.assertEqual(len(drop_zero(old_ubl(UBL, start, end), start)), 1)
+        self.assertEqual([p[0] for p in new_ubl(UBL, start, end)], [UBL.min_x, end[0]])
+        start, end = (UBL.max_x - 5.0, 50.0, 0.3, 0.0), (UBL.max_x + 15.0, 50.0, 0.3, 1.0)
+        self.assertEqual([p[0] for p in drop_zero(old_ubl(UBL, start, end), start)], [UBL.max_x, end[0]])
+        self.assertEqual([p[0] for p in new_ubl(UBL, start, end)], [UBL.max_x, end[0]])
+
+    def test_node_crossing(self):
+        # A move through a grid node gives one sub-segment end there
+        start, end = (MBL.xpos(1) - 10.0, MBL.ypos(1) - 10.0, 0.3, 0.0), (MBL.xpos(1) + 10.0, MBL.ypos(1) + 10.0, 0.3, 1.0)
+        points = new_split(MBL, start, end)
+        self.assertEqual(len(points), 2)
+        self.assertEqual(points[0][:2], (MBL.xpos(1), MBL.ypos(1)))
+        # The old code split there twice, once with no length
+        points = old_split(MBL, start, end)
+        self.assertEqual(len(points), 3)
+        self.assertEqual(len(drop_zero(points, start)), 2)
+
+    def test_walk_order(self):
+        # Sub-segment ends go along the move, one per cell
+        for start, end in random_moves(UBL, 500, margin=30.0):
+            points = new_split(UBL, start, end)
+            length = math.hypot(end[0] - start[0], end[1] - start[1])
+            last = 0.0
+            for p in points:
+                t = math.hypot(p[0] - start[0], p[1] - start[1]) / length if length else 1.0
+                self.assertGreater(t, last - 1e-9)
+                last = t
+            self.assertEqual(points[-1], end)
+
+
+def report():
+    print("2000 moves up to 25 mm past the mesh (UBL inside the mesh)")
+    print("%-4s %6s %9s %9s %9s %11s %12s %10s" % ("", "grid", "crossed", "walk", "old", "old zero", "old missing", "old depth"))
+    for name, grid in (("MBL", MBL), ("ABL", ABL), ("UBL", UBL)):
+        stats = {"depth": 0}
+        crossed = walk = old = zero = missing = 0
+        for start, end in random_moves(grid, 2000, margin=0.0 if grid is UBL else 25.0):
+            if grid is UBL:
+                points, expected = old_ubl(grid, start, end), drop_zero(new_ubl(grid, start, end), start)
+            else:
+                points, expected = old_split(grid, start, end, stats), crossings(grid, start, end)
+            kept = drop_zero(points, start)
+            crossed += len(expected)
+            walk += len(drop_zero(new_ubl(grid, start, end) if grid is UBL else new_split(grid, start, end), start))
+            old += len(kept)
+            zero += len(points) - len(kept)
+            missing += len(expected) - len(kept)
+        print("%-4s %3dx%-2d %9d %9d %9d %11d %12d %10s" % (name, grid.points_x, grid.points_y, crossed, walk, old, zero,
+                                                         missing, stats["depth"] if grid is not UBL else "-"))
+
+
+if __name__ == "__main__":
+    if "-b" in sys.argv:
+        report()
+    else:
+        unittest.main()
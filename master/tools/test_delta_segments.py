@@ -0,0 +1,213 @@
+#!/usr/bin/env python3
+"""
+test_delta_segments.py - Delta segmentation benchmark
+
+  python3 test_delta_segments.py        run the tests
+  python3 test_delta_segments.py -b     print the benchmark
+
+Moves of a large delta are split as Delta_Mechanics::
+prepare_move_to_destination_mech_specific() does, by segments per second
+(DELTA_SEGMENT_TOLERANCE 0) or by tolerance_lines(). Between the ends of a
+line the steppers move the towers linearly; the effector position is found
+by forward kinematics and compared with the straight Cartesian move.
+"""
+
+import math
+import random
+import sys
+import unittest
+
+# Large delta, Configuration_Delta.h style
+DIAGONAL_ROD = 440.0
+RADIUS = 200.0
+PRINT_RADIUS = 180.0
+SEGMENTS_PER_SECOND_PRINT = 200
+SEGMENTS_PER_LINE = 20
+TOLERANCE = 0.01
+
+TOWERS = [(math.cos(math.radians(a)) * RADIUS, math.sin(math.radians(a)) * RADIUS) for a in (210, 330, 90)]
+D2 = DIAGONAL_ROD ** 2
+
+
+def transform(p):
+    """ Delta_Mechanics::Transform() """
+    return [p[2] + math.sqrt(D2 - (p[0] - tx) ** 2 - (p[1] - ty) ** 2) for tx, ty in TOWERS]
+
+
+def forward(h):
+    """ Effector position from the tower heights (trilateration) """
+    p1, p2, p3 = [(tx, ty, z) for (tx, ty), z in zip(TOWERS, h)]
+    sub = lambda a, b: [a[i] - b[i] for i in range(3)]
+    dot = lambda a, b: sum(a[i] * b[i] for i in range(3))
+    scale = lambda a, k: [x * k for x in a]
+    ex = sub(p2, p1)
+    d = math.sqrt(dot(ex, ex))
+    ex = scale(ex, 1.0 / d)
+    t = sub(p3, p1)
+    i = dot(ex, t)
+    ey = sub(t, scale(ex, i))
+    j = math.sqrt(dot(ey, ey))
+    ey = scale(ey, 1.0 / j)
+    ez = [ex[1] * ey[2] - ex[2] * ey[1], ex[2] * ey[0] - ex[0] * ey[2], ex[0] * ey[1] - ex[1] * ey[0]]
+    x = d / 2.0
+    y = (i * i + j * j) / (2.0 * j) - i * x / j
+    z = math.sqrt(D2 - x * x - y * y)
+    # The effector is below the carriages
+    return [p1[k] + x * ex[k] + y * ey[k] - z * ez[k] for k in range(3)]
+
+
+def segments_lines(start, end, feedrate):
+    """ Lines of the segments per second scheme, and the segments cap """
+    distance = math.dist(start, end)
+    segments = max(1, int(SEGMENTS_PER_SECOND_PRINT * distance / feedrate))
+    return (segments + SEGMENTS_PER_LINE - 1) // SEGMENTS_PER_LINE, segments
+
+
+def tolerance_lines(start, end, tolerance=TOLERANCE):
+    """ Delta_Mechanics::tolerance_lines() """
+    distance = math.dist(start, end)
+    dx, dy = end[0] - start[0], end[1] - start[1]
+    ux, uy = dx / distance, dy / distance
+    u2 = ux * ux + uy * uy
+    d2 = dx * dx + dy * dy
+    max_curvature = 0.0
+    for tx, ty in TOWERS:
+        r0x, r0y = start[0] - tx, start[1] - ty
+        t_near = min(max(-(r0x * dx + r0y * dy) / d2, 0.0), 1.0)
+        for t in (0.0, 0.5, 1.0, t_near):
+            rx, ry = r0x + dx * t, r0y + dy * t
+            w2 = D2 - rx * rx - ry * ry
+            w = math.sqrt(w2)
+            ru = rx * ux + ry * uy
+            max_curvature = max(max_curvature, (u2 + ru * ru / w2) / w)
+    if max_curvature < 1e-9:
+        return 1
+    return max(1, math.ceil(distance / math.sqrt(8.0 * tolerance / max_curvature)))
+
+
+def line_deviation(start, end, lines, samples=8):
+    """ Max distance of the effector from the straight move """
+    direction = [end[k] - start[k] for k in range(3)]
+    length = math.sqrt(sum(c * c for c in direction))
+    u = [c / length for c in direction]
+    worst = 0.0
+    for n in range(lines):
+        a = [start[k] + direction[k] * n / lines for k in range(3)]
+        b = [start[k] + direction[k] * (n + 1) / lines for k in range(3)]
+        ha, hb = transform(a), transform(b)
+        for s in range(1, samples):
+            f = s / samples
+            p = forward([ha[k] + (hb[k] - ha[k]) * f for k in range(3)])
+            v = [p[k] - start[k] for k in range(3)]
+            along = sum(v[k] * u[k] for k in range(3))
+            worst = max(worst, math.sqrt(max(0.0, sum(c * c for c in v) - along * along)))
+    return worst
+
+
+def random_point(rnd, radius=PRINT_RADIUS):
+    while True:
+        x, y = rnd.uniform(-radius, radius), rnd.uniform(-radius, radius)
+        if x * x + y * y <= radius * radius:
+            return (x, y, 0.3)
+
+
+def edge_move(rnd, length):
+    """ A move along the edge of the print radius """
+    a = rnd.uniform(0, 2 * math.pi)
+    r = PRINT_RADIUS - 2.0
+    da = length / r
+    return (r * math.cos(a), r * math.sin(a), 0.3), (r * math.cos(a + da), r * math.sin(a + da), 0.3)
+
+
+def moves(seed=1):
+    rnd = random.Random(seed)
+    out = {"random": [], "center": [], "edge": [], "short": []}
+    for _ in range(60):
+        out["random"].append((random_point(rnd), random_point(rnd)))
+        a = random_point(rnd, 40.0)
+        out["center"].append((a, (a[0] + rnd.uniform(20, 60), a[1] + rnd.uniform(-10, 10), a[2])))
+        out["edge"].append(edge_move(rnd, rnd.uniform(10, 60)))
+        a = random_point(rnd, PRINT_RADIUS - 5.0)
+        out["short"].append((a, (a[0] + rnd.uniform(-2, 2), a[1] + rnd.uniform(-2, 2), a[2])))
+    return out
+
+
+def benchmark(feedrate=60.0, tolerance=TOLERANCE):
+    """ Per move group: mm, lines and max deviation of both schemes """
+    result = {}
+    for group, items in moves().items():
+        mm = fixed_lines = adaptive_lines = 0
+        fixed_dev = adaptive_dev = 0.0
+        for start, end in items:
+            lines, segments = segments_lines(start, end, feedrate)
+            adaptive = min(tolerance_lines(start, end, tolerance), segments)
+            mm += math.dist(start, end)
+            fixed_lines += lines
+            adaptive_lines += adaptive
+            fixed_dev = max(fixed_dev, line_deviation(start, end, lines))
+            adaptive_dev = max(adaptive_dev, line_deviation(start, end, adaptive))
+        result[group] = (mm, fixed_lines, fixed_dev, adaptive_lines, adaptive_dev)
+    return result
+
+
+class Segmentation(unittest.TestCase):
+
+    def test_forward_kinematics(self):
+        rnd = random.Random(3)
+        for _ in range(20):
+            p = random_point(rnd)
+            q = forward(transform(p))
+            for k in range(3):
+                self.assertAlmostEqual(p[k], q[k], places=6)
+
+    def test_within_tolerance(self):
+        # The tower bound keeps the Cartesian error within the tolerance
+        for tolerance in (0.005, TOLERANCE, 0.05):
+            for group, (_, _, _, _, deviation) in benchmark(tolerance=tolerance).items():
+                with self.subTest(group=group, tolerance=tolerance):
+                    self.assertLess(deviation, tolerance)
+
+    def test_closest_approach(self):
+        # A move passing close to a tower, tolerance_lines() samples the closest point too
+        tx, ty = TOWERS[2]
+        k = (PRINT_RADIUS - 1.0) / RADIUS
+        start, end = (tx * k - 30.0, ty * k - 3.0, 0.3), (tx * k + 30.0, ty * k - 3.0, 0.3)
+        self.assertLess(line_deviation(start, end, tolerance_lines(start, end)), TOLERANCE)
+
+    def test_fewer_lines_when_slow(self):
+        # Slow moves: the segments per second scheme splits more than needed
+        result = benchmark(feedrate=30.0)
+        for group in ("random", "center", "edge"):
+            _, fixed, _, adaptive, _ = result[group]
+            self.assertLess(adaptive, fixed)
+
+    def test_finer_when_fast(self):
+        # Fast moves: the segments per second scheme is out of tolerance
+        for group, (_, _, fixed_dev, _, adaptive_dev) in benchmark(feedrate=120.0).items():
+            if group == "short":
+                continue
+            with self.subTest(group=group):
+                self.assertGreater(fixed_dev, TOLERANCE)
+                self.assertLess(adaptive_dev, TOLERANCE)
+
+
+def report():
+    print("Delta rod %.0f radius %.0f print radius %.0f, %d segments/s, %d segments/line, tolerance %.3f mm"
+          % (DIAGONAL_ROD, RADIUS, PRINT_RADIUS, SEGMENTS_PER_SECOND_PRINT, SEGMENTS_PER_LINE, TOLERANCE))
+    for feedrate in (30.0, 60.0, 120.0):
+        print("\nfeedrate %.0f mm/s" % feedrate)
+        print("%-8s %12s %12s %12s %12s" % ("moves", "fixed l/mm", "fixed dev", "adapt l/mm", "adapt dev"))
+        for group, (mm, fl, fd, al, ad) in benchmark(feedrate).items():
+            print("%-8s %12.3f %12.5f %12.3f %12.5f" % (group, fl / mm, fd, al / mm, ad))
+    print("\nfeedrate 60 mm/s, adaptive by tolerance")
+    print("%-8s %12s %12s %12s" % ("moves", "tolerance", "adapt l/mm", "adapt dev"))
+    for tolerance in (0.005, 0.02, 0.05):
+        for group, (mm, _, _, al, ad) in benchmark(60.0, tolerance).items():
+            print("%-8s %12.3f %12.3f %12.5f" % (group, tolerance, al / mm, ad))
+
+
+if __name__ == "__main__":
+    if "-b" in sys.argv:
+        report()
+    else:
+        unittest.main()
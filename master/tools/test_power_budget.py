@@ -0,0 +1,208 @@
+#!/usr/bin/env python3
+"""
+test_power_budget.py - Simulation of the heater power budget
+
+  python3 test_power_budget.py
+
+A bed, a chamber and two hotends heat at once on a 300 W supply. Every
+heater is a first order plant controlled like Heater::get_output() (full
+power outside the hysteresis, pid_data_t::compute() inside), and every
+100ms the outputs go through a copy of TempManager::apply_power_budget().
+
+The result is compared with the serial staggering done by hand in start
+G-code:
+
+  serial    M190, M191, M109 T0, M109 T1, one heater at a time
+  staged    M140 and M141, wait both, then M104 T0 and T1, wait both
+"""
+
+import unittest
+
+DT = 0.1                            # tempManager.spin period (s)
+AMBIENT = 25.0
+TEMP_WINDOW = 1.0                   # M109/M190 wait until within this
+HEATER_POWER_BUDGET_WATTS = 300.0
+
+
+class Heater:
+    """ Plant and controller of one heater """
+
+    def __init__(self, name, watts, gain, tau, target, kp, ki, kd, hysteresis=2.0):
+        self.name, self.watts, self.gain, self.tau = name, watts, gain, tau
+        self.kp, self.ki, self.kd = kp, ki, kd
+        self.hysteresis = hysteresis
+        self.target = target
+        self.temp = AMBIENT
+        self.active = False
+        self.pwm = 0
+        self.limited = False
+        # pid_data_t
+        self.i_sum = self.pid_output = self.last_temp = 0.0
+        self.next_sample = 0.0
+
+    def compute(self, now):
+        """ pid_data_t::compute(), once a second """
+        if now >= self.next_sample:
+            self.next_sample = now + 1.0
+            error = self.target - self.temp
+            d_input = self.temp - self.last_temp
+            self.i_sum += self.ki * error
+            self.i_sum -= self.kp * d_input
+            self.i_sum = min(max(self.i_sum, 0.0), 255.0)
+            self.pid_output = min(max(self.i_sum - self.kd * d_input, 0.0), 255.0)
+            self.last_temp = self.temp
+        return self.pid_output
+
+    def limit_output(self, output):
+        """ pid_data_t::limit_output() """
+        if output < self.pid_output:
+            self.i_sum = min(self.i_sum, output)
+
+    def holding(self):
+        """ Heater::isHolding() """
+        return abs(self.target - self.temp) < self.hysteresis
+
+    def get_output(self, now):
+        """ Heater::get_output() """
+        if not self.active:
+            self.pwm = 0
+        elif self.temp >= self.target + self.hysteresis:
+            self.pwm = 0
+        elif self.temp <= self.target - self.hysteresis:
+            self.pwm = 255
+        else:
+            self.pwm = int(self.compute(now))
+
+    def step(self):
+        power = self.pwm / 255.0
+        self.temp += (self.gain * power - (self.temp - AMBIENT)) * DT / self.tau
+
+    def power(self):
+        return self.watts * self.pwm / 255.0
+
+    def reached(self):
+        return abs(self.temp - self.target) <= TEMP_WINDOW
+
+
+def printer():
+    return [
+        Heater("bed",     200.0, gain=90.0,  tau=400.0,  target=90.0,  kp=60.0, ki=2.0, kd=200.0),
+        Heater("chamber", 100.0, gain=40.0,  tau=1200.0, target=45.0,  kp=90.0, ki=1.0, kd=0.0),
+        Heater("T0",      40.0,  gain=280.0, tau=90.0,   target=210.0, kp=20.0, ki=1.0, kd=60.0),
+        Heater("T1",      40.0,  gain=280.0, tau=90.0,   target=210.0, kp=20.0, ki=1.0, kd=60.0),
+    ]
+
+
+def apply_power_budget(heaters, budget_watts=HEATER_POWER_BUDGET_WATTS):
+    """ TempManager::apply_power_budget() """
+    for h in heaters:
+        h.limited = False
+    if sum(h.power() for h in heaters) <= budget_watts:
+        return
+    budget = budget_watts
+    waiting = [h for h in heaters if h.pwm]
+    while waiting:
+        act = max(waiting, key=lambda h: (h.holding(), abs(h.target - h.temp)))
+        waiting.remove(act)
+        if act.power() <= budget:
+            budget -= act.power()
+        else:
+            act.pwm = int(budget * 255.0 / act.watts)
+            act.limited = True
+            if act.holding():
+                act.limit_output(act.pwm)
+            budget = 0.0
+
+
+def simulate(stages, budget=True, limit=3600.0):
+    """
+    Heat the printer, stages is a list of heater name groups: the heaters
+    of a group are switched on together and waited for before the next.
+    Return the time all heaters are at target and the peak power drawn.
+    """
+    heaters = printer()
+    by_name = {h.name: h for h in heaters}
+    stage, now, peak = 0, 0.0, 0.0
+    while now < limit:
+        if stage < len(stages):
+            group = [by_name[n] for n in stages[stage]]
+            for h in group:
+                h.active = True
+            if all(h.reached() for h in group):
+                stage += 1
+                continue
+        elif all(h.reached() for h in heaters):
+            return now, peak
+        for h in heaters:
+            h.get_output(now)
+        if budget:
+            apply_power_budget(heaters)
+        peak = max(peak, sum(h.power() for h in heaters))
+        for h in heaters:
+            h.step()
+        now += DT
+    return None, peak
+
+
+ALL = [("bed", "chamber", "T0", "T1")]
+SERIAL = [("bed",), ("chamber",), ("T0",), ("T1",)]
+STAGED = [("bed", "chamber"), ("T0", "T1")]
+
+
+class Scenarios(unittest.TestCase):
+
+    def test_without_budget_overloads(self):
+        # The reason for the budget: all together draw 380 W
+        _, peak = simulate(ALL, budget=False)
+        self.assertGreater(peak, HEATER_POWER_BUDGET_WATTS)
+
+    def test_budget_is_respected(self):
+        for stages in (ALL, SERIAL, STAGED):
+            done, peak = simulate(stages)
+            self.assertIsNotNone(done)
+            self.assertLessEqual(peak, HEATER_POWER_BUDGET_WATTS + 1e-6)
+
+    def test_faster_than_staggering(self):
+        scheduled, _ = simulate(ALL)
+        serial, _ = simulate(SERIAL)
+        staged, _ = simulate(STAGED)
+        self.assertLess(scheduled, serial * 0.6)
+        self.assertLess(scheduled, staged)
+
+    def test_holds_all_targets(self):
+        # Holding needs about 240 W, every heater must settle on target
+        # and stay there, not hover at the edge of its hysteresis band
+        heaters = printer()
+        for h in heaters:
+            h.active = True
+        now = 0.0
+        while now < 1800.0:
+            for h in heaters:
+                h.get_output(now)
+            apply_power_budget(heaters)
+            for h in heaters:
+                h.step()
+            now += DT
+            if now > 1500.0:
+                for h in heaters:
+                    self.assertLess(abs(h.target - h.temp), 0.5, h.name)
+
+    def test_lower_budget(self):
+        # A supply just over the holding power still gets every heater to target
+        heaters = printer()
+        for h in heaters:
+            h.active = True
+        now = 0.0
+        while now < 3600.0 and not all(h.reached() for h in heaters):
+            for h in heaters:
+                h.get_output(now)
+            apply_power_budget(heaters, 250.0)
+            self.assertLessEqual(sum(h.power() for h in heaters), 250.0 + 1e-6)
+            for h in heaters:
+                h.step()
+            now += DT
+        self.assertTrue(all(h.reached() for h in heaters))
+
+
+if __name__ == "__main__":
+    unittest.main()
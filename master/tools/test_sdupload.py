@@ -0,0 +1,218 @@
+#!/usr/bin/env python3
+"""
+test_sdupload.py - Round trip tests of sdupload.py
+
+  python3 test_sdupload.py
+
+sdupload.upload() talks to a copy of the firmware side of M28 B:
+SDCard::startBinaryWrite(), upload_byte(), check_upload() and
+endBinaryWrite(), the CRC of crc16() in utility.cpp and the G-code lines
+of the upload port before and after the frames. The link between them
+can flip bits, drop and add bytes. Time runs only while the host waits
+for an answer, in steps of 10 ms.
+"""
+
+import random
+import unittest
+
+import sdupload
+
+UPLOAD_FRAME_SIZE = 512
+UPLOAD_QUIET_MS = 50
+UPLOAD_TIMEOUT_MS = 1000
+UPLOAD_IDLE_MS = 10000
+UPLOAD_RETRY = 10
+
+
+def fw_crc16(data):
+    """ crc16() of utility.cpp """
+    crc = 0
+    for b in data:
+        crc = (crc ^ (b << 8)) & 0xFFFF
+        for _ in range(8):
+            crc = ((crc << 1) ^ 0x1021) & 0xFFFF if crc & 0x8000 else (crc << 1) & 0xFFFF
+    return crc
+
+
+class Firmware:
+    """ The SD side of M28 B and M29, card files in a dict """
+
+    def __init__(self):
+        self.files = {}
+        self.out = []
+        self.now = 0
+        self.line = bytearray()
+        self.size = 0
+        self.upload_port = False
+        self.temp = None
+
+    # SDCard::startBinaryWrite()
+    def start(self, name, size):
+        if not size:
+            self.out.append("open failed, File: " + name)
+            return
+        self.temp = bytearray()
+        self.name, self.size = name, size
+        self.done = self.index = self.retry = 0
+        self.discard = False
+        self.buffer = bytearray(UPLOAD_FRAME_SIZE + 2)
+        self.upload_port = True
+        self.timer = self.now
+        self.out.append("Writing to file: " + name)
+
+    # SDCard::upload_byte()
+    def upload_byte(self, c):
+        self.timer = self.now
+        if self.discard:
+            return
+        length = min(self.size - self.done, UPLOAD_FRAME_SIZE)
+        self.buffer[self.index] = c
+        self.index += 1
+        if self.index < length + 2:
+            return
+        self.index = 0
+        if fw_crc16(self.buffer[:length]) != (self.buffer[length] << 8 | self.buffer[length + 1]):
+            self.discard = True
+            return
+        self.temp += self.buffer[:length]
+        self.done += length
+        self.retry = 0
+        if self.done >= self.size:
+            self.upload_port = False
+        self.out.append("ok")
+
+    # SDCard::check_upload()
+    def check_upload(self):
+        partial = self.discard or self.index
+        wait = UPLOAD_QUIET_MS if self.discard else UPLOAD_TIMEOUT_MS if self.index else UPLOAD_IDLE_MS
+        if self.now - self.timer < wait:
+            return
+        self.retry += 1 if partial else 0
+        if not partial or self.retry > UPLOAD_RETRY:
+            self.end(False)
+        else:
+            self.index = 0
+            self.discard = False
+            self.out.append("Resend:%d" % (self.done // UPLOAD_FRAME_SIZE))
+
+    # SDCard::endBinaryWrite()
+    def end(self, saved):
+        if saved:
+            self.files[self.name] = bytes(self.temp)
+            self.out.append("Done saving file.")
+        else:
+            self.out.append("Error:upload aborted")
+        self.temp = None
+        self.upload_port = False
+        self.size = 0
+
+    def command(self, line):
+        if line.startswith("M28 B"):
+            size, name = line[5:].split(" ", 1)
+            self.start(name.strip(), int(size))
+        elif line == "M29":
+            if self.size:
+                self.end(self.done >= self.size)
+        self.out.append("ok")
+
+    def receive(self, c):
+        if self.upload_port:
+            self.upload_byte(c)
+        elif c == 10:
+            self.command(self.line.decode("ascii"))
+            self.line = bytearray()
+        else:
+            self.line.append(c)
+
+    def tick(self, ms):
+        self.now += ms
+        if self.upload_port:
+            self.check_upload()
+
+
+class Link:
+    """ The serial line, with errors in the frames the host writes """
+
+    def __init__(self, firmware, flip=0.0, drop=0.0, extra=0.0, seed=1):
+        self.fw = firmware
+        self.rnd = random.Random(seed)
+        self.flip, self.drop, self.extra = flip, drop, extra
+
+    def write(self, data):
+        binary = self.fw.upload_port
+        for c in data:
+            if binary and self.rnd.random() < self.drop:
+                continue
+            if binary and self.rnd.random() < self.flip:
+                c ^= 1 << self.rnd.randrange(8)
+            self.fw.receive(c)
+            if binary and self.rnd.random() < self.extra:
+                self.fw.receive(self.rnd.randrange(256))
+
+    def readline(self):
+        for _ in range(6000):
+            if self.fw.out:
+                return self.fw.out.pop(0) + "\n"
+            self.fw.tick(10)
+        return ""
+
+
+def payload(size, seed=2):
+    rnd = random.Random(seed)
+    text = b"".join(b"G1 X%.3f Y%.3f E%.5f\n" % (rnd.uniform(0, 200), rnd.uniform(0, 200), rnd.uniform(0, 9))
+                    for _ in range(size // 20 + 1))
+    return text[:size]
+
+
+class Framing(unittest.TestCase):
+
+    def test_crc(self):
+        # CRC-16/XMODEM check value, the same as the firmware
+        self.assertEqual(sdupload.crc16(b"123456789"), 0x31C3)
+        data = payload(3000)
+        self.assertEqual(sdupload.crc16(data), fw_crc16(data))
+
+    def test_frames(self):
+        data = payload(1300)
+        f = sdupload.frames(data)
+        self.assertEqual([len(x) for x in f], [514, 514, 278])
+        for n, x in enumerate(f):
+            self.assertEqual(x[:-2], data[n * 512:(n + 1) * 512])
+            self.assertEqual(x[-2] << 8 | x[-1], fw_crc16(x[:-2]))
+
+
+class RoundTrip(unittest.TestCase):
+
+    def test_clean(self):
+        for size in (1, 511, 512, 513, 1024, 20000):
+            with self.subTest(size=size):
+                fw = Firmware()
+                data = payload(size)
+                self.assertEqual(sdupload.upload(Link(fw), data, "part.gcode"), 0)
+                self.assertEqual(fw.files["part.gcode"], data)
+
+    def test_bad_frames(self):
+        # Flipped, dropped and added bytes are sent again until the frame is good
+        for flip, drop, extra in ((0.0005, 0, 0), (0, 0.0005, 0), (0, 0, 0.0005), (0.0003, 0.0003, 0.0003)):
+            with self.subTest(flip=flip, drop=drop, extra=extra):
+                fw = Firmware()
+                data = payload(60000)
+                resends = sdupload.upload(Link(fw, flip, drop, extra), data, "part.gcode")
+                self.assertGreater(resends, 0)
+                self.assertEqual(fw.files["part.gcode"], data)
+
+    def test_abort_keeps_old_file(self):
+        # Every frame bad: the firmware gives up and the old file stays
+        fw = Firmware()
+        fw.files["part.gcode"] = b"old"
+        with self.assertRaises(sdupload.UploadError):
+            sdupload.upload(Link(fw, flip=0.05), payload(4000), "part.gcode")
+        self.assertEqual(fw.files["part.gcode"], b"old")
+
+    def test_empty(self):
+        with self.assertRaises(sdupload.UploadError):
+            sdupload.upload(Link(Firmware()), b"", "part.gcode")
+
+
+if __name__ == "__main__":
+    unittest.main()
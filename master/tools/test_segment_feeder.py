@@ -0,0 +1,229 @@
+#!/usr/bin/env python3
+"""
+test_segment_feeder.py - Simulation of KINEMATIC_SEGMENT_FEEDER
+
+  python3 test_segment_feeder.py        run the tests
+  python3 test_segment_feeder.py -b     print the benchmark
+
+The lines sent by SegmentFeeder::feed() are compared with the lines of the
+segmentation loop in Delta_Mechanics::prepare_move_to_destination_mech_specific()
+and SCARA_Mechanics. Both go through a copy of the planner look-ahead: a
+ring of BLOCK_BUFFER_SIZE - 1 blocks, the newest block planned to stop,
+reverse and forward pass on every new block.
+
+The feeder does not change the look-ahead: every line is still a block,
+so the speed is limited by the braking distance of the lines in the
+buffer. The benchmark shows where this binds, compared with a plan of the
+whole Cartesian move.
+"""
+
+import math
+import sys
+import unittest
+
+BLOCK_BUFFER_SIZE = 16
+MINIMUM_PLANNER_SPEED = 0.05
+DEFAULT_ACCELERATION = 3000.0
+KINEMATIC_FEEDER_MOVES = 8
+
+
+def direct_lines(start, target, lines):
+    """ The segmentation loop of the mechanics, without the feeder """
+    step = [(t - s) / lines for s, t in zip(start, target)]
+    raw = list(start)
+    out = []
+    for _ in range(lines - 1):
+        raw = [r + d for r, d in zip(raw, step)]
+        out.append(tuple(raw))
+    out.append(tuple(target))
+    return out
+
+
+class Feeder:
+    """ SegmentFeeder::add() and feed(), the planner takes `free` lines per call """
+
+    def __init__(self):
+        self.buffer = []
+        self.current = None
+        self.sent = []
+
+    def add(self, start, target, lines):
+        assert len(self.buffer) < KINEMATIC_FEEDER_MOVES
+        step = [(t - s) / lines for s, t in zip(start, target)]
+        self.buffer.append({"pos": list(start), "target": target, "step": step, "lines": lines, "done": 0})
+
+    def busy(self):
+        return bool(self.buffer) or (self.current and self.current["done"] < self.current["lines"])
+
+    def feed(self, free):
+        while free:
+            if not self.current or self.current["done"] >= self.current["lines"]:
+                if not self.buffer:
+                    break
+                self.current = self.buffer.pop(0)
+            c = self.current
+            c["done"] += 1
+            c["pos"] = [p + d for p, d in zip(c["pos"], c["step"])]
+            self.sent.append(tuple(c["target"]) if c["done"] >= c["lines"] else tuple(c["pos"]))
+            free -= 1
+
+
+class Planner:
+    """ Look-ahead of Planner::recalculate() on straight lines """
+
+    def __init__(self, acceleration=DEFAULT_ACCELERATION):
+        self.acceleration = acceleration
+        self.blocks = []
+        self.time = 0.0
+        self.peak = 0.0
+
+    def is_full(self):
+        return len(self.blocks) >= BLOCK_BUFFER_SIZE - 1
+
+    def buffer_line(self, mm, feedrate):
+        # Straight moves, the junction limit is the nominal speed
+        max_entry = min(feedrate, self.blocks[-1]["nominal"]) if self.blocks else MINIMUM_PLANNER_SPEED
+        self.blocks.append({"mm": mm, "nominal": feedrate, "max_entry": max_entry, "entry": MINIMUM_PLANNER_SPEED})
+        self.recalculate()
+
+    def recalculate(self):
+        # Reverse pass, the newest block stops at its end
+        exit = MINIMUM_PLANNER_SPEED
+        for b in reversed(self.blocks[1:]):
+            b["entry"] = min(b["max_entry"], math.sqrt(exit * exit + 2.0 * self.acceleration * b["mm"]))
+            exit = b["entry"]
+        # Forward pass, the running block keeps its entry
+        for prev, b in zip(self.blocks, self.blocks[1:]):
+            b["entry"] = min(b["entry"], math.sqrt(prev["entry"] ** 2 + 2.0 * self.acceleration * prev["mm"]))
+
+    def execute(self):
+        """ Run the oldest block as a trapezoid """
+        b = self.blocks.pop(0)
+        v0 = b["entry"]
+        v1 = self.blocks[0]["entry"] if self.blocks else MINIMUM_PLANNER_SPEED
+        self.time += trapezoid_time(b["mm"], v0, v1, b["nominal"], self.acceleration)
+        self.peak = max(self.peak, min(b["nominal"], math.sqrt((2.0 * self.acceleration * b["mm"] + v0 * v0 + v1 * v1) / 2.0)))
+
+
+def trapezoid_time(mm, v0, v1, vmax, a):
+    peak = min(vmax, math.sqrt((2.0 * a * mm + v0 * v0 + v1 * v1) / 2.0))
+    accel_mm = (peak * peak - v0 * v0) / (2.0 * a)
+    decel_mm = (peak * peak - v1 * v1) / (2.0 * a)
+    cruise_mm = max(0.0, mm - accel_mm - decel_mm)
+    return (peak - v0) / a + (peak - v1) / a + cruise_mm / peak
+
+
+def run(moves, feedrate, acceleration=DEFAULT_ACCELERATION, feeder=True):
+    """
+    Print the moves, a list of (start, target, lines). The main loop fills the
+    planner before the stepper takes a block, as when the command queue is
+    ahead. Return the lines, the move time and the peak speed.
+    """
+    planner = Planner(acceleration)
+    sent = []
+    if feeder:
+        f = Feeder()
+        pending = list(moves)
+        while pending or f.busy() or planner.blocks:
+            while pending and len(f.buffer) < KINEMATIC_FEEDER_MOVES:
+                f.add(*pending.pop(0))
+            before = len(f.sent)
+            f.feed(BLOCK_BUFFER_SIZE - 1 - len(planner.blocks))
+            for p in f.sent[before:]:
+                prev = sent[-1] if sent else moves[0][0]
+                planner.buffer_line(math.dist(prev[:3], p[:3]), feedrate)
+                sent.append(p)
+            if planner.blocks:
+                planner.execute()
+    else:
+        queue = [p for m in moves for p in direct_lines(*m)]
+        while queue or planner.blocks:
+            while queue and not planner.is_full():
+                p = queue.pop(0)
+                prev = sent[-1] if sent else moves[0][0]
+                planner.buffer_line(math.dist(prev[:3], p[:3]), feedrate)
+                sent.append(p)
+            planner.execute()
+    return sent, planner.time, planner.peak
+
+
+def whole_move(mm, feedrate, acceleration=DEFAULT_ACCELERATION):
+    """ The same path planned as one Cartesian move """
+    return trapezoid_time(mm, MINIMUM_PLANNER_SPEED, MINIMUM_PLANNER_SPEED, feedrate, acceleration), \
+        min(feedrate, math.sqrt(acceleration * mm))
+
+
+def straight(mm, line_mm, parts=1):
+    """ A straight move along X of mm, split in `parts` G1 commands """
+    out = []
+    step = mm / parts
+    for n in range(parts):
+        start, target = (n * step, 0.0, 0.3, 0.0), ((n + 1) * step, 0.0, 0.3, 0.0)
+        out.append((start, target, max(1, int(round(step / line_mm)))))
+    return out
+
+
+class Feeding(unittest.TestCase):
+
+    def test_same_lines(self):
+        # The feeder sends the same lines as the segmentation loop, last line on target
+        moves = [((0.0, 0.0, 0.3, 0.0), (37.3, -12.1, 0.3, 1.7), 41),
+                 ((37.3, -12.1, 0.3, 1.7), (-5.0, 20.0, 0.5, 3.2), 7),
+                 ((-5.0, 20.0, 0.5, 3.2), (-5.0, 20.2, 0.5, 3.3), 1)]
+        expected = [p for m in moves for p in direct_lines(*m)]
+        for free in (1, 3, BLOCK_BUFFER_SIZE - 1):
+            f = Feeder()
+            for m in moves:
+                f.add(*m)
+            while f.busy():
+                f.feed(free)
+            self.assertEqual(f.sent, expected)
+        self.assertEqual(expected[-1], moves[-1][1])
+
+    def test_same_profile(self):
+        # With the command queue ahead the planner sees the same blocks
+        moves = straight(200.0, 0.5, parts=10)
+        lines_a, time_a, peak_a = run(moves, 150.0, feeder=True)
+        lines_b, time_b, peak_b = run(moves, 150.0, feeder=False)
+        self.assertEqual(lines_a, lines_b)
+        self.assertAlmostEqual(time_a, time_b, places=9)
+        self.assertAlmostEqual(peak_a, peak_b, places=9)
+
+
+class LookAhead(unittest.TestCase):
+
+    def test_time_segmentation_reaches_feedrate(self):
+        # SCARA_SEGMENTS_PER_SECOND 100: lines of F/100 mm, the buffer holds
+        # 0.15 s of the move and braking from F needs F/2a, so the look-ahead
+        # binds only over 30 * a / 100 mm/s
+        for feedrate in (50.0, 150.0, 300.0):
+            _, _, peak = run(straight(200.0, feedrate / 100.0), feedrate)
+            self.assertAlmostEqual(peak, feedrate, places=6)
+
+    def test_short_lines_limit_speed(self):
+        # Lines of 0.2 mm (tolerance segmentation near a tower, low acceleration):
+        # every line is a block and the speed stays under the feedrate
+        feedrate, acceleration = 150.0, 1000.0
+        _, time, peak = run(straight(100.0, 0.2), feedrate, acceleration)
+        whole_time, whole_peak = whole_move(100.0, feedrate, acceleration)
+        self.assertAlmostEqual(whole_peak, feedrate)
+        self.assertLess(peak, feedrate * 0.6)
+        self.assertGreater(time, whole_time * 1.3)
+
+
+def report():
+    print("Straight move of 100 mm, %d blocks, newest block stops, peak speed and time" % (BLOCK_BUFFER_SIZE - 1))
+    print("%8s %8s %8s %10s %10s %10s %10s" % ("accel", "F mm/s", "line mm", "peak", "time s", "whole pk", "whole s"))
+    for acceleration in (1000.0, 3000.0):
+        for feedrate in (60.0, 150.0, 300.0):
+            for line_mm in (0.1, 0.2, 0.5, 1.0, 2.0):
+                _, time, peak = run(straight(100.0, line_mm), feedrate, acceleration)
+                whole_time, whole_peak = whole_move(100.0, feedrate, acceleration)
+                print("%8.0f %8.0f %8.1f %10.1f %10.3f %10.1f %10.3f" % (acceleration, feedrate, line_mm, peak, time, whole_peak, whole_time))
+
+
+if __name__ == "__main__":
+    if "-b" in sys.argv:
+        report()
+    else:
+        unittest.main()
@@ -0,0 +1,194 @@
+#!/usr/bin/env python3
+"""
+test_thermal_model.py - Simulation of the thermal runaway detectors
+
+  python3 test_thermal_model.py
+
+A hotend plant (first order, sensor lag, noise) is driven by a PI loop
+every 100ms and watched by copies of the firmware detectors:
+
+  classic   Heater::thermal_runaway_protection() (hysteresis and period)
+  model     Heater::thermal_model_protection() (THERMAL_MODEL_PROTECTION)
+
+The identified model is deliberately a few percent off the plant, as an
+M303 identification would be; test_identification_tolerance shows how far
+off it can be before the heat-up itself trips the detector.
+"""
+
+import random
+import unittest
+
+DT = 0.1                            # tempManager.spin period (s)
+
+# Configuration_Temperature.h
+THERMAL_PROTECTION_PERIOD = 40
+THERMAL_PROTECTION_HYSTERESIS = 4
+THERMAL_MODEL_RESIDUAL = 15
+THERMAL_MODEL_PERIOD = 10
+THERMAL_MODEL_ADAPT = 120
+THERMAL_MODEL_AMBIENT = 25
+
+AMBIENT = 25.0
+TARGET = 210.0
+
+
+class Plant:
+    """ Hotend: gain 280 C at full power, tau 90 s, fan doubles the loss """
+
+    def __init__(self, seed=1):
+        self.rnd = random.Random(seed)
+        self.temp = self.sensor = AMBIENT
+        self.gain, self.tau, self.fan_loss = 280.0, 90.0, 1.0
+        self.connected = True
+        self.fallout = False
+
+    def step(self, power, fan):
+        power = power if self.connected else 0.0
+        self.temp += (self.gain * power - (self.temp - AMBIENT) * (1.0 + self.fan_loss * fan)) * DT / self.tau
+        # A thermistor out of the block reads air a little warmer than ambient
+        probe = AMBIENT + 0.2 * (self.temp - AMBIENT) if self.fallout else self.temp
+        self.sensor += (probe - self.sensor) * DT / 2.0
+        return self.sensor + self.rnd.gauss(0, 0.2)
+
+
+class Model:
+    """ thermal_model_t::predict() """
+
+    def __init__(self, gain, tau, fan_loss):
+        self.gain, self.tau, self.fan_loss = gain, tau, fan_loss
+
+    def predict(self, temp, power, fan, ambient, dt):
+        return temp + (self.gain * power - (temp - ambient) * (1.0 + self.fan_loss * fan)) * dt / self.tau
+
+
+class ClassicDetector:
+    """ Heater::thermal_runaway_protection(), TRFirstHeating to TRStable """
+
+    def __init__(self):
+        self.stable = False
+        self.timer = 0.0
+
+    def check(self, now, temp, power, fan):
+        if not self.stable:
+            if temp < TARGET:
+                return False
+            self.stable = True
+        if temp >= TARGET - THERMAL_PROTECTION_HYSTERESIS:
+            self.timer = now
+            return False
+        return now - self.timer >= THERMAL_PROTECTION_PERIOD
+
+
+class ModelDetector:
+    """ Heater::thermal_model_protection() """
+
+    def __init__(self, model, temp):
+        self.model = model
+        self.model_temp = temp
+        self.ambient = THERMAL_MODEL_AMBIENT
+        self.timer = None
+
+    def check(self, now, temp, power, fan):
+        m = self.model
+        self.model_temp = m.predict(self.model_temp, power, fan, self.ambient, DT)
+        residual = temp - self.model_temp
+        self.ambient += residual * (DT / THERMAL_MODEL_ADAPT)
+        self.ambient = min(max(self.ambient, THERMAL_MODEL_AMBIENT - m.gain * 0.5), THERMAL_MODEL_AMBIENT + m.gain * 0.25)
+        if abs(residual) < THERMAL_MODEL_RESIDUAL:
+            self.timer = None
+        elif self.timer is None:
+            self.timer = now
+        elif now - self.timer >= THERMAL_MODEL_PERIOD:
+            return True
+        return False
+
+
+# Model as identified by M303, about 4 % off the plant
+IDENTIFIED = Model(gain=290.0, tau=87.0, fan_loss=0.9)
+
+
+def simulate(events, duration=600.0, seed=1, identified=IDENTIFIED):
+    """
+    Heat to TARGET and apply the events, a list of (time, event).
+    Return the trip time of both detectors from the last event (None
+    if no trip) and the lowest temperature read after the first event.
+    """
+    plant = Plant(seed)
+    classic = ClassicDetector()
+    model = ModelDetector(identified, AMBIENT)
+    at = events[-1][0] if events else duration
+    trips = {"classic": None, "model": None}
+    kp, ki, integral = 0.08, 0.002, 0.0
+    fan, lowest = 0.0, None
+    temp = AMBIENT
+    steps = int(duration / DT)
+    for i in range(steps):
+        now = i * DT
+        for start, event in events:
+            if now >= start:
+                if event == "fan blast":
+                    fan = 1.0
+                elif event == "heater disconnect":
+                    plant.connected = False
+                elif event == "thermistor fallout":
+                    plant.fallout = True
+                lowest = temp if lowest is None else min(lowest, temp)
+        # PI output as pwm_value, anti windup on the integral
+        error = TARGET - temp
+        output = kp * error + integral
+        if 0.0 < output < 1.0:
+            integral += ki * error * DT
+        power = min(max(output, 0.0), 1.0)
+        power = round(power * 255) / 255.0
+        temp = plant.step(power, fan)
+        for name, det in (("classic", classic), ("model", model)):
+            if trips[name] is None and det.check(now, temp, power, fan):
+                trips[name] = now - at
+    return trips, lowest
+
+
+class Scenarios(unittest.TestCase):
+
+    def test_normal_print(self):
+        for seed in range(5):
+            trips, _ = simulate([], seed=seed)
+            self.assertIsNone(trips["classic"])
+            self.assertIsNone(trips["model"])
+
+    def test_identification_tolerance(self):
+        # Gain and time constant up to 5 % off heat and hold without a trip
+        for gain in (0.95, 1.0, 1.05):
+            for tau in (0.95, 1.0, 1.05):
+                with self.subTest(gain=gain, tau=tau):
+                    model = Model(280.0 * gain, 90.0 * tau, 0.9)
+                    trips, _ = simulate([], identified=model)
+                    self.assertIsNone(trips["model"])
+
+    def test_fan_blast(self):
+        # Full power can not hold the target, the classic check trips
+        # on a working heater, the model expects the drop
+        trips, lowest = simulate([(300.0, "fan blast")])
+        self.assertLess(lowest, TARGET - THERMAL_PROTECTION_HYSTERESIS)
+        self.assertIsNotNone(trips["classic"])
+        self.assertIsNone(trips["model"])
+
+    def test_heater_disconnect(self):
+        trips, _ = simulate([(300.0, "heater disconnect")])
+        self.assertIsNotNone(trips["model"])
+        self.assertLess(trips["model"], trips["classic"])
+        self.assertLess(trips["model"], THERMAL_MODEL_PERIOD + 20)
+
+    def test_heater_disconnect_with_fan(self):
+        # The disconnect is still found when the fan is on
+        trips, _ = simulate([(300.0, "fan blast"), (400.0, "heater disconnect")], duration=700.0)
+        self.assertIsNotNone(trips["model"])
+
+    def test_thermistor_fallout(self):
+        trips, _ = simulate([(300.0, "thermistor fallout")])
+        self.assertIsNotNone(trips["model"])
+        self.assertLess(trips["model"], trips["classic"])
+        self.assertLess(trips["model"], THERMAL_MODEL_PERIOD + 10)
+
+
+if __name__ == "__main__":
+    unittest.main()